@@ -0,0 +1,156 @@
+#include "ChunkedTileStorage.h"
+#include <algorithm>
+
+namespace {
+    constexpr size_t kChunkTileCount =
+        static_cast<size_t>(ChunkedTileStorage::kChunkSize) * ChunkedTileStorage::kChunkSize;
+
+    [[nodiscard]] int CeilShift(int value, int shift) noexcept {
+        return (value + (1 << shift) - 1) >> shift;
+    }
+}
+
+ChunkedTileStorage::ChunkedTileStorage(int width, int height, TileType fill)
+    : m_regionsX(CeilShift(std::max(width, 0), kRegionTileShift))
+    , m_regionsY(CeilShift(std::max(height, 0), kRegionTileShift))
+    , m_fill(fill)
+{
+    m_regions.resize(static_cast<size_t>(m_regionsX) * static_cast<size_t>(m_regionsY));
+}
+
+ChunkedTileStorage::ChunkedTileStorage(const ChunkedTileStorage& other)
+{
+    *this = other;
+}
+
+ChunkedTileStorage& ChunkedTileStorage::operator=(const ChunkedTileStorage& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    m_regionsX = other.m_regionsX;
+    m_regionsY = other.m_regionsY;
+    m_fill = other.m_fill;
+    m_allocatedChunks = other.m_allocatedChunks;
+    m_regions.clear();
+    m_regions.resize(other.m_regions.size());
+
+    for (size_t r = 0; r < other.m_regions.size(); ++r) {
+        const Region* source = other.m_regions[r].get();
+        if (!source) continue;
+
+        auto region = std::make_unique<Region>();
+        for (size_t c = 0; c < std::size(source->chunks); ++c) {
+            const Chunk& chunk = source->chunks[c];
+            region->chunks[c].uniform = chunk.uniform;
+            if (chunk.tiles) {
+                region->chunks[c].tiles = std::make_unique<TileType[]>(kChunkTileCount);
+                std::copy_n(chunk.tiles.get(), kChunkTileCount, region->chunks[c].tiles.get());
+            }
+        }
+        m_regions[r] = std::move(region);
+    }
+    return *this;
+}
+
+std::unique_ptr<ChunkedTileStorage::Region> ChunkedTileStorage::MakeRegion() const
+{
+    auto region = std::make_unique<Region>();
+    for (Chunk& chunk : region->chunks) {
+        chunk.uniform = m_fill;
+    }
+    return region;
+}
+
+void ChunkedTileStorage::Set(int x, int y, TileType tile)
+{
+    auto& regionSlot = m_regions[RegionIndex(x, y)];
+    if (!regionSlot) {
+        if (tile == m_fill) return;  // Writing the fill value is a no-op
+        regionSlot = MakeRegion();
+    }
+
+    Chunk& chunk = regionSlot->chunks[ChunkIndex(x, y)];
+    if (!chunk.tiles) {
+        if (tile == chunk.uniform) return;
+        chunk.tiles = std::make_unique<TileType[]>(kChunkTileCount);
+        std::fill_n(chunk.tiles.get(), kChunkTileCount, chunk.uniform);
+        ++m_allocatedChunks;
+    }
+    chunk.tiles[TileIndex(x, y)] = tile;
+}
+
+void ChunkedTileStorage::SetChunkUniform(int x, int y, TileType tile)
+{
+    auto& regionSlot = m_regions[RegionIndex(x, y)];
+    if (!regionSlot) {
+        if (tile == m_fill) return;
+        regionSlot = MakeRegion();
+    }
+
+    Chunk& chunk = regionSlot->chunks[ChunkIndex(x, y)];
+    if (chunk.tiles) {
+        chunk.tiles.reset();
+        --m_allocatedChunks;
+    }
+    chunk.uniform = tile;
+}
+
+size_t ChunkedTileStorage::Compact()
+{
+    size_t freed = 0;
+
+    for (auto& regionSlot : m_regions) {
+        if (!regionSlot) continue;
+
+        bool allFill = true;
+        for (Chunk& chunk : regionSlot->chunks) {
+            if (chunk.tiles) {
+                const TileType* begin = chunk.tiles.get();
+                const TileType* end = begin + kChunkTileCount;
+                const TileType first = *begin;
+                if (std::find_if(begin, end,
+                        [first](TileType t) { return t != first; }) == end) {
+                    chunk.tiles.reset();
+                    chunk.uniform = first;
+                    ++freed;
+                }
+            }
+            allFill = allFill && !chunk.tiles && chunk.uniform == m_fill;
+        }
+
+        if (allFill) {
+            regionSlot.reset();
+        }
+    }
+
+    m_allocatedChunks -= freed;
+    return freed;
+}
+
+bool ChunkedTileStorage::IsChunkUniform(int x, int y, TileType& outTile) const noexcept
+{
+    const Region* region = m_regions[RegionIndex(x, y)].get();
+    if (!region) {
+        outTile = m_fill;
+        return true;
+    }
+    const Chunk& chunk = region->chunks[ChunkIndex(x, y)];
+    if (chunk.tiles) {
+        return false;
+    }
+    outTile = chunk.uniform;
+    return true;
+}
+
+size_t ChunkedTileStorage::GetMemoryBytes() const noexcept
+{
+    size_t regionCount = 0;
+    for (const auto& region : m_regions) {
+        if (region) ++regionCount;
+    }
+    return m_regions.size() * sizeof(std::unique_ptr<Region>) +
+           regionCount * sizeof(Region) +
+           m_allocatedChunks * kChunkTileCount * sizeof(TileType);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "TileType.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Sparse tile storage for very large maps
+//
+// Tiles live in 64x64 chunks that are allocated on first write; a chunk whose
+// tiles are all equal is stored as a single value. Chunks are grouped into
+// regions of 64x64 chunks (4096x4096 tiles) that are themselves allocated on
+// demand, so a lookup is two indexed loads with no hashing, and memory scales
+// with the written area instead of the bounding box.
+class ChunkedTileStorage {
+public:
+    static constexpr int kChunkShift = 6;
+    static constexpr int kChunkSize = 1 << kChunkShift;                  // 64 tiles
+    static constexpr int kRegionShift = 6;
+    static constexpr int kRegionChunks = 1 << kRegionShift;              // 64 chunks
+    static constexpr int kRegionTileShift = kChunkShift + kRegionShift;  // 4096 tiles
+
+    ChunkedTileStorage() = default;
+    ChunkedTileStorage(int width, int height, TileType fill);
+    ~ChunkedTileStorage() = default;
+
+    // Deep copy
+    ChunkedTileStorage(const ChunkedTileStorage& other);
+    ChunkedTileStorage& operator=(const ChunkedTileStorage& other);
+
+    ChunkedTileStorage(ChunkedTileStorage&&) noexcept = default;
+    ChunkedTileStorage& operator=(ChunkedTileStorage&&) noexcept = default;
+
+    // Tile access (caller guarantees 0 <= x < width, 0 <= y < height)
+    [[nodiscard]] TileType Get(int x, int y) const noexcept {
+        const Region* region = m_regions[RegionIndex(x, y)].get();
+        if (!region) {
+            return m_fill;
+        }
+        const Chunk& chunk = region->chunks[ChunkIndex(x, y)];
+        return chunk.tiles ? chunk.tiles[TileIndex(x, y)] : chunk.uniform;
+    }
+
+    void Set(int x, int y, TileType tile);
+
+    // Make every tile of the chunk containing (x, y) equal to `tile` without
+    // allocating a tile buffer for it
+    void SetChunkUniform(int x, int y, TileType tile);
+
+    // Collapse chunks whose tiles became uniform and release regions that hold
+    // nothing but the fill value. Returns the number of chunk buffers freed.
+    size_t Compact();
+
+    // Uniform value of the chunk containing (x, y), if the chunk is uniform
+    [[nodiscard]] bool IsChunkUniform(int x, int y, TileType& outTile) const noexcept;
+
+    // Statistics
+    [[nodiscard]] size_t GetAllocatedChunkCount() const noexcept { return m_allocatedChunks; }
+    [[nodiscard]] size_t GetMemoryBytes() const noexcept;
+    [[nodiscard]] TileType GetFill() const noexcept { return m_fill; }
+
+private:
+    struct Chunk {
+        std::unique_ptr<TileType[]> tiles;   // Null when uniform
+        TileType uniform{TileType::Empty};
+    };
+
+    struct Region {
+        Chunk chunks[kRegionChunks * kRegionChunks];
+    };
+
+    [[nodiscard]] size_t RegionIndex(int x, int y) const noexcept {
+        return static_cast<size_t>(y >> kRegionTileShift) * static_cast<size_t>(m_regionsX) +
+               static_cast<size_t>(x >> kRegionTileShift);
+    }
+
+    [[nodiscard]] static size_t ChunkIndex(int x, int y) noexcept {
+        constexpr int mask = kRegionChunks - 1;
+        return static_cast<size_t>((((y >> kChunkShift) & mask) << kRegionShift) |
+                                   ((x >> kChunkShift) & mask));
+    }
+
+    [[nodiscard]] static size_t TileIndex(int x, int y) noexcept {
+        constexpr int mask = kChunkSize - 1;
+        return static_cast<size_t>(((y & mask) << kChunkShift) | (x & mask));
+    }
+
+    [[nodiscard]] std::unique_ptr<Region> MakeRegion() const;
+
+    int m_regionsX{};
+    int m_regionsY{};
+    TileType m_fill{TileType::Wall};
+    size_t m_allocatedChunks{};
+    std::vector<std::unique_ptr<Region>> m_regions;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+// Stateless random numbers keyed by (seed, x, y, stage)
+//
+// Each value is a SplitMix64-style hash of its key, so any tile's draw can be
+// computed on its own, in any order, on any thread, with identical results.
+// `stage` separates independent decisions about the same tile (initial fill,
+// water pool placement, ...). Branch-free, so loops over x vectorize.
+namespace CounterRng {
+
+    // SplitMix64 finalizer: a bijective 64-bit mix with full avalanche
+    [[nodiscard]] constexpr uint64_t Mix(uint64_t z) noexcept {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Per-(seed, stage) key; hoist it out of per-tile loops
+    [[nodiscard]] constexpr uint64_t StreamKey(uint32_t seed, uint32_t stage) noexcept {
+        return Mix((static_cast<uint64_t>(seed) << 32 | stage) + 0x9E3779B97F4A7C15ull);
+    }
+
+    // 64 random bits for tile (x, y) of a stream
+    [[nodiscard]] constexpr uint64_t Hash(uint64_t streamKey, int x, int y) noexcept {
+        const uint64_t position = static_cast<uint64_t>(static_cast<uint32_t>(x)) |
+                                  static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32;
+        return Mix(streamKey ^ Mix(position));
+    }
+
+    // Uniform float in [0, 1) from the top 24 bits (every value exact)
+    [[nodiscard]] constexpr float ToUnitFloat(uint64_t bits) noexcept {
+        return static_cast<float>(bits >> 40) * (1.0f / 16777216.0f);
+    }
+
+    // Uniform integer in [low, high] (tiny ranges; modulo bias is negligible)
+    [[nodiscard]] constexpr int ToRange(uint64_t bits, int low, int high) noexcept {
+        return low + static_cast<int>((bits & 0xFFFFFFFFu) % static_cast<uint64_t>(high - low + 1));
+    }
+
+} // namespace CounterRng
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Simple INI file reader shared by the game and the tools
+//
+// [section] headers, key=value pairs, ';' and '#' comments (whole lines or
+// after a value). Keys before the first header are in section "".
+class IniFile {
+public:
+    // 8-bit color channels, each clamped to 0-255
+    struct Rgba {
+        uint8_t r, g, b, a;
+    };
+
+    // Load INI file
+    [[nodiscard]] bool Load(std::string_view filename);
+
+    // Get value from section
+    [[nodiscard]] std::optional<std::string> GetString(
+        std::string_view section, std::string_view key) const;
+
+    [[nodiscard]] std::optional<int> GetInt(
+        std::string_view section, std::string_view key) const;
+
+    [[nodiscard]] std::optional<float> GetFloat(
+        std::string_view section, std::string_view key) const;
+
+    // true/1/yes or false/0/no, case-insensitive
+    [[nodiscard]] std::optional<bool> GetBool(
+        std::string_view section, std::string_view key) const;
+
+    // "r,g,b" or "r,g,b,a" (alpha defaults to 255)
+    [[nodiscard]] std::optional<Rgba> GetRgba(
+        std::string_view section, std::string_view key) const;
+
+    // Get with default value
+    [[nodiscard]] std::string GetString(
+        std::string_view section, std::string_view key, std::string_view defaultValue) const;
+
+    [[nodiscard]] int GetInt(
+        std::string_view section, std::string_view key, int defaultValue) const;
+
+    [[nodiscard]] float GetFloat(
+        std::string_view section, std::string_view key, float defaultValue) const;
+
+    [[nodiscard]] bool GetBool(
+        std::string_view section, std::string_view key, bool defaultValue) const;
+
+    // Check if a key exists in a section
+    [[nodiscard]] bool HasKey(std::string_view section, std::string_view key) const;
+
+    // Check if a section exists
+    [[nodiscard]] bool HasSection(std::string_view section) const;
+
+private:
+    // section -> (key -> value)
+    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> m_data;
+};
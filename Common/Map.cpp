@@ -1,94 +1,525 @@
 #include "Map.h"
+#include "MapFileFormat.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
-#include <sstream>
+#include <utility>
 
-void Map::Init(std::string name, int width, int height, std::vector<TileType> data)
+Map::Map(Map&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+Map& Map::operator=(Map&& other) noexcept
+{
+    if (this != &other) {
+        m_name = std::move(other.m_name);
+        m_width = std::exchange(other.m_width, 0);
+        m_height = std::exchange(other.m_height, 0);
+        m_data = std::move(other.m_data);
+        m_mapping = std::move(other.m_mapping);
+        m_chunks = std::move(other.m_chunks);
+        m_walkable = std::move(other.m_walkable);
+        m_walkWordsPerRow = std::exchange(other.m_walkWordsPerRow, 0);
+        m_layout = std::exchange(other.m_layout, MapLayout::RowMajor);
+        m_border = std::exchange(other.m_border, 0);
+        m_blocksX = std::exchange(other.m_blocksX, 0);
+        m_stride = std::exchange(other.m_stride, 0);
+        m_origin = std::exchange(other.m_origin, 0);
+        m_regions = std::move(other.m_regions);
+        other.m_regions.Clear();
+        // Moving the vector/mapping keeps the buffer address, so the pointer stays valid
+        m_tiles = std::exchange(other.m_tiles, nullptr);
+        other.m_data.clear();
+        m_journal.Reset(m_width, m_height);
+    }
+    return *this;
+}
+
+Map::Map(const Map& other)
+{
+    *this = other;
+}
+
+Map& Map::operator=(const Map& other)
+{
+    if (this != &other) {
+        m_name = other.m_name;
+        m_width = other.m_width;
+        m_height = other.m_height;
+        if (other.m_mapping) {
+            m_data.assign(other.m_tiles, other.m_tiles + other.TileCount());
+        } else {
+            m_data = other.m_data;
+        }
+        UseOwnedStorage();
+        (void)SetFlatGeometry(other.m_layout, other.m_border);
+        if (other.m_chunks) {
+            m_chunks = std::make_unique<ChunkedTileStorage>(*other.m_chunks);
+        }
+        m_walkable = other.m_walkable;
+        m_walkWordsPerRow = other.m_walkWordsPerRow;
+        m_regions = other.m_regions;
+        m_journal.Reset(m_width, m_height);
+    }
+    return *this;
+}
+
+void Map::Init(std::string name, int width, int height, std::vector<TileType> data,
+               MapLayout layout, int border)
 {
     m_name = std::move(name);
     m_width = width;
     m_height = height;
     m_data = std::move(data);
+    UseOwnedStorage();
+
+    if ((layout != MapLayout::RowMajor || border > 0) && !m_data.empty()) {
+        // Scatter the row-major input into the new storage; border and block
+        // padding stay Empty
+        std::vector<TileType> stored(SetFlatGeometry(layout, std::max(border, 0)), TileType::Empty);
+        for (int y = 0; y < height; ++y) {
+            const TileType* row = m_data.data() + static_cast<size_t>(y) * static_cast<size_t>(width);
+            for (int x = 0; x < width; ++x) {
+                stored[Index(x, y)] = row[x];
+            }
+        }
+        m_data = std::move(stored);
+        m_tiles = m_data.data();
+    }
+
+    RebuildWalkability();
+    m_journal.Reset(m_width, m_height);
 }
 
-bool Map::LoadFromFile(std::string_view filename)
+void Map::InitChunked(std::string name, int width, int height, TileType fill)
 {
-    const std::string filepath(filename);
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    InitChunked(std::move(name), width, height, std::make_unique<ChunkedTileStorage>(width, height, fill));
+}
+
+void Map::InitChunked(std::string name, int width, int height, std::unique_ptr<ChunkedTileStorage> chunks)
+{
+    m_name = std::move(name);
+    m_width = width;
+    m_height = height;
+    m_data.clear();
+    m_data.shrink_to_fit();
+    UseOwnedStorage();
+    m_chunks = std::move(chunks);
+    RebuildWalkability();
+    m_journal.Reset(m_width, m_height);
+}
+
+void Map::UseOwnedStorage() noexcept
+{
+    m_mapping.reset();
+    m_chunks.reset();
+    (void)SetFlatGeometry(MapLayout::RowMajor, 0);
+    m_tiles = m_data.empty() ? nullptr : m_data.data();
+}
+
+size_t Map::SetFlatGeometry(MapLayout layout, int border) noexcept
+{
+    m_layout = layout;
+    m_border = border;
+    const size_t storedWidth = static_cast<size_t>(std::max(m_width, 0) + 2 * border);
+    const size_t storedHeight = static_cast<size_t>(std::max(m_height, 0) + 2 * border);
+
+    if (layout == MapLayout::Tiled8x8) {
+        m_blocksX = static_cast<int>((storedWidth + 7) >> 3);
+        m_stride = 0;
+        m_origin = 0;
+        return static_cast<size_t>(m_blocksX) * ((storedHeight + 7) >> 3) * 64;
+    }
+    m_blocksX = 0;
+    m_stride = storedWidth;
+    m_origin = static_cast<size_t>(border) * storedWidth + static_cast<size_t>(border);
+    return storedWidth * storedHeight;
+}
+
+const TileType* Map::GetRow(int y, std::vector<TileType>& scratch) const
+{
+    if (m_tiles && m_layout == MapLayout::RowMajor) {
+        return m_tiles + Index(0, y);
+    }
+    scratch.resize(static_cast<size_t>(m_width));
+    for (int x = 0; x < m_width; ++x) {
+        scratch[static_cast<size_t>(x)] = GetTileUnchecked(x, y);
+    }
+    return scratch.data();
+}
+
+void Map::EnableRegionIndex()
+{
+    m_regions.Build(*this);
+}
+
+void Map::RebuildWalkability()
+{
+    m_walkWordsPerRow = (std::max(m_width, 0) + 63) / 64;
+    m_walkable.clear();
+
+    // Chunked maps answer from the tiles; a dense plane would defeat sparse storage
+    if (m_chunks || !m_tiles) {
+        m_walkable.shrink_to_fit();
+        if (m_regions.IsBuilt()) {
+            m_regions.Build(*this);
+        }
+        return;
+    }
+
+    // Sentinel words and rows stay 0 (not walkable)
+    m_walkable.resize(WalkStride() * (static_cast<size_t>(m_height) + 2), 0);
+    std::vector<TileType> scratch;
+    for (int y = 0; y < m_height; ++y) {
+        const TileType* row = GetRow(y, scratch);
+        uint64_t* words = m_walkable.data() + WalkWordIndex(0, y);
+        for (int x = 0; x < m_width; ++x) {
+            words[x >> 6] |= static_cast<uint64_t>(IsWalkableTile(row[x])) << (x & 63);
+        }
+    }
+
+    if (m_regions.IsBuilt()) {
+        m_regions.Build(*this);
+    }
+}
+
+uint64_t Map::GetWalkableWord(int wordX, int y) const noexcept
+{
+    if (!m_walkable.empty()) {
+        return m_walkable[WalkWordIndex(0, y) + static_cast<size_t>(wordX)];
+    }
+
+    uint64_t word = 0;
+    const int baseX = wordX * 64;
+    const int count = std::min(64, m_width - baseX);
+    for (int i = 0; i < count; ++i) {
+        word |= static_cast<uint64_t>(IsWalkableTile(GetTileUnchecked(baseX + i, y))) << i;
+    }
+    return word;
+}
+
+uint64_t Map::GetWalkableRun(int x, int y) const noexcept
+{
+    if (static_cast<unsigned>(y) >= static_cast<unsigned>(m_height) || x >= m_width || x <= -64) {
+        return 0;
+    }
+
+    // Floor division keeps negative x on the word to its left
+    const int wordX = x >> 6;
+    const int shift = x & 63;
+    const uint64_t low = wordX >= 0 ? GetWalkableWord(wordX, y) : 0;
+    if (shift == 0) {
+        return low;
+    }
+    const uint64_t high = wordX + 1 < m_walkWordsPerRow ? GetWalkableWord(wordX + 1, y) : 0;
+    return (low >> shift) | (high << (64 - shift));
+}
+
+size_t Map::Compact()
+{
+    return m_chunks ? m_chunks->Compact() : 0;
+}
+
+size_t Map::GetTileMemoryBytes() const noexcept
+{
+    if (m_chunks) {
+        return m_chunks->GetMemoryBytes();
+    }
+    if (m_mapping) {
+        return TileCount() * sizeof(TileType);
+    }
+    return m_data.size() * sizeof(TileType);
+}
+
+bool Map::LoadFromFile(std::string_view filename, MapLoadError* error)
+{
+    return LoadFromFile(filename, MapLoadOptions{}, error);
+}
+
+bool Map::LoadFromFile(std::string_view filename, const MapLoadOptions& options, MapLoadError* error)
+{
+    MapLoadError localError;
+    MapLoadError& result = error ? *error : localError;
+    result = {};
+
+    const auto start = std::chrono::steady_clock::now();
+    MapLoadTimings localTimings;
+    MapLoadTimings& timings = options.timings ? *options.timings : localTimings;
+    timings = {};
+
+    MappedFile file;
+    if (!file.Open(filename)) {
+        result.code = MapLoadError::Code::OpenFailed;
         return false;
     }
+    const auto opened = std::chrono::steady_clock::now();
+    timings.openMs = std::chrono::duration<double, std::milli>(opened - start).count();
 
-    std::string line;
-    
-    // Read map name
-    if (std::getline(file, line)) {
-        if (auto pos = line.find('='); pos != std::string::npos) {
-            m_name = line.substr(pos + 1);
+    // Binary maps are recognised by their magic bytes and kept mapped;
+    // text maps are parsed straight from the mapped view and then unmapped
+    bool ok = false;
+    if (DmapFormat::HasMagic(file.Data(), file.Size())) {
+        ok = LoadBinary(std::move(file), result);
+        timings.tilesMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - opened).count();
+    } else {
+        ok = LoadText(file, options, result);
+    }
+    timings.totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return ok;
+}
+
+bool Map::SaveToFile(std::string_view filename, MapFileFormat format) const
+{
+    switch (format) {
+        case MapFileFormat::Binary:     return SaveBinary(filename, false);
+        case MapFileFormat::Compressed: return SaveBinary(filename, true);
+        case MapFileFormat::Text:       break;
+    }
+    return SaveText(filename);
+}
+
+bool Map::InitFromRle(std::string name, int width, int height, std::span<const uint8_t> encoded)
+{
+    if (width < 0 || height < 0) {
+        return false;
+    }
+
+    // Count the runs first so a stream that does not match the claimed size
+    // is rejected before anything is allocated for it
+    const std::optional<uint64_t> count = MapRle::CountTiles(encoded);
+    if (!count || *count != static_cast<uint64_t>(width) * static_cast<uint64_t>(height)) {
+        return false;
+    }
+
+    if (*count <= kMaxDecodedTiles) {
+        std::vector<TileType> tiles(static_cast<size_t>(width) * static_cast<size_t>(height));
+        if (!MapRle::Decode(encoded, tiles)) {
+            return false;
         }
+        Init(std::move(name), width, height, std::move(tiles));
+        return true;
     }
 
-    // Read map width
-    if (std::getline(file, line)) {
-        if (auto pos = line.find('='); pos != std::string::npos) {
-            m_width = std::stoi(line.substr(pos + 1));
+    // Too big for flat storage: decode one band of chunks at a time, storing
+    // uniform chunks as a single value so the runs never expand in memory
+    constexpr int kBandRows = ChunkedTileStorage::kChunkSize;
+    if (*count > kMaxDecodedChunkedTiles || static_cast<uint64_t>(width) > kMaxDecodedTiles / kBandRows) {
+        return false;
+    }
+    auto chunks = std::make_unique<ChunkedTileStorage>(width, height, TileType::Wall);
+    MapRle::Decoder decoder(encoded);
+    std::vector<TileType> band(static_cast<size_t>(width) * static_cast<size_t>(kBandRows));
+    for (int top = 0; top < height; top += kBandRows) {
+        const int rows = std::min(kBandRows, height - top);
+        if (!decoder.Read(std::span<TileType>(band).first(static_cast<size_t>(width) * static_cast<size_t>(rows)))) {
+            return false;
         }
+        for (int left = 0; left < width; left += ChunkedTileStorage::kChunkSize) {
+            const int columns = std::min(ChunkedTileStorage::kChunkSize, width - left);
+            const auto row = [&](int dy) { return band.data() + static_cast<size_t>(dy) * static_cast<size_t>(width) + static_cast<size_t>(left); };
+            const TileType first = *row(0);
+            bool uniform = true;
+            for (int dy = 0; dy < rows && uniform; ++dy) {
+                uniform = std::all_of(row(dy), row(dy) + columns, [first](TileType t) { return t == first; });
+            }
+            if (uniform) {
+                chunks->SetChunkUniform(left, top, first);
+                continue;
+            }
+            for (int dy = 0; dy < rows; ++dy) {
+                for (int dx = 0; dx < columns; ++dx) {
+                    chunks->Set(left + dx, top + dy, row(dy)[dx]);
+                }
+            }
+        }
+    }
+    if (!decoder.AtEnd()) {
+        return false;
+    }
+    InitChunked(std::move(name), width, height, std::move(chunks));
+    return true;
+}
+
+std::vector<uint8_t> Map::EncodeRle() const
+{
+    std::vector<uint8_t> bytes;
+    MapRle::Encoder encoder(bytes);
+    EncodeRows(encoder, 0, m_height);
+    encoder.Finish();
+    return bytes;
+}
+
+void Map::EncodeRows(MapRle::Encoder& encoder, int firstRow, int rowCount) const
+{
+    const int endRow = std::min(firstRow + rowCount, m_height);
+    if (firstRow >= endRow) {
+        return;
+    }
+    if (m_tiles && m_layout == MapLayout::RowMajor && m_border == 0) {
+        const size_t begin = Index(0, firstRow);
+        encoder.Append({m_tiles + begin, Index(0, endRow) - begin});
+        return;
+    }
+    std::vector<TileType> scratch;
+    for (int y = firstRow; y < endRow; ++y) {
+        encoder.Append({GetRow(y, scratch), static_cast<size_t>(m_width)});
+    }
+}
+
+bool Map::LoadBinary(MappedFile file, MapLoadError& error)
+{
+    error.code = MapLoadError::Code::InvalidBinary;
+
+    DmapFormat::Header header{};
+    if (file.Size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, file.Data(), sizeof(header));
+
+    const bool compressed = header.tileFormat == DmapFormat::kTileFormatRle;
+    if (header.version != DmapFormat::kVersion ||
+        (header.tileFormat != DmapFormat::kTileFormat && !compressed)) {
+        return false;
     }
+    if (header.width < 0 || header.height < 0) {
+        return false;
+    }
+
+    const uint64_t tileCount = static_cast<uint64_t>(header.width) * static_cast<uint64_t>(header.height);
+    if ((!compressed && header.dataSize != tileCount) ||
+        header.dataOffset < sizeof(header) ||
+        header.dataOffset > file.Size() ||
+        header.dataSize > file.Size() - header.dataOffset) {
+        return false;
+    }
+
+    const char* nameBegin = header.name;
+    const char* nameEnd = std::find(nameBegin, nameBegin + DmapFormat::kMaxNameLength, '\0');
 
-    // Read map height
-    if (std::getline(file, line)) {
-        if (auto pos = line.find('='); pos != std::string::npos) {
-            m_height = std::stoi(line.substr(pos + 1));
+    // Compressed tiles are decoded into owned storage; the mapping is released on return
+    if (compressed) {
+        const std::span<const uint8_t> encoded(file.Data() + header.dataOffset,
+                                               static_cast<size_t>(header.dataSize));
+        if (!InitFromRle(std::string(nameBegin, nameEnd), header.width, header.height, encoded)) {
+            return false;
         }
+        error.code = MapLoadError::Code::None;
+        return true;
     }
 
-    // Skip the "data=" line
-    std::getline(file, line);
+    m_name.assign(nameBegin, nameEnd);
+    m_width = header.width;
+    m_height = header.height;
 
-    // Initialize flat map data
+    // Back the map by the mapped pages directly - no copy into m_data
     m_data.clear();
-    m_data.resize(static_cast<size_t>(m_width * m_height), TileType::Empty);
-
-    // Read map data
-    for (int y = 0; y < m_height && std::getline(file, line); ++y) {
-        std::istringstream iss(line);
-        std::string token;
-        int x = 0;
-        
-        while (std::getline(iss, token, ',') && x < m_width) {
-            m_data[Index(x, y)] = static_cast<TileType>(std::stoi(token));
-            ++x;
+    m_data.shrink_to_fit();
+    m_chunks.reset();
+    (void)SetFlatGeometry(MapLayout::RowMajor, 0);
+    m_mapping = std::make_unique<MappedFile>(std::move(file));
+    m_tiles = tileCount > 0
+        ? reinterpret_cast<TileType*>(m_mapping->Data() + header.dataOffset)
+        : nullptr;
+    RebuildWalkability();
+    m_journal.Reset(m_width, m_height);
+    error.code = MapLoadError::Code::None;
+    return true;
+}
+
+bool Map::SaveBinary(std::string_view filename, bool compressed) const
+{
+    const std::string filepath(filename);
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // Header, zero padding up to the data offset, then the tiles
+    DmapFormat::WriteHeader(file, DmapFormat::MakeHeader(
+        compressed ? DmapFormat::kTileFormatRle : DmapFormat::kTileFormat, m_width, m_height, TileCount(), m_name));
+
+    if (compressed) {
+        // Stream the encoding in bands of rows, then patch the final size into the header
+        constexpr size_t kFlushBytes = size_t{1} << 20;
+        const int bandRows = std::max(1, static_cast<int>(kFlushBytes / std::max<size_t>(1, static_cast<size_t>(m_width))));
+        std::vector<uint8_t> bytes;
+        MapRle::Encoder encoder(bytes);
+        uint64_t written = 0;
+        for (int y = 0; y < m_height; y += bandRows) {
+            EncodeRows(encoder, y, bandRows);
+            if (bytes.size() >= kFlushBytes) {
+                file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                written += bytes.size();
+                bytes.clear();
+            }
+        }
+        encoder.Finish();
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        written += bytes.size();
+
+        DmapFormat::PatchDataSize(file, written);
+    } else if (m_tiles && m_layout == MapLayout::RowMajor && m_border == 0) {
+        file.write(reinterpret_cast<const char*>(m_tiles), static_cast<std::streamsize>(TileCount()));
+    } else if (m_tiles || m_chunks) {
+        std::vector<TileType> scratch;
+        for (int y = 0; y < m_height; ++y) {
+            file.write(reinterpret_cast<const char*>(GetRow(y, scratch)), static_cast<std::streamsize>(m_width));
         }
     }
 
+    return file.good();
+}
+
+bool Map::LoadText(const MappedFile& file, const MapLoadOptions& options, MapLoadError& error)
+{
+    MapTextFormat::ParsedMap parsed;
+    const std::string_view text(reinterpret_cast<const char*>(file.Data()), file.Size());
+    if (!MapTextFormat::Parse(text, parsed, error, options.threadCount, options.timings)) {
+        return false;
+    }
+
+    m_name = std::move(parsed.name);
+    m_width = parsed.width;
+    m_height = parsed.height;
+    m_data = std::move(parsed.tiles);
+    UseOwnedStorage();
+    RebuildWalkability();
+    m_journal.Reset(m_width, m_height);
     return true;
 }
 
-bool Map::SaveToFile(std::string_view filename) const
+bool Map::SaveText(std::string_view filename) const
 {
     const std::string filepath(filename);
-    std::ofstream file(filepath);
+    std::ofstream file(filepath, std::ios::binary);
     if (!file.is_open()) {
         return false;
     }
 
-    // Write header
-    file << "name=" << m_name << '\n';
-    file << "width=" << m_width << '\n';
-    file << "height=" << m_height << '\n';
-    file << "data=\n";
+    const std::string header = MapTextFormat::FormatHeader(m_name, m_width, m_height);
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // Rows are formatted into one large buffer that is flushed when nearly full
+    constexpr size_t kBufferBytes = size_t{1} << 20;
+    const size_t rowBytes = MapTextFormat::MaxRowBytes(m_width);
+    std::vector<char> buffer(std::max(kBufferBytes, rowBytes));
+    char* const begin = buffer.data();
+    char* const limit = begin + buffer.size() - rowBytes;
+    char* out = begin;
 
-    // Write map data
+    std::vector<TileType> scratch;
     for (int y = 0; y < m_height; ++y) {
-        for (int x = 0; x < m_width; ++x) {
-            file << static_cast<int>(m_data[Index(x, y)]);
-            if (x < m_width - 1) {
-                file << ',';
-            }
+        out = MapTextFormat::FormatRow(GetRow(y, scratch), m_width, out);
+        if (out > limit) {
+            file.write(begin, out - begin);
+            out = begin;
         }
-        file << '\n';
     }
+    file.write(begin, out - begin);
 
-    return true;
+    return file.good();
 }
 
 TileType Map::GetTile(int x, int y) const noexcept
@@ -96,12 +527,34 @@ TileType Map::GetTile(int x, int y) const noexcept
     if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
         return TileType::Empty;
     }
-    return m_data[Index(x, y)];
+    return GetTileUnchecked(x, y);
 }
 
-void Map::SetTile(int x, int y, TileType tileType) noexcept
+void Map::SetTile(int x, int y, TileType tileType)
 {
-    if (x >= 0 && x < m_width && y >= 0 && y < m_height) {
-        m_data[Index(x, y)] = tileType;
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) {
+        return;
+    }
+    const TileType previous = GetTileUnchecked(x, y);
+    if (previous == tileType) {
+        return;  // Nothing changed, nothing to journal
+    }
+    m_journal.Record(x, y);
+
+    if (m_chunks) {
+        m_chunks->Set(x, y, tileType);
+    } else {
+        m_tiles[Index(x, y)] = tileType;
+        const uint64_t bit = uint64_t{1} << (x & 63);
+        uint64_t& word = m_walkable[WalkWordIndex(x, y)];
+        word = IsWalkableTile(tileType) ? (word | bit) : (word & ~bit);
+    }
+
+    if (m_regions.IsBuilt() && IsWalkableTile(previous) != IsWalkableTile(tileType)) {
+        if (IsWalkableTile(tileType)) {
+            m_regions.OnBecameWalkable(*this, x, y);
+        } else {
+            m_regions.OnBecameUnwalkable(*this, x, y);
+        }
     }
 }
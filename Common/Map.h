@@ -1,62 +1,429 @@
 #pragma once
 
 #include "TileType.h"
+#include "TileProperties.h"
+#include "MappedFile.h"
+#include "ChunkedTileStorage.h"
+#include "MapTextFormat.h"
+#include "MapRle.h"
+#include "MapChangeJournal.h"
+#include "MapRegionIndex.h"
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <string_view>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// On-disk map formats
+enum class MapFileFormat : uint8_t {
+    Text,       // Comma-separated tiles (import/export, human-editable)
+    Binary,     // .dmap: fixed header + raw tile bytes, memory-mappable
+    Compressed  // .dmap with run-length encoded tiles (smallest, decoded on load)
+};
+
+// In-memory order of flat tile storage
+enum class MapLayout : uint8_t {
+    RowMajor,   // y * width + x; rows are contiguous (file formats use this order)
+    Tiled8x8    // 8x8 blocks of 64 bytes in row-major block order, each block
+                // row-major inside; vertical neighbours usually share a cache line
+};
+
+// Rectangular block of tiles visited by Map::ForEachBlock
+struct MapBlock {
+    int x, y;
+    int width, height;
+    bool uniform;       // Every tile in the block equals `tile`
+    TileType tile;
+};
 
 // Map class - represents a 2D tile map
+// Tiles are stored either flat (one contiguous array, optionally memory-mapped)
+// or chunked (sparse 64x64 chunks for very large, mostly uniform worlds).
 class Map {
 public:
     Map() = default;
     ~Map() = default;
-    
+
     // Move semantics
-    Map(Map&&) = default;
-    Map& operator=(Map&&) = default;
-    
-    // Copy semantics
-    Map(const Map&) = default;
-    Map& operator=(const Map&) = default;
+    Map(Map&& other) noexcept;
+    Map& operator=(Map&& other) noexcept;
+
+    // Copy semantics (a copy of a memory-mapped map owns its tiles)
+    // Change subscriptions stay with their map object: assigning into a map
+    // keeps its subscribers and journals a full reset; copies start with none.
+    Map(const Map& other);
+    Map& operator=(const Map& other);
 
     // Initialize with data (for procedural generation)
-    void Init(std::string name, int width, int height, std::vector<TileType> data);
-    
-    // Load map from file
-    [[nodiscard]] bool LoadFromFile(std::string_view filename);
-    
+    // `data` is always row-major; with MapLayout::Tiled8x8 it is reordered into
+    // 8x8 blocks (padded to whole blocks). GetTile/SetTile behave the same either way.
+    // A non-zero `border` surrounds the tiles with that many rings of Empty
+    // sentinels so GetNeighborUnchecked can read past the edge without checks.
+    void Init(std::string name, int width, int height, std::vector<TileType> data,
+              MapLayout layout = MapLayout::RowMajor, int border = 0);
+
+    // Initialize sparse chunked storage: every tile starts as `fill` and only
+    // chunks that are written to allocate memory
+    void InitChunked(std::string name, int width, int height, TileType fill = TileType::Wall);
+
+    // Largest map InitFromRle decodes into flat storage (1 GiB of tiles);
+    // larger streams decode into chunked storage, up to kMaxDecodedChunkedTiles
+    // and a width of kMaxDecodedTiles / 64 (one band of chunks is buffered).
+    // Headers of compressed files are not trusted, so the stream is checked
+    // against these before anything is allocated; maps from peers have a
+    // tighter cap of their own (NetMessage::MapData::kMaxDimension).
+    static constexpr uint64_t kMaxDecodedTiles = uint64_t{1} << 30;
+    static constexpr uint64_t kMaxDecodedChunkedTiles = uint64_t{1} << 40;
+
+    // Initialize from a MapRle stream (see EncodeRle)
+    // Fails and leaves the map unchanged if the stream does not hold exactly
+    // width*height tiles or exceeds the limits above
+    [[nodiscard]] bool InitFromRle(std::string name, int width, int height,
+                                   std::span<const uint8_t> encoded);
+
+    // Run-length encode all tiles in row-major order (for disk and network transfer)
+    [[nodiscard]] std::vector<uint8_t> EncodeRle() const;
+
+    // Load map from file (format is detected from the file contents)
+    // Binary maps are memory-mapped: tiles are read straight from the mapped pages
+    // On failure the map is left unchanged and `error` (if given) says why
+    [[nodiscard]] bool LoadFromFile(std::string_view filename, MapLoadError* error = nullptr);
+
+    // Load with options (parallel text parsing, timing report)
+    [[nodiscard]] bool LoadFromFile(std::string_view filename, const MapLoadOptions& options,
+                                    MapLoadError* error = nullptr);
+
     // Save map to file
-    [[nodiscard]] bool SaveToFile(std::string_view filename) const;
-    
+    [[nodiscard]] bool SaveToFile(std::string_view filename,
+                                  MapFileFormat format = MapFileFormat::Text) const;
+
     // Get tile at position (bounds checked)
     [[nodiscard]] TileType GetTile(int x, int y) const noexcept;
-    
+
     // Set tile at position (bounds checked)
-    void SetTile(int x, int y, TileType tileType) noexcept;
-    
+    // On a memory-mapped map the write touches a private copy of the page only
+    // Writes that change the tile are recorded in the change journal
+    void SetTile(int x, int y, TileType tileType);
+
     // Direct access without bounds check (for performance-critical code)
     [[nodiscard]] TileType GetTileUnchecked(int x, int y) const noexcept {
-        return m_data[static_cast<size_t>(y * m_width + x)];
+        if (m_chunks) [[unlikely]] {
+            return m_chunks->Get(x, y);
+        }
+        return m_tiles[Index(x, y)];
+    }
+
+    // Tile (x + dx, y + dy) for an in-bounds (x, y) and |dx|, |dy| <= GetBorder().
+    // Sentinels outside the map read as Empty, the same as GetTile. Chunked
+    // maps have no border, so there the neighbour is always in bounds.
+    [[nodiscard]] TileType GetNeighborUnchecked(int x, int y, int dx, int dy) const noexcept {
+        if (m_chunks) [[unlikely]] {
+            return m_chunks->Get(x + dx, y + dy);
+        }
+        return m_tiles[Index(x + dx, y + dy)];
     }
-    
+
+    // Sentinel rings stored around the tiles (0 for loaded and chunked maps)
+    [[nodiscard]] int GetBorder() const noexcept { return m_border; }
+
+    // Walkability plane: one bit per tile, rows padded to whole 64-bit words.
+    // Kept in sync by Init, LoadFromFile and SetTile so hot loops test a bit
+    // instead of bounds-checking and comparing tile bytes. The plane carries a
+    // ring of unwalkable sentinel bits around the map. Walkability of each
+    // tile type comes from TileTable.
+    [[nodiscard]] static bool IsWalkableTile(TileType tile) noexcept {
+        return TileTable::IsWalkable(tile);
+    }
+
+    // Out-of-bounds tiles are not walkable
+    [[nodiscard]] bool IsWalkable(int x, int y) const noexcept {
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_width) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(m_height)) {
+            return false;
+        }
+        return IsWalkableUnchecked(x, y);
+    }
+
+    // Valid for -1 <= x <= width and -1 <= y <= height (the sentinel ring), so
+    // the 8 neighbours of any in-bounds tile can be tested without bounds checks
+    [[nodiscard]] bool IsWalkableUnchecked(int x, int y) const noexcept {
+        if (m_walkable.empty()) [[unlikely]] {
+            // Chunked maps keep no plane
+            return IsInBounds(x, y) && IsWalkableTile(GetTileUnchecked(x, y));
+        }
+        return (m_walkable[WalkWordIndex(x, y)] >> (x & 63)) & 1u;
+    }
+
+    // Word `wordX` of row y: bit i is tile (wordX * 64 + i, y)
+    // Caller guarantees 0 <= wordX < GetWalkableWordsPerRow() and 0 <= y < height
+    [[nodiscard]] uint64_t GetWalkableWord(int wordX, int y) const noexcept;
+
+    // 64 tiles of row y starting at any x: bit i is tile (x + i, y)
+    // Bits for tiles outside the map are 0
+    [[nodiscard]] uint64_t GetWalkableRun(int x, int y) const noexcept;
+
+    [[nodiscard]] int GetWalkableWordsPerRow() const noexcept { return m_walkWordsPerRow; }
+
+    // Connected regions of walkable tiles (see MapRegionIndex). Off by default;
+    // once enabled the labels are rebuilt by Init/LoadFromFile and kept current
+    // by SetTile. Tiles in different regions can never reach each other.
+    void EnableRegionIndex();
+    [[nodiscard]] bool HasRegionIndex() const noexcept { return m_regions.IsBuilt(); }
+    [[nodiscard]] MapRegionIndex::RegionId GetRegion(int x, int y) const noexcept {
+        return m_regions.GetRegion(x, y);
+    }
+    [[nodiscard]] const MapRegionIndex& GetRegionIndex() const noexcept { return m_regions; }
+
+    // Visit the map as rectangular blocks in row-major block order.
+    // Chunked maps report one block per chunk and flag uniform chunks so callers
+    // can skip them wholesale; flat maps are a single non-uniform block.
+    // The visitor returns false to stop early.
+    template<typename Fn>
+    void ForEachBlock(Fn&& visitor) const;
+
+    // The same walk restricted to `area`: only chunks overlapping it are
+    // visited, each clipped to it. Cost scales with the area, not the map.
+    template<typename Fn>
+    void ForEachBlock(MapRect area, Fn&& visitor) const;
+
+    // Row y as contiguous tiles, straight from storage. Only row-major flat
+    // maps store rows contiguously (HasContiguousRows); otherwise, or for y
+    // out of range, the span is empty.
+    [[nodiscard]] bool HasContiguousRows() const noexcept {
+        return m_tiles != nullptr && m_layout == MapLayout::RowMajor;
+    }
+    [[nodiscard]] std::span<const TileType> GetRowSpan(int y) const noexcept {
+        if (!HasContiguousRows() || static_cast<unsigned>(y) >= static_cast<unsigned>(m_height)) {
+            return {};
+        }
+        return {m_tiles + Index(0, y), static_cast<size_t>(m_width)};
+    }
+
+    // Visit the part of `area` inside the map one row at a time, top to bottom:
+    // visitor(int x, int y, std::span<const TileType> row), where row[i] is tile
+    // (x + i, y). Rows point into storage when it is row-major and into a
+    // scratch buffer (valid for the call only) for tiled and chunked maps, so
+    // visitors run over plain memory and simple loops vectorize. A visitor
+    // that returns bool stops the walk by returning false.
+    template<typename Fn>
+    void ForEachRowInRect(MapRect area, Fn&& visitor) const;
+
+    // Visit every tile of `area` inside the map in row-major order:
+    // visitor(int x, int y, TileType tile), optionally returning false to stop
+    template<typename Fn>
+    void ForEachInRect(MapRect area, Fn&& visitor) const;
+
+    // Change journal: SetTile records changed tiles per 64x64 chunk, and Init,
+    // InitChunked and LoadFromFile record a full reset. Call PublishChanges
+    // once per frame to notify subscribers and start a new journal.
+    MapChangeJournal::SubscriptionId SubscribeToChanges(MapChangeJournal::Listener listener,
+                                                        MapRect area = {}) {
+        return m_journal.Subscribe(std::move(listener), area);
+    }
+    void UnsubscribeFromChanges(MapChangeJournal::SubscriptionId id) noexcept { m_journal.Unsubscribe(id); }
+    void PublishChanges() { m_journal.Publish(*this); }
+    [[nodiscard]] const MapChangeJournal& GetChangeJournal() const noexcept { return m_journal; }
+
     // Getters
     [[nodiscard]] int GetWidth() const noexcept { return m_width; }
     [[nodiscard]] int GetHeight() const noexcept { return m_height; }
     [[nodiscard]] const std::string& GetName() const noexcept { return m_name; }
     [[nodiscard]] bool IsValid() const noexcept { return m_width > 0 && m_height > 0; }
-    
+
+    // True if tiles are backed by a memory-mapped .dmap file
+    [[nodiscard]] bool IsMemoryMapped() const noexcept { return m_mapping != nullptr; }
+
+    // Chunked storage
+    [[nodiscard]] bool IsChunked() const noexcept { return m_chunks != nullptr; }
+    [[nodiscard]] size_t GetAllocatedChunkCount() const noexcept {
+        return m_chunks ? m_chunks->GetAllocatedChunkCount() : 0;
+    }
+
+    // Collapse chunks that became uniform (no-op for flat maps)
+    // Returns the number of chunk buffers freed
+    size_t Compact();
+
+    // Flat tile order chosen at Init (loaded and chunked maps are RowMajor)
+    [[nodiscard]] MapLayout GetLayout() const noexcept { return m_layout; }
+
+    // Offset of tile (x, y) in flat storage, for cache analysis (flat maps only)
+    [[nodiscard]] size_t GetStorageIndex(int x, int y) const noexcept { return Index(x, y); }
+
+    // Bytes used by tile storage (mapped pages count towards the total)
+    [[nodiscard]] size_t GetTileMemoryBytes() const noexcept;
+
     // Bounds checking
     [[nodiscard]] bool IsInBounds(int x, int y) const noexcept {
         return x >= 0 && x < m_width && y >= 0 && y < m_height;
     }
 
 private:
+    // Storage offset of (x, y); coordinates inside the border are valid too
+    // (unsigned wrap-around keeps negative coordinates exact)
     [[nodiscard]] size_t Index(int x, int y) const noexcept {
-        return static_cast<size_t>(y * m_width + x);
+        if (m_layout == MapLayout::Tiled8x8) {
+            const int px = x + m_border;
+            const int py = y + m_border;
+            const size_t block = static_cast<size_t>(py >> 3) * static_cast<size_t>(m_blocksX) +
+                                 static_cast<size_t>(px >> 3);
+            return (block << 6) | static_cast<size_t>((py & 7) << 3) | static_cast<size_t>(px & 7);
+        }
+        return static_cast<size_t>(y) * m_stride + static_cast<size_t>(x) + m_origin;
+    }
+
+    [[nodiscard]] size_t TileCount() const noexcept {
+        return static_cast<size_t>(m_width) * static_cast<size_t>(m_height);
+    }
+
+    // Plane rows have a sentinel word on each side and there is a sentinel row
+    // above and below, so x in [-1, width] and y in [-1, height] are valid
+    [[nodiscard]] size_t WalkStride() const noexcept {
+        return static_cast<size_t>(m_walkWordsPerRow) + 2;
     }
+    [[nodiscard]] size_t WalkWordIndex(int x, int y) const noexcept {
+        return static_cast<size_t>(y + 1) * WalkStride() + static_cast<size_t>((x + 64) >> 6);
+    }
+
+    // Set layout, border and the derived strides for flat storage of the
+    // current width/height; returns the number of storage tiles needed
+    size_t SetFlatGeometry(MapLayout layout, int border) noexcept;
+
+    // Row y in row-major order: points into the tiles when they are stored that
+    // way, otherwise gathers the row into `scratch` (width tiles)
+    [[nodiscard]] const TileType* GetRow(int y, std::vector<TileType>& scratch) const;
+
+    // Recompute the walkability plane (and region labels, if enabled) from the tiles
+    void RebuildWalkability();
+
+    // Format-specific loaders/savers
+    [[nodiscard]] bool LoadText(const MappedFile& file, const MapLoadOptions& options, MapLoadError& error);
+    [[nodiscard]] bool LoadBinary(MappedFile file, MapLoadError& error);
+    [[nodiscard]] bool SaveText(std::string_view filename) const;
+    [[nodiscard]] bool SaveBinary(std::string_view filename, bool compressed) const;
+
+    // Feed every tile to a MapRle encoder, row by row
+    void EncodeRows(MapRle::Encoder& encoder, int firstRow, int rowCount) const;
+
+    // Drop any mapping/chunks and point m_tiles at m_data
+    void UseOwnedStorage() noexcept;
+
+    // InitChunked with tiles that are already in place
+    void InitChunked(std::string name, int width, int height, std::unique_ptr<ChunkedTileStorage> chunks);
 
     std::string m_name{"Untitled"};
     int m_width{};
     int m_height{};
-    std::vector<TileType> m_data{};
+    std::vector<TileType> m_data{};              // Owned tiles (empty when mapped)
+    std::unique_ptr<MappedFile> m_mapping{};     // Backing pages of a binary map
+    TileType* m_tiles{};                         // m_data.data() or into m_mapping
+    std::unique_ptr<ChunkedTileStorage> m_chunks{};  // Set for chunked maps (m_tiles is null)
+    MapLayout m_layout{MapLayout::RowMajor};     // Order of m_tiles
+    int m_border{};                              // Sentinel rings around the tiles
+    int m_blocksX{};                             // 8x8 blocks per block row (Tiled8x8)
+    size_t m_stride{};                           // Storage row length (RowMajor)
+    size_t m_origin{};                           // Storage offset of tile (0, 0) (RowMajor)
+    std::vector<uint64_t> m_walkable{};          // Walkability bits (empty for chunked maps)
+    int m_walkWordsPerRow{};
+    MapChangeJournal m_journal{};                // Per-frame changes and subscribers
+    MapRegionIndex m_regions{};                  // Walkable region labels (if enabled)
 };
+
+template<typename Fn>
+void Map::ForEachBlock(Fn&& visitor) const
+{
+    ForEachBlock(MapRect{0, 0, m_width, m_height}, std::forward<Fn>(visitor));
+}
+
+template<typename Fn>
+void Map::ForEachBlock(MapRect area, Fn&& visitor) const
+{
+    const int x0 = std::max(area.x, 0);
+    const int y0 = std::max(area.y, 0);
+    const int x1 = std::min(area.x + area.width, m_width);
+    const int y1 = std::min(area.y + area.height, m_height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    if (!m_chunks) {
+        visitor(MapBlock{x0, y0, x1 - x0, y1 - y0, false, TileType::Empty});
+        return;
+    }
+
+    constexpr int size = ChunkedTileStorage::kChunkSize;
+    for (int cy = y0 - y0 % size; cy < y1; cy += size) {
+        for (int cx = x0 - x0 % size; cx < x1; cx += size) {
+            const int bx = std::max(cx, x0);
+            const int by = std::max(cy, y0);
+            MapBlock block{bx, by, std::min(cx + size, x1) - bx, std::min(cy + size, y1) - by,
+                           false, TileType::Empty};
+            block.uniform = m_chunks->IsChunkUniform(cx, cy, block.tile);
+            if (!visitor(block)) {
+                return;
+            }
+        }
+    }
+}
+
+template<typename Fn>
+void Map::ForEachRowInRect(MapRect area, Fn&& visitor) const
+{
+    const int x0 = std::max(area.x, 0);
+    const int y0 = std::max(area.y, 0);
+    const int x1 = std::min(area.x + area.width, m_width);
+    const int y1 = std::min(area.y + area.height, m_height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const auto visit = [&visitor](int x, int y, std::span<const TileType> row) {
+        if constexpr (std::is_same_v<std::invoke_result_t<Fn&, int, int, std::span<const TileType>>, bool>) {
+            return visitor(x, y, row);
+        } else {
+            visitor(x, y, row);
+            return true;
+        }
+    };
+
+    const size_t count = static_cast<size_t>(x1 - x0);
+    if (HasContiguousRows()) {
+        for (int y = y0; y < y1; ++y) {
+            if (!visit(x0, y, std::span<const TileType>(m_tiles + Index(x0, y), count))) {
+                return;
+            }
+        }
+        return;
+    }
+
+    std::vector<TileType> scratch(count);
+    for (int y = y0; y < y1; ++y) {
+        for (int x = x0; x < x1; ++x) {
+            scratch[static_cast<size_t>(x - x0)] = GetTileUnchecked(x, y);
+        }
+        if (!visit(x0, y, std::span<const TileType>(scratch))) {
+            return;
+        }
+    }
+}
+
+template<typename Fn>
+void Map::ForEachInRect(MapRect area, Fn&& visitor) const
+{
+    ForEachRowInRect(area, [&visitor](int x0, int y, std::span<const TileType> row) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            const int x = x0 + static_cast<int>(i);
+            if constexpr (std::is_same_v<std::invoke_result_t<Fn&, int, int, TileType>, bool>) {
+                if (!visitor(x, y, row[i])) {
+                    return false;
+                }
+            } else {
+                visitor(x, y, row[i]);
+            }
+        }
+        return true;
+    });
+}
@@ -0,0 +1,114 @@
+#include "MapCache.h"
+#include <bit>
+#include <chrono>
+#include <system_error>
+#include <thread>
+
+namespace {
+    // 64-bit FNV-1a over the canonical little-endian encoding of each field
+    class KeyHasher {
+    public:
+        void Add(uint64_t value, int bytes) noexcept {
+            for (int i = 0; i < bytes; ++i) {
+                m_hash ^= (value >> (i * 8)) & 0xFF;
+                m_hash *= 0x100000001B3ull;
+            }
+        }
+        void Add(int value) noexcept { Add(static_cast<uint32_t>(value), 4); }
+        void Add(unsigned value) noexcept { Add(static_cast<uint64_t>(value), 4); }
+        void Add(float value) noexcept { Add(std::bit_cast<uint32_t>(value), 4); }
+
+        [[nodiscard]] uint64_t Get() const noexcept { return m_hash; }
+
+    private:
+        uint64_t m_hash{0xCBF29CE484222325ull};
+    };
+}
+
+MapCache::MapCache(std::filesystem::path directory)
+    : m_directory(std::move(directory))
+{
+}
+
+std::string MapCache::MakeKey(const MapGenerator::Config& config)
+{
+    // Every Config field that affects the output must be hashed here
+    // (threadCount does not, so maps generated with any thread count share a key).
+    // The Config is the whole input: the generator never reads global state
+    // such as TileTable, so tile settings loaded at runtime need no key.
+    KeyHasher hasher;
+    hasher.Add(MapGenerator::kVersion);
+    hasher.Add(config.width);
+    hasher.Add(config.height);
+    hasher.Add(config.wallDensity);
+    hasher.Add(config.smoothIterations);
+    hasher.Add(config.wallThreshold);
+    hasher.Add(config.waterChance);
+    hasher.Add(config.seed);
+    hasher.Add(static_cast<unsigned>(config.algorithm));
+    hasher.Add(static_cast<unsigned>(config.connectivity));
+    hasher.Add(config.minRegionSize);
+
+    constexpr char kHex[] = "0123456789abcdef";
+    const uint64_t hash = hasher.Get();
+    std::string key(16, '0');
+    for (int i = 0; i < 16; ++i) {
+        key[static_cast<size_t>(i)] = kHex[(hash >> ((15 - i) * 4)) & 0xF];
+    }
+    return key;
+}
+
+std::filesystem::path MapCache::GetPath(const MapGenerator::Config& config) const
+{
+    return m_directory / (MakeKey(config) + ".dmap");
+}
+
+void MapCache::ResetCounters() noexcept
+{
+    m_hits.store(0, std::memory_order_relaxed);
+    m_misses.store(0, std::memory_order_relaxed);
+}
+
+Map MapCache::GetOrGenerate(const MapGenerator::Config& config)
+{
+    if (config.seed == 0) {
+        return MapGenerator::Generate(config);
+    }
+
+    Map map;
+    if (map.LoadFromFile(GetPath(config).string()) &&
+        map.GetWidth() == config.width && map.GetHeight() == config.height) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return map;
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+    map = MapGenerator::Generate(config);
+    Store(config, map);
+    return map;
+}
+
+void MapCache::Store(const MapGenerator::Config& config, const Map& map) const
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        return;
+    }
+
+    // Unique temporary name so concurrent writers never interleave
+    const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    const auto thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const std::filesystem::path target = GetPath(config);
+    std::filesystem::path temporary = target;
+    temporary += ".tmp" + std::to_string(stamp) + "-" + std::to_string(thread);
+
+    if (!map.SaveToFile(temporary.string(), MapFileFormat::Compressed)) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+    std::filesystem::rename(temporary, target, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "MapGenerator.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// On-disk cache of generated maps, addressed by a hash of the generator Config
+// and MapGenerator::kVersion
+//
+// Generation is deterministic for a non-zero seed, so an identical Config
+// always yields the same map and the result can be stored once and reloaded
+// by every later run (or every server instance sharing the directory). Maps
+// are stored as compressed .dmap files named after their key; files are
+// written to a temporary name and renamed into place, so readers never see a
+// partial file. Seed 0 means "random" and is never cached.
+class MapCache {
+public:
+    explicit MapCache(std::filesystem::path directory);
+
+    // Return the cached map for `config`, or generate it and store it.
+    // Unreadable or mismatching cache files count as misses and are replaced.
+    [[nodiscard]] Map GetOrGenerate(const MapGenerator::Config& config);
+
+    // 16 hex digits identifying the generator output for `config`
+    [[nodiscard]] static std::string MakeKey(const MapGenerator::Config& config);
+
+    // Cache file for `config` (whether or not it exists)
+    [[nodiscard]] std::filesystem::path GetPath(const MapGenerator::Config& config) const;
+
+    // Counters since construction or ResetCounters. Uncacheable (seed 0)
+    // requests count as neither.
+    [[nodiscard]] uint64_t GetHitCount() const noexcept { return m_hits.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t GetMissCount() const noexcept { return m_misses.load(std::memory_order_relaxed); }
+    void ResetCounters() noexcept;
+
+    [[nodiscard]] const std::filesystem::path& GetDirectory() const noexcept { return m_directory; }
+
+private:
+    // Write `map` to the cache file for `config`; failures are not fatal
+    void Store(const MapGenerator::Config& config, const Map& map) const;
+
+    std::filesystem::path m_directory;
+    std::atomic<uint64_t> m_hits{};
+    std::atomic<uint64_t> m_misses{};
+};
@@ -0,0 +1,141 @@
+#include "MapChangeJournal.h"
+#include "ChunkedTileStorage.h"
+#include <algorithm>
+
+namespace {
+    constexpr int kChunkShift = ChunkedTileStorage::kChunkShift;
+}
+
+size_t MapChangeJournal::ChunkIndex(int x, int y) const noexcept
+{
+    return static_cast<size_t>(y >> kChunkShift) * static_cast<size_t>(m_chunksX) +
+           static_cast<size_t>(x >> kChunkShift);
+}
+
+void MapChangeJournal::Reset(int width, int height)
+{
+    Clear();
+    m_width = width;
+    m_height = height;
+    m_chunksX = (std::max(width, 0) + ChunkedTileStorage::kChunkSize - 1) >> kChunkShift;
+    m_chunkSlot.clear();   // Resized for the new dimensions on the next Record
+    m_fullReset = true;
+}
+
+void MapChangeJournal::Record(int x, int y)
+{
+    if (m_fullReset) {
+        return;  // Already covers every tile
+    }
+
+    if (m_chunkSlot.empty()) {
+        const int chunksY = (std::max(m_height, 0) + ChunkedTileStorage::kChunkSize - 1) >> kChunkShift;
+        m_chunkSlot.resize(static_cast<size_t>(m_chunksX) * static_cast<size_t>(chunksY), 0);
+    }
+
+    uint32_t& slot = m_chunkSlot[ChunkIndex(x, y)];
+    if (slot == 0) {
+        m_regions.push_back({x, y, 1, 1});
+        slot = static_cast<uint32_t>(m_regions.size());
+        return;
+    }
+
+    // Grow the chunk's bounds to include the tile
+    MapRect& rect = m_regions[slot - 1];
+    const int right = std::max(rect.x + rect.width, x + 1);
+    const int bottom = std::max(rect.y + rect.height, y + 1);
+    rect.x = std::min(rect.x, x);
+    rect.y = std::min(rect.y, y);
+    rect.width = right - rect.x;
+    rect.height = bottom - rect.y;
+}
+
+void MapChangeJournal::Clear() noexcept
+{
+    // Only the slots of dirty chunks need resetting
+    for (const MapRect& rect : m_regions) {
+        m_chunkSlot[ChunkIndex(rect.x, rect.y)] = 0;
+    }
+    m_regions.clear();
+    m_fullReset = false;
+}
+
+MapChangeJournal::SubscriptionId MapChangeJournal::Subscribe(Listener listener, MapRect area)
+{
+    const SubscriptionId id = m_nextId++;
+    auto& target = m_publishing ? m_added : m_subscriptions;
+    target.push_back({id, std::move(listener), area});
+    return id;
+}
+
+void MapChangeJournal::Unsubscribe(SubscriptionId id) noexcept
+{
+    for (auto* list : {&m_subscriptions, &m_added}) {
+        for (Subscription& sub : *list) {
+            if (sub.id == id) {
+                // Entries are erased after delivery so iteration stays valid
+                sub.id = kInvalidSubscription;
+            }
+        }
+    }
+    if (!m_publishing) {
+        std::erase_if(m_subscriptions, [](const Subscription& sub) { return sub.id == kInvalidSubscription; });
+    }
+}
+
+size_t MapChangeJournal::GetSubscriberCount() const noexcept
+{
+    size_t count = 0;
+    for (const auto* list : {&m_subscriptions, &m_added}) {
+        count += static_cast<size_t>(std::count_if(list->begin(), list->end(),
+            [](const Subscription& sub) { return sub.id != kInvalidSubscription; }));
+    }
+    return count;
+}
+
+void MapChangeJournal::Publish(const Map& map)
+{
+    if (!HasChanges() || m_publishing) {
+        return;
+    }
+
+    // Take the pending changes so edits made by listeners start a fresh journal
+    const bool fullReset = m_fullReset;
+    m_delivering.swap(m_regions);
+    for (const MapRect& rect : m_delivering) {
+        m_chunkSlot[ChunkIndex(rect.x, rect.y)] = 0;
+    }
+    m_regions.clear();
+    m_fullReset = false;
+
+    m_publishing = true;
+    const MapChangeSet all{fullReset, m_delivering};
+    for (const Subscription& sub : m_subscriptions) {
+        if (sub.id == kInvalidSubscription) continue;
+
+        if (fullReset || sub.area.IsEmpty()) {
+            sub.listener(map, all);
+            continue;
+        }
+
+        m_filtered.clear();
+        for (const MapRect& rect : m_delivering) {
+            if (rect.Intersects(sub.area)) {
+                m_filtered.push_back(rect);
+            }
+        }
+        if (!m_filtered.empty()) {
+            sub.listener(map, MapChangeSet{false, m_filtered});
+        }
+    }
+    m_publishing = false;
+
+    std::erase_if(m_subscriptions, [](const Subscription& sub) { return sub.id == kInvalidSubscription; });
+    for (Subscription& sub : m_added) {
+        if (sub.id != kInvalidSubscription) {
+            m_subscriptions.push_back(std::move(sub));
+        }
+    }
+    m_added.clear();
+    m_delivering.clear();
+}
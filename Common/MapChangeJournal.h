@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+class Map;
+
+// Axis-aligned rectangle of tiles
+struct MapRect {
+    int x, y;
+    int width, height;
+
+    [[nodiscard]] bool IsEmpty() const noexcept { return width <= 0 || height <= 0; }
+    [[nodiscard]] bool Contains(int tx, int ty) const noexcept {
+        return tx >= x && tx < x + width && ty >= y && ty < y + height;
+    }
+    [[nodiscard]] bool Intersects(const MapRect& other) const noexcept {
+        return x < other.x + other.width && other.x < x + width &&
+               y < other.y + other.height && other.y < y + height;
+    }
+};
+
+// Changes delivered to subscribers by MapChangeJournal::Publish
+struct MapChangeSet {
+    bool fullReset{};                  // Every tile may have changed (Init/Load)
+    std::span<const MapRect> regions;  // Changed bounds, at most one per 64x64 chunk
+};
+
+// Per-frame journal of tile changes with area-filtered subscriptions
+//
+// Map records every effective SetTile here. Changes are grouped by 64x64 chunk
+// and each chunk keeps the tight bounds of its changed tiles, so the journal
+// stays small no matter how many times a tile is rewritten. Publish (once per
+// frame) hands the regions to every subscriber whose area they touch and then
+// clears the journal.
+class MapChangeJournal {
+public:
+    using Listener = std::function<void(const Map& map, const MapChangeSet& changes)>;
+    using SubscriptionId = uint32_t;
+    static constexpr SubscriptionId kInvalidSubscription = 0;
+
+    MapChangeJournal() = default;
+
+    // The whole map was replaced: pending regions collapse into a full reset
+    void Reset(int width, int height);
+
+    // Tile (x, y) changed (caller guarantees it is in bounds)
+    void Record(int x, int y);
+
+    [[nodiscard]] bool HasChanges() const noexcept { return m_fullReset || !m_regions.empty(); }
+    [[nodiscard]] bool IsFullReset() const noexcept { return m_fullReset; }
+    [[nodiscard]] std::span<const MapRect> GetChangedRegions() const noexcept { return m_regions; }
+
+    // Drop pending changes without notifying anyone
+    void Clear() noexcept;
+
+    // Listen for changes. With a non-empty `area` the listener only runs when a
+    // changed region intersects it and only sees those regions; full resets are
+    // always delivered.
+    SubscriptionId Subscribe(Listener listener, MapRect area = {});
+    void Unsubscribe(SubscriptionId id) noexcept;
+    [[nodiscard]] size_t GetSubscriberCount() const noexcept;
+
+    // Notify subscribers of pending changes, then clear them. Listeners may
+    // subscribe, unsubscribe or edit the map while being notified; edits made
+    // during delivery are journaled for the next Publish.
+    void Publish(const Map& map);
+
+    // Subscriptions belong to one map instance and never transfer
+    MapChangeJournal(const MapChangeJournal&) = delete;
+    MapChangeJournal& operator=(const MapChangeJournal&) = delete;
+
+private:
+    struct Subscription {
+        SubscriptionId id;
+        Listener listener;
+        MapRect area;
+    };
+
+    [[nodiscard]] size_t ChunkIndex(int x, int y) const noexcept;
+
+    int m_width{};
+    int m_height{};
+    int m_chunksX{};
+    bool m_fullReset{};
+    bool m_publishing{};
+    std::vector<MapRect> m_regions;           // One entry per dirty chunk
+    std::vector<uint32_t> m_chunkSlot;        // 1-based index into m_regions, 0 = clean
+    std::vector<Subscription> m_subscriptions;
+    std::vector<Subscription> m_added;        // Subscribed during Publish
+    std::vector<MapRect> m_delivering;        // Regions being published
+    std::vector<MapRect> m_filtered;          // Scratch for area-filtered delivery
+    SubscriptionId m_nextId{1};
+};
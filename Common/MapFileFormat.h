@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+// Binary map file format (.dmap)
+//
+// Layout: a fixed 96-byte header followed by the tile data at header.dataOffset.
+// Raw files (kTileFormat) hold width*height TileType bytes in row-major order,
+// starting on a cache-line boundary so a memory-mapped file can back a Map
+// directly. Compressed files (kTileFormatRle) hold a MapRle stream instead and
+// are decoded on load. Seeded files (kTileFormatSeeded) hold a generator Config
+// and edit overlay instead of tiles and are read by SeededMap, not Map.
+// All integers are little-endian.
+namespace DmapFormat {
+    inline constexpr char kMagic[4] = {'D', 'M', 'A', 'P'};
+    inline constexpr uint16_t kVersion = 1;        // Container layout version
+    inline constexpr uint16_t kTileFormat = 1;     // Raw TileType bytes
+    inline constexpr uint16_t kTileFormatRle = 2;  // MapRle run-length stream
+    inline constexpr uint16_t kTileFormatSeeded = 3;  // SeededMap payload (Config + edits)
+    inline constexpr size_t kMaxNameLength = 64;
+    inline constexpr uint32_t kDataOffset = 128;
+
+    struct Header {
+        char magic[4];                 // "DMAP"
+        uint16_t version;              // kVersion
+        uint16_t tileFormat;           // kTileFormat or kTileFormatRle
+        int32_t width;
+        int32_t height;
+        uint32_t dataOffset;           // Byte offset of tile data from file start
+        uint32_t flags;                // Reserved, written as 0
+        uint64_t dataSize;             // Byte count of tile data
+        char name[kMaxNameLength];     // NUL-padded, truncated if longer
+    };
+    static_assert(sizeof(Header) == 96, "DMAP header must stay 96 bytes");
+    static_assert(sizeof(Header) <= kDataOffset, "Tile data must follow the header");
+
+    // Check whether a buffer starts with the DMAP magic
+    [[nodiscard]] inline bool HasMagic(const void* data, size_t size) noexcept {
+        return size >= sizeof(kMagic) && std::memcmp(data, kMagic, sizeof(kMagic)) == 0;
+    }
+
+    // Header for a new file (the one place every writer fills it in, so files
+    // from Map, MapStreamWriter and SeededMap stay byte-compatible)
+    [[nodiscard]] inline Header MakeHeader(uint16_t tileFormat, int32_t width, int32_t height,
+                                           uint64_t dataSize, std::string_view name) noexcept {
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(header.magic));
+        header.version = kVersion;
+        header.tileFormat = tileFormat;
+        header.width = width;
+        header.height = height;
+        header.dataOffset = kDataOffset;
+        header.flags = 0;
+        header.dataSize = dataSize;
+        std::copy_n(name.data(), std::min(name.size(), kMaxNameLength), header.name);
+        return header;
+    }
+
+    // Write the header and zero padding up to kDataOffset; the data follows
+    inline void WriteHeader(std::ostream& out, const Header& header) {
+        const char padding[kDataOffset - sizeof(Header)]{};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(padding, sizeof(padding));
+    }
+
+    // Overwrite the dataSize of a header written at the start of `out`, for
+    // data whose size is known only after it has been written
+    inline void PatchDataSize(std::ostream& out, uint64_t dataSize) {
+        out.seekp(static_cast<std::streamoff>(offsetof(Header, dataSize)));
+        out.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
+    }
+}
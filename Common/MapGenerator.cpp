@@ -1,6 +1,66 @@
 #include "MapGenerator.h"
+#include "CounterRng.h"
+#include "Parallel.h"
+#include "WallBitboard.h"
 #include <algorithm>
 #include <chrono>
+#include <utility>
+
+namespace {
+    // CounterRng stages of Algorithm::CounterHash
+    constexpr uint32_t kStageFill = 0;
+    constexpr uint32_t kStageWaterPool = 1;
+    constexpr uint32_t kStageWaterSize = 2;
+
+    // Farthest a water pool reaches from its centre (pool sizes are 2-5)
+    constexpr int kMaxPoolReach = 2;
+
+    // Config seed, or a clock-based one for seed 0
+    unsigned int ResolveSeed(const MapGenerator::Config& config)
+    {
+        if (config.seed != 0) {
+            return config.seed;
+        }
+        return static_cast<unsigned int>(
+            std::chrono::high_resolution_clock::now().time_since_epoch().count()
+        );
+    }
+
+    // Circular-ish water pool of at most 5x5 tiles around an interior (x, y);
+    // only floor turns to water. Shared by both mt19937 placements.
+    void StampPool(std::vector<TileType>& tiles, int width, int x, int y, int poolSize) noexcept
+    {
+        const int radius = poolSize / 2;
+        const int reach = (radius + 1) * (radius + 1);
+        for (int dy = -radius; dy <= radius; ++dy) {
+            TileType* row = tiles.data() + static_cast<size_t>(y + dy) * static_cast<size_t>(width) + static_cast<size_t>(x);
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (dx*dx + dy*dy <= reach && row[dx] == TileType::Floor) {
+                    row[dx] = TileType::Water;
+                }
+            }
+        }
+    }
+
+    // Counter-hash initial fill of map rows [firstRow, endRow) into `out`
+    // (row firstRow first); the map border is always wall
+    void FillHashedRows(TileType* out, int width, int height, int firstRow, int endRow,
+                        float wallDensity, uint64_t stream) noexcept
+    {
+        for (int y = firstRow; y < endRow; ++y) {
+            TileType* row = out + static_cast<size_t>(y - firstRow) * static_cast<size_t>(width);
+            const bool borderRow = y == 0 || y == height - 1;
+            for (int x = 0; x < width; ++x) {
+                if (borderRow || x == 0 || x == width - 1) {
+                    row[x] = TileType::Wall;
+                } else {
+                    const float roll = CounterRng::ToUnitFloat(CounterRng::Hash(stream, x, y));
+                    row[x] = roll < wallDensity ? TileType::Wall : TileType::Floor;
+                }
+            }
+        }
+    }
+}
 
 Map MapGenerator::Generate(const Config& config)
 {
@@ -8,42 +68,87 @@ Map MapGenerator::Generate(const Config& config)
     const int height = config.height;
     
     // Initialize random generator
-    unsigned int seed = config.seed;
-    if (seed == 0) {
-        seed = static_cast<unsigned int>(
-            std::chrono::high_resolution_clock::now().time_since_epoch().count()
-        );
-    }
+    const unsigned int seed = ResolveSeed(config);
+    const bool sequential = config.algorithm == Algorithm::Sequential ||
+                            config.algorithm == Algorithm::SequentialSkip;
     std::mt19937 rng(seed);
     std::uniform_real_distribution<float> dist(0.0f, 1.0f);
     
     // Create tile array
-    std::vector<TileType> tiles(static_cast<size_t>(width * height));
+    std::vector<TileType> tiles(static_cast<size_t>(std::max(width, 0)) * static_cast<size_t>(std::max(height, 0)));
     
-    // Step 1: Random initial fill
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            const size_t idx = static_cast<size_t>(y * width + x);
-            
-            // Border is always wall
-            if (x == 0 || x == width - 1 || y == 0 || y == height - 1) {
-                tiles[idx] = TileType::Wall;
-            } else {
-                tiles[idx] = (dist(rng) < config.wallDensity) ? TileType::Wall : TileType::Floor;
+    // Row bands for the parallel stages; no stage's result depends on the count
+    constexpr int kMinRowsPerBand = 64;
+    const unsigned bands = std::min(Parallel::ResolveThreadCount(config.threadCount),
+                                    static_cast<unsigned>(std::max(1, height / kMinRowsPerBand)));
+    const auto rows = [&](unsigned band) {
+        const Parallel::Range range = Parallel::BandRange(static_cast<size_t>(std::max(height, 0)), band, bands);
+        return std::pair{static_cast<int>(range.begin), static_cast<int>(range.end)};
+    };
+    
+    // Step 1: Random initial fill. Sequential maps draw from one mt19937
+    // stream in row-major order (so it stays serial); counter-hash maps draw
+    // each tile from its own key and fill row bands in parallel.
+    if (sequential) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const size_t idx = static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
+                
+                // Border is always wall
+                if (x == 0 || x == width - 1 || y == 0 || y == height - 1) {
+                    tiles[idx] = TileType::Wall;
+                } else {
+                    tiles[idx] = (dist(rng) < config.wallDensity) ? TileType::Wall : TileType::Floor;
+                }
             }
         }
+    } else {
+        const uint64_t stream = CounterRng::StreamKey(seed, kStageFill);
+        Parallel::ForEachBand(bands, [&](unsigned band) {
+            const auto [first, end] = rows(band);
+            FillHashedRows(tiles.data() + static_cast<size_t>(first) * static_cast<size_t>(width),
+                           width, height, first, end, config.wallDensity, stream);
+        });
     }
     
-    // Step 2: Cellular automata smoothing (use double-buffering)
-    std::vector<TileType> buffer(static_cast<size_t>(width * height));
-    for (int i = 0; i < config.smoothIterations; ++i) {
-        SmoothMap(tiles, buffer, width, height, config.wallThreshold);
-        std::swap(tiles, buffer);
+    // Step 2: Cellular automata smoothing on the packed wall mask (64 tiles per
+    // operation, double-buffered); identical to running SmoothMap per pass.
+    // Each pass only reads the previous buffer, so row bands run in parallel.
+    if (config.smoothIterations > 0) {
+        WallBitboard board(width, height);
+        WallBitboard buffer(width, height);
+        Parallel::ForEachBand(bands, [&](unsigned band) {
+            const auto [first, end] = rows(band);
+            board.PackRows(tiles, first, end);
+        });
+        for (int i = 0; i < config.smoothIterations; ++i) {
+            Parallel::ForEachBand(bands, [&](unsigned band) {
+                const auto [first, end] = rows(band);
+                board.SmoothRows(buffer, config.wallThreshold, first, end);
+            });
+            std::swap(board, buffer);
+        }
+        Parallel::ForEachBand(bands, [&](unsigned band) {
+            const auto [first, end] = rows(band);
+            board.UnpackRows(tiles, first, end);
+        });
     }
     
-    // Step 3: Add water pools
+    // Step 3: Add water pools (sequential maps continue the mt19937 stream,
+    // so pools are placed in row-major order)
     if (config.waterChance > 0.0f) {
-        AddWaterPools(tiles, width, height, config.waterChance, rng);
+        if (config.algorithm == Algorithm::Sequential) {
+            AddWaterPools(tiles, width, height, config.waterChance, rng);
+        } else if (sequential) {
+            AddWaterPoolsSkipAhead(tiles, width, height, config.waterChance, rng);
+        } else {
+            AddWaterPoolsHashed(tiles, width, height, 0, 0, height, config.waterChance, seed);
+        }
+    }
+    
+    // Step 4: Optionally make the walkable area one connected region
+    if (config.connectivity != Connectivity::Keep) {
+        ConnectRegions(tiles, width, height, config.connectivity, config.minRegionSize);
     }
     
     // Create and initialize map
@@ -61,13 +166,264 @@ Map MapGenerator::Generate(int width, int height, unsigned int seed)
     return Generate(config);
 }
 
+int MapGenerator::GetChunkApron(const Config& config) noexcept
+{
+    // Each smoothing pass reads one ring further out; pool centres up to
+    // kMaxPoolReach outside the chunk can still flood its edge
+    return std::max(config.smoothIterations, 0) + (config.waterChance > 0.0f ? kMaxPoolReach : 0);
+}
+
+std::vector<TileType> MapGenerator::GenerateChunk(const Config& config, int chunkX, int chunkY)
+{
+    // Work on the chunk plus its apron; working tile (0, 0) is world (originX, originY)
+    const int apron = GetChunkApron(config);
+    const int size = kChunkSize + 2 * apron;
+    const int originX = chunkX * kChunkSize - apron;
+    const int originY = chunkY * kChunkSize - apron;
+    const auto at = [size](int x, int y) { return static_cast<size_t>(y * size + x); };
+    
+    // Step 1: Counter-hash fill in world coordinates
+    std::vector<TileType> tiles(static_cast<size_t>(size * size));
+    const uint64_t fillStream = CounterRng::StreamKey(config.seed, kStageFill);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const float roll = CounterRng::ToUnitFloat(CounterRng::Hash(fillStream, originX + x, originY + y));
+            tiles[at(x, y)] = roll < config.wallDensity ? TileType::Wall : TileType::Floor;
+        }
+    }
+    
+    // Step 2: Smoothing. Each pass forces the working area's outer ring to wall
+    // and so spoils one more ring from the outside in; the apron absorbs that.
+    if (config.smoothIterations > 0) {
+        WallBitboard board = WallBitboard::FromTiles(tiles, size, size);
+        WallBitboard buffer(size, size);
+        for (int i = 0; i < config.smoothIterations; ++i) {
+            board.Smooth(buffer, config.wallThreshold);
+            std::swap(board, buffer);
+        }
+        board.ToTiles(tiles);
+    }
+    
+    std::vector<TileType> chunk(static_cast<size_t>(kChunkSize * kChunkSize));
+    for (int y = 0; y < kChunkSize; ++y) {
+        std::copy_n(tiles.begin() + static_cast<std::ptrdiff_t>(at(apron, apron + y)), kChunkSize,
+                    chunk.begin() + static_cast<std::ptrdiff_t>(y * kChunkSize));
+    }
+    
+    // Step 3: Water pools whose centre lies within reach of the chunk. Centres
+    // and sizes are keyed by world position, as in AddWaterPoolsHashed.
+    if (config.waterChance > 0.0f) {
+        const uint64_t poolStream = CounterRng::StreamKey(config.seed, kStageWaterPool);
+        const uint64_t sizeStream = CounterRng::StreamKey(config.seed, kStageWaterSize);
+        for (int cy = -kMaxPoolReach; cy < kChunkSize + kMaxPoolReach; ++cy) {
+            for (int cx = -kMaxPoolReach; cx < kChunkSize + kMaxPoolReach; ++cx) {
+                const int worldX = chunkX * kChunkSize + cx;
+                const int worldY = chunkY * kChunkSize + cy;
+                if (tiles[at(apron + cx, apron + cy)] != TileType::Floor ||
+                    CounterRng::ToUnitFloat(CounterRng::Hash(poolStream, worldX, worldY)) >= config.waterChance) {
+                    continue;
+                }
+                
+                const int poolSize = CounterRng::ToRange(CounterRng::Hash(sizeStream, worldX, worldY), 2, 5);
+                for (int dy = -poolSize/2; dy <= poolSize/2; ++dy) {
+                    for (int dx = -poolSize/2; dx <= poolSize/2; ++dx) {
+                        const int px = cx + dx;
+                        const int py = cy + dy;
+                        if (px < 0 || px >= kChunkSize || py < 0 || py >= kChunkSize) continue;
+                        if (dx*dx + dy*dy <= (poolSize/2 + 1) * (poolSize/2 + 1)) {
+                            TileType& tile = chunk[static_cast<size_t>(py * kChunkSize + px)];
+                            if (tile == TileType::Floor) {
+                                tile = TileType::Water;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    return chunk;
+}
+
+bool MapGenerator::GenerateBands(const Config& config, int bandRows, const BandSink& sink)
+{
+    const int width = config.width;
+    const int height = config.height;
+    if (config.algorithm != Algorithm::CounterHash || config.connectivity != Connectivity::Keep ||
+        width <= 0 || height <= 0 || bandRows <= 0) {
+        return false;
+    }
+    bandRows = std::min(bandRows, height);
+    
+    // Each band is generated inside a window of map rows extended by the
+    // apron on both sides (clipped to the map). The window's cut edges are
+    // forced to wall by every smoothing pass, which spoils one more row per
+    // pass from the outside in; the apron absorbs that, as for chunks.
+    const unsigned int seed = ResolveSeed(config);
+    const int apron = GetChunkApron(config);
+    const uint64_t fillStream = CounterRng::StreamKey(seed, kStageFill);
+    std::vector<TileType> window;
+    WallBitboard board;
+    WallBitboard buffer;
+    
+    for (int first = 0; first < height; first += bandRows) {
+        const int end = std::min(height - first, bandRows) + first;
+        const int windowFirst = std::max(0, first - apron);
+        const int windowEnd = std::min(height - end, apron) + end;
+        const int windowRows = windowEnd - windowFirst;
+        window.resize(static_cast<size_t>(windowRows) * static_cast<size_t>(width));
+        
+        // Steps 1-3 of Generate on the window
+        FillHashedRows(window.data(), width, height, windowFirst, windowEnd, config.wallDensity, fillStream);
+        if (config.smoothIterations > 0) {
+            if (board.GetHeight() != windowRows) {
+                board = WallBitboard(width, windowRows);
+                buffer = WallBitboard(width, windowRows);
+            }
+            board.PackRows(window, 0, windowRows);
+            for (int i = 0; i < config.smoothIterations; ++i) {
+                board.SmoothRows(buffer, config.wallThreshold, 0, windowRows);
+                std::swap(board, buffer);
+            }
+            board.UnpackRows(window, 0, windowRows);
+        }
+        if (config.waterChance > 0.0f) {
+            AddWaterPoolsHashed(window, width, height, windowFirst, first, end, config.waterChance, seed);
+        }
+        
+        const size_t offset = static_cast<size_t>(first - windowFirst) * static_cast<size_t>(width);
+        const size_t count = static_cast<size_t>(end - first) * static_cast<size_t>(width);
+        if (!sink(first, std::span<const TileType>(window).subspan(offset, count))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<MapGenerator::TileChange> MapGenerator::RegenerateArea(Map& map, MapRect area, const Config& config)
+{
+    // Clip to the interior: the map border is never regenerated
+    const int left = std::max(area.x, 1);
+    const int top = std::max(area.y, 1);
+    const int right = std::min(area.x + std::max(area.width, 0), map.GetWidth() - 1);
+    const int bottom = std::min(area.y + std::max(area.height, 0), map.GetHeight() - 1);
+    if (left >= right || top >= bottom) {
+        return {};
+    }
+    
+    // Working grid: the area plus a one-tile ring of existing map tiles;
+    // working tile (0, 0) is map (originX, originY)
+    const int originX = left - 1;
+    const int originY = top - 1;
+    const int gridWidth = right - left + 2;
+    const int gridHeight = bottom - top + 2;
+    const auto at = [gridWidth](int x, int y) {
+        return static_cast<size_t>(y) * static_cast<size_t>(gridWidth) + static_cast<size_t>(x);
+    };
+    const auto inArea = [gridWidth, gridHeight](int x, int y) {
+        return x > 0 && x < gridWidth - 1 && y > 0 && y < gridHeight - 1;
+    };
+    
+    // Step 1: Ring from the map, area from counter-hash draws at map positions
+    const unsigned int seed = ResolveSeed(config);
+    const uint64_t fillStream = CounterRng::StreamKey(seed, kStageFill);
+    std::vector<TileType> tiles(at(0, gridHeight));
+    for (int y = 0; y < gridHeight; ++y) {
+        for (int x = 0; x < gridWidth; ++x) {
+            if (inArea(x, y)) {
+                const float roll = CounterRng::ToUnitFloat(CounterRng::Hash(fillStream, originX + x, originY + y));
+                tiles[at(x, y)] = roll < config.wallDensity ? TileType::Wall : TileType::Floor;
+            } else {
+                tiles[at(x, y)] = map.GetTile(originX + x, originY + y);
+            }
+        }
+    }
+    
+    // Step 2: Smoothing. Each pass forces the working grid's outer ring to
+    // wall, so the ring's real wall bits are put back after every pass.
+    if (config.smoothIterations > 0) {
+        WallBitboard board = WallBitboard::FromTiles(tiles, gridWidth, gridHeight);
+        const WallBitboard ring = board;
+        WallBitboard buffer(gridWidth, gridHeight);
+        for (int i = 0; i < config.smoothIterations; ++i) {
+            board.Smooth(buffer, config.wallThreshold);
+            for (int x = 0; x < gridWidth; ++x) {
+                buffer.SetWall(x, 0, ring.IsWall(x, 0));
+                buffer.SetWall(x, gridHeight - 1, ring.IsWall(x, gridHeight - 1));
+            }
+            for (int y = 1; y < gridHeight - 1; ++y) {
+                buffer.SetWall(0, y, ring.IsWall(0, y));
+                buffer.SetWall(gridWidth - 1, y, ring.IsWall(gridWidth - 1, y));
+            }
+            std::swap(board, buffer);
+        }
+        
+        // Only area tiles take the smoothed state; the ring keeps its tile types
+        for (int y = 1; y < gridHeight - 1; ++y) {
+            for (int x = 1; x < gridWidth - 1; ++x) {
+                tiles[at(x, y)] = board.IsWall(x, y) ? TileType::Wall : TileType::Floor;
+            }
+        }
+    }
+    
+    // Step 3: Water pools centred in the area (and at least 5 tiles from the
+    // map edge, as in Generate), clipped to the area
+    if (config.waterChance > 0.0f) {
+        const uint64_t poolStream = CounterRng::StreamKey(seed, kStageWaterPool);
+        const uint64_t sizeStream = CounterRng::StreamKey(seed, kStageWaterSize);
+        const int firstX = std::max(1, 5 - originX);
+        const int endX = std::min(gridWidth - 1, map.GetWidth() - 5 - originX);
+        const int firstY = std::max(1, 5 - originY);
+        const int endY = std::min(gridHeight - 1, map.GetHeight() - 5 - originY);
+        std::vector<std::pair<int, int>> centres;
+        for (int y = firstY; y < endY; ++y) {
+            for (int x = firstX; x < endX; ++x) {
+                if (tiles[at(x, y)] == TileType::Floor &&
+                    CounterRng::ToUnitFloat(CounterRng::Hash(poolStream, originX + x, originY + y)) < config.waterChance) {
+                    centres.emplace_back(x, y);
+                }
+            }
+        }
+        for (const auto& [x, y] : centres) {
+            const int poolSize = CounterRng::ToRange(CounterRng::Hash(sizeStream, originX + x, originY + y), 2, 5);
+            for (int dy = -poolSize/2; dy <= poolSize/2; ++dy) {
+                for (int dx = -poolSize/2; dx <= poolSize/2; ++dx) {
+                    if (dx*dx + dy*dy <= (poolSize/2 + 1) * (poolSize/2 + 1) && inArea(x + dx, y + dy)) {
+                        TileType& tile = tiles[at(x + dx, y + dy)];
+                        if (tile == TileType::Floor) {
+                            tile = TileType::Water;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    // Write back and report only the tiles that actually changed
+    std::vector<TileChange> changes;
+    for (int y = 1; y < gridHeight - 1; ++y) {
+        for (int x = 1; x < gridWidth - 1; ++x) {
+            const int mapX = originX + x;
+            const int mapY = originY + y;
+            const TileType before = map.GetTileUnchecked(mapX, mapY);
+            const TileType after = tiles[at(x, y)];
+            if (before != after) {
+                map.SetTile(mapX, mapY, after);
+                changes.push_back({mapX, mapY, before, after});
+            }
+        }
+    }
+    return changes;
+}
+
 void MapGenerator::SmoothMap(const std::vector<TileType>& tiles, std::vector<TileType>& output,
                               int width, int height, int threshold)
 {
+    // Only interior tiles are smoothed; the wall border is their sentinel ring
     for (int y = 1; y < height - 1; ++y) {
         for (int x = 1; x < width - 1; ++x) {
-            const int wallCount = CountWallNeighbors(tiles, width, height, x, y);
             const size_t idx = static_cast<size_t>(y * width + x);
+            const int wallCount = CountWallNeighbors(tiles.data() + idx, static_cast<size_t>(width));
             
             if (wallCount > threshold) {
                 output[idx] = TileType::Wall;
@@ -90,30 +446,154 @@ void MapGenerator::SmoothMap(const std::vector<TileType>& tiles, std::vector<Til
     }
 }
 
-int MapGenerator::CountWallNeighbors(const std::vector<TileType>& tiles, 
-                                      int width, int height, int x, int y)
+int MapGenerator::CountWallNeighbors(const TileType* center, size_t stride) noexcept
 {
-    int count = 0;
+    const TileType* above = center - stride;
+    const TileType* below = center + stride;
+    return (above[-1] == TileType::Wall) + (above[0] == TileType::Wall) + (above[1] == TileType::Wall) +
+           (center[-1] == TileType::Wall) + (center[1] == TileType::Wall) +
+           (below[-1] == TileType::Wall) + (below[0] == TileType::Wall) + (below[1] == TileType::Wall);
+}
+
+void MapGenerator::ConnectRegions(std::vector<TileType>& tiles, int width, int height,
+                                  Connectivity mode, int minRegionSize)
+{
+    if (mode == Connectivity::Keep || width < 3 || height < 3) {
+        return;
+    }
     
-    for (int dy = -1; dy <= 1; ++dy) {
-        for (int dx = -1; dx <= 1; ++dx) {
-            if (dx == 0 && dy == 0) continue;
-            
-            const int nx = x + dx;
-            const int ny = y + dy;
-            
-            if (nx < 0 || nx >= width || ny < 0 || ny >= height) {
-                count++;  // Out of bounds counts as wall
-            } else {
-                const size_t idx = static_cast<size_t>(ny * width + nx);
-                if (tiles[idx] == TileType::Wall) {
-                    count++;
+    const size_t count = static_cast<size_t>(width) * static_cast<size_t>(height);
+    const auto interior = [width, height](size_t i) {
+        const int x = static_cast<int>(i % static_cast<size_t>(width));
+        const int y = static_cast<int>(i / static_cast<size_t>(width));
+        return x > 0 && x < width - 1 && y > 0 && y < height - 1;
+    };
+    const auto walkable = [&tiles, &interior](size_t i) {
+        return interior(i) && tiles[i] == TileType::Floor;
+    };
+    
+    // Union-find over 4-connected walkable tiles (union by size, path halving)
+    constexpr uint32_t kNone = UINT32_MAX;
+    std::vector<uint32_t> label(count, kNone);
+    std::vector<uint32_t> sizes;
+    const auto find = [&label](uint32_t i) {
+        while (label[i] != i) {
+            label[i] = label[label[i]];
+            i = label[i];
+        }
+        return i;
+    };
+    const auto unite = [&](uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (sizes[a] < sizes[b]) std::swap(a, b);
+        label[b] = a;
+        sizes[a] += sizes[b];
+    };
+    sizes.assign(count, 1);
+    for (size_t i = 0; i < count; ++i) {
+        if (!walkable(i)) continue;
+        label[i] = static_cast<uint32_t>(i);
+        if (walkable(i - 1)) unite(static_cast<uint32_t>(i), static_cast<uint32_t>(i - 1));
+        if (walkable(i - static_cast<size_t>(width))) {
+            unite(static_cast<uint32_t>(i), static_cast<uint32_t>(i - static_cast<size_t>(width)));
+        }
+    }
+    
+    // Dense region ids in row-major order of each region's first tile (roots
+    // are resolved first, since relabelling breaks the parent links)
+    for (size_t i = 0; i < count; ++i) {
+        if (label[i] != kNone) label[i] = find(static_cast<uint32_t>(i));
+    }
+    std::vector<uint32_t> regionSize;
+    std::vector<uint32_t> regionOf(count, kNone);
+    for (size_t i = 0; i < count; ++i) {
+        if (label[i] == kNone) continue;
+        const uint32_t root = label[i];
+        if (regionOf[root] == kNone) {
+            regionOf[root] = static_cast<uint32_t>(regionSize.size());
+            regionSize.push_back(sizes[root]);
+        }
+        label[i] = regionOf[root];
+    }
+    sizes = {};
+    regionOf = {};
+    if (regionSize.size() <= 1) {
+        return;
+    }
+    
+    // Keep the largest region (first on ties); fill the ones that are dropped
+    const uint32_t main = static_cast<uint32_t>(
+        std::max_element(regionSize.begin(), regionSize.end()) - regionSize.begin());
+    const auto dropped = [&](uint32_t region) {
+        return region != main && (mode == Connectivity::FillPockets ||
+                                  regionSize[region] < static_cast<uint32_t>(std::max(minRegionSize, 0)));
+    };
+    for (size_t i = 0; i < count; ++i) {
+        if (label[i] != kNone && dropped(label[i])) {
+            tiles[i] = TileType::Wall;
+            label[i] = kNone;
+        }
+    }
+    if (mode == Connectivity::FillPockets) {
+        return;
+    }
+    
+    // 0-1 BFS from the main region by layers: walkable tiles join the current
+    // layer (cost 0), unwalkable ones the next (cost 1). Every tile is settled
+    // when first reached, so `step` (direction back towards the main region)
+    // is written once, and the first tile reached of each region is its
+    // cheapest exit.
+    constexpr uint8_t kUnvisited = 0xFF;
+    constexpr uint8_t kSource = 4;    // Part of the main region or already joined to it
+    const std::ptrdiff_t offsets[4] = {-1, 1, -static_cast<std::ptrdiff_t>(width), static_cast<std::ptrdiff_t>(width)};
+    std::vector<uint8_t> step(count, kUnvisited);
+    std::vector<uint32_t> exitTile(regionSize.size(), kNone);
+    std::vector<uint32_t> layer;
+    std::vector<uint32_t> nextLayer;
+    for (size_t i = 0; i < count; ++i) {
+        if (label[i] == main) {
+            step[i] = kSource;
+            layer.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    while (!layer.empty()) {
+        for (size_t k = 0; k < layer.size(); ++k) {
+            const size_t tile = layer[k];
+            for (uint8_t d = 0; d < 4; ++d) {
+                const size_t next = static_cast<size_t>(static_cast<std::ptrdiff_t>(tile) + offsets[d]);
+                if (step[next] != kUnvisited || !interior(next)) continue;
+                step[next] = d ^ 1;   // Opposite direction leads back to `tile`
+                if (label[next] == kNone) {
+                    nextLayer.push_back(static_cast<uint32_t>(next));
+                } else {
+                    if (exitTile[label[next]] == kNone) {
+                        exitTile[label[next]] = static_cast<uint32_t>(next);
+                    }
+                    layer.push_back(static_cast<uint32_t>(next));
                 }
             }
         }
+        layer.swap(nextLayer);
+        nextLayer.clear();
     }
     
-    return count;
+    // Walk each region's exit back to the main region, opening unwalkable
+    // tiles. A walk stops at any tile an earlier walk joined, so every tile is
+    // walked at most once.
+    for (uint32_t region = 0; region < regionSize.size(); ++region) {
+        size_t tile = exitTile[region];
+        if (region == main || tile == kNone) continue;
+        while (step[tile] != kSource) {
+            const uint8_t back = step[tile];
+            step[tile] = kSource;
+            if (tiles[tile] != TileType::Floor) {
+                tiles[tile] = TileType::Floor;
+            }
+            tile = static_cast<size_t>(static_cast<std::ptrdiff_t>(tile) + offsets[back]);
+        }
+    }
 }
 
 void MapGenerator::AddWaterPools(std::vector<TileType>& tiles, int width, int height,
@@ -124,22 +604,86 @@ void MapGenerator::AddWaterPools(std::vector<TileType>& tiles, int width, int he
     
     for (int y = 5; y < height - 5; ++y) {
         for (int x = 5; x < width - 5; ++x) {
-            const size_t idx = static_cast<size_t>(y * width + x);
+            const size_t idx = static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
             
             // Only place water on floor tiles with low probability
             if (tiles[idx] == TileType::Floor && dist(rng) < chance) {
-                const int poolSize = sizeDist(rng);
-                
-                // Create a small water pool
-                for (int dy = -poolSize/2; dy <= poolSize/2; ++dy) {
-                    for (int dx = -poolSize/2; dx <= poolSize/2; ++dx) {
-                        // Circular-ish shape
-                        if (dx*dx + dy*dy <= (poolSize/2 + 1) * (poolSize/2 + 1)) {
-                            const size_t pidx = static_cast<size_t>((y + dy) * width + (x + dx));
-                            if (tiles[pidx] == TileType::Floor) {
-                                tiles[pidx] = TileType::Water;
-                            }
-                        }
+                StampPool(tiles, width, x, y, sizeDist(rng));
+            }
+        }
+    }
+}
+
+void MapGenerator::AddWaterPoolsSkipAhead(std::vector<TileType>& tiles, int width, int height,
+                                          float chance, std::mt19937& rng)
+{
+    // Candidate centres are the interior positions [5, width - 5) x [5, height - 5)
+    // in row-major order, each a Bernoulli(chance) trial that counts only if the
+    // tile is still floor. Rather than one draw per position, draw the number
+    // of failures before the next success (geometric) and jump straight to it.
+    // The distribution also requires p > 0; below kMinChance the expected gap
+    // dwarfs any map, so no pool is placed (NaN and negative chances included)
+    constexpr double kMinChance = 1e-12;
+    const int innerWidth = width - 10;
+    const int innerHeight = height - 10;
+    if (innerWidth <= 0 || innerHeight <= 0 || !(chance > kMinChance)) {
+        return;
+    }
+    const int64_t candidates = static_cast<int64_t>(innerWidth) * innerHeight;
+    
+    // (the distribution requires p < 1; a chance of 1 still yields gaps of 0)
+    std::geometric_distribution<int64_t> gapDist(std::min(static_cast<double>(chance), 1.0 - 1e-9));
+    std::uniform_int_distribution<int> sizeDist(2, 5);
+    
+    // Next trial at `from` plus a gap, saturated at the end (gaps may be huge)
+    const auto next = [&](int64_t from) {
+        const int64_t gap = gapDist(rng);
+        return gap >= candidates - from ? candidates : from + gap;
+    };
+    for (int64_t i = next(0); i < candidates; i = next(i + 1)) {
+        const int x = 5 + static_cast<int>(i % innerWidth);
+        const int y = 5 + static_cast<int>(i / innerWidth);
+        if (tiles[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)] == TileType::Floor) {
+            StampPool(tiles, width, x, y, sizeDist(rng));
+        }
+    }
+}
+
+void MapGenerator::AddWaterPoolsHashed(std::span<TileType> tiles, int width, int height, int firstRow,
+                                        int reachFirst, int reachEnd, float chance, uint32_t seed)
+{
+    const uint64_t poolStream = CounterRng::StreamKey(seed, kStageWaterPool);
+    const uint64_t sizeStream = CounterRng::StreamKey(seed, kStageWaterSize);
+    const int endRow = firstRow + static_cast<int>(tiles.size() / static_cast<size_t>(std::max(width, 1)));
+    const auto at = [&](int x, int y) -> TileType& {
+        return tiles[static_cast<size_t>(y - firstRow) * static_cast<size_t>(width) + static_cast<size_t>(x)];
+    };
+    
+    // Centres are picked on the smoothed map before any water exists, and a
+    // pool only turns floor into water, so the pools can be stamped in any order
+    std::vector<std::pair<int, int>> centres;
+    const int centreFirst = std::max({5, reachFirst - kMaxPoolReach, firstRow});
+    const int centreEnd = std::min({height - 5, reachEnd + kMaxPoolReach, endRow});
+    for (int y = centreFirst; y < centreEnd; ++y) {
+        for (int x = 5; x < width - 5; ++x) {
+            if (at(x, y) == TileType::Floor &&
+                CounterRng::ToUnitFloat(CounterRng::Hash(poolStream, x, y)) < chance) {
+                centres.emplace_back(x, y);
+            }
+        }
+    }
+    
+    for (const auto& [x, y] : centres) {
+        const int poolSize = CounterRng::ToRange(CounterRng::Hash(sizeStream, x, y), 2, 5);
+        
+        // Same circular-ish shape as AddWaterPools, clipped to the rows held
+        for (int dy = -poolSize/2; dy <= poolSize/2; ++dy) {
+            if (y + dy < firstRow || y + dy >= endRow) continue;
+            for (int dx = -poolSize/2; dx <= poolSize/2; ++dx) {
+                if (dx*dx + dy*dy <= (poolSize/2 + 1) * (poolSize/2 + 1)) {
+                    TileType& tile = at(x + dx, y + dy);
+                    if (tile == TileType::Floor) {
+                        tile = TileType::Water;
                     }
                 }
             }
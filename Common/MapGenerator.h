@@ -1,11 +1,34 @@
 #pragma once
 
 #include "Map.h"
+#include <cstdint>
+#include <functional>
 #include <random>
+#include <span>
 
 // Random dungeon map generator
 class MapGenerator {
 public:
+    // Bump whenever Generate's output for a given Config changes (invalidates
+    // MapCache and SeededMap payloads)
+    static constexpr unsigned kVersion = 5;
+
+    // Random number scheme; the value is stored with cached and seeded maps,
+    // so existing IDs must never change meaning
+    enum class Algorithm : uint8_t {
+        Sequential = 1,     // One std::mt19937 stream in row-major order (original maps)
+        CounterHash = 2,    // CounterRng keyed by (seed, x, y, stage): order-independent
+        SequentialSkip = 3  // Sequential fill and smoothing, but water pools placed by
+                            // geometric skip-ahead (faster; different water than Sequential)
+    };
+
+    // Optional last stage making every walkable tile reachable from every other
+    enum class Connectivity : uint8_t {
+        Keep = 0,           // Leave isolated regions as generated
+        FillPockets = 1,    // Wall in every region but the largest
+        CarveTunnels = 2    // Wall in regions below minRegionSize, tunnel the rest to the largest
+    };
+
     struct Config {
         int width = 200;
         int height = 200;
@@ -14,6 +37,11 @@ public:
         int wallThreshold = 4;           // Neighbors needed to become wall
         float waterChance = 0.02f;       // Chance of water pools
         unsigned int seed = 0;           // 0 = random seed
+        Algorithm algorithm = Algorithm::CounterHash;
+        Connectivity connectivity = Connectivity::Keep;
+        int minRegionSize = 24;          // CarveTunnels: smaller regions are filled instead
+        unsigned threadCount = 1;        // Threads for the banded stages (0 = all cores);
+                                         // never changes the output
     };
     
     // Generate a random cave-like dungeon
@@ -22,16 +50,94 @@ public:
     // Generate with specific seed (for reproducibility)
     [[nodiscard]] static Map Generate(int width, int height, unsigned int seed);
 
-private:
-    // Cellular automata smoothing pass (double-buffered)
+    // Chunk synthesis for unbounded worlds (see WorldStreamer). A chunk is a
+    // pure function of (config, chunkX, chunkY): the counter-hash scheme is
+    // always used, there are no border walls, and width, height, threadCount
+    // and algorithm are ignored. Seed 0 is used as-is.
+    static constexpr int kChunkSize = ChunkedTileStorage::kChunkSize;
+
+    // Tiles generated around a chunk so smoothing and water pools near its
+    // edges see the same neighbours as the adjacent chunks (seamless edges)
+    [[nodiscard]] static int GetChunkApron(const Config& config) noexcept;
+
+    // World tiles [chunkX * kChunkSize, +kChunkSize) x [chunkY * kChunkSize,
+    // +kChunkSize), row-major
+    [[nodiscard]] static std::vector<TileType> GenerateChunk(const Config& config, int chunkX, int chunkY);
+
+    // Receives rows [firstRow, firstRow + rows.size() / width) of a banded
+    // map; return false to stop generation
+    using BandSink = std::function<bool(int firstRow, std::span<const TileType> rows)>;
+
+    // Generate the map for `config` as consecutive bands of `bandRows` rows
+    // (the last may be shorter), top to bottom, handing each to `sink`.
+    // Tiles match Generate(config) exactly, but only one band plus an apron
+    // of GetChunkApron rows either side is held at a time, so memory does
+    // not grow with the height. Only Algorithm::CounterHash maps without a
+    // connectivity stage can be banded (the mt19937 stream and the region
+    // stages need the whole map); fails for other configs, a non-positive
+    // size or bandRows, or when `sink` returns false. Seed 0 picks a random
+    // seed, as in Generate.
+    [[nodiscard]] static bool GenerateBands(const Config& config, int bandRows, const BandSink& sink);
+
+    // One tile changed by RegenerateArea
+    struct TileChange {
+        int x;
+        int y;
+        TileType before;
+        TileType after;
+    };
+
+    // Re-roll the tiles of `area` in an existing map (clipped to the map's
+    // interior; the outer border stays wall) with config's density, smoothing,
+    // water chance and seed (0 = random). The area is filled with counter-hash
+    // draws keyed by map position, then smoothed with the ring of tiles around
+    // it held fixed as neighbours, so the new caves blend into the old ones;
+    // water pools are centred and clipped inside the area. Work and memory
+    // are proportional to the area, not the map, so width, height, algorithm,
+    // connectivity and threadCount are ignored. Tiles are written with
+    // Map::SetTile (journaled for PublishChanges); the ones that actually
+    // changed are returned in row-major order. Regenerating the whole
+    // interior of a map reproduces Generate(config) for a counter-hash config
+    // of the same size.
+    static std::vector<TileChange> RegenerateArea(Map& map, MapRect area, const Config& config);
+
+    // Scalar cellular automata smoothing pass (double-buffered). Generate runs
+    // the bit-parallel WallBitboard::Smooth instead; this is the reference it
+    // must match tile for tile.
     static void SmoothMap(const std::vector<TileType>& tiles, std::vector<TileType>& output,
                           int width, int height, int threshold);
-    
-    // Count neighboring walls
-    [[nodiscard]] static int CountWallNeighbors(const std::vector<TileType>& tiles, 
-                                                 int width, int height, int x, int y);
-    
-    // Add water pools
-    static void AddWaterPools(std::vector<TileType>& tiles, int width, int height, 
+
+    // Connectivity stage on a generated grid (border tiles are never changed).
+    // Regions are labelled with union-find; tunnels follow one 0-1 BFS from
+    // the largest region, where crossing a non-floor tile costs 1, so each
+    // region gets a tunnel through the fewest such tiles. O(width * height)
+    // overall and deterministic: ties break in row-major order. Only Floor
+    // counts as walkable here, whatever TileTable says, so the output depends
+    // on the Config alone.
+    static void ConnectRegions(std::vector<TileType>& tiles, int width, int height,
+                               Connectivity mode, int minRegionSize);
+
+    // Add water pools (Algorithm::Sequential): each floor tile at least 5 tiles
+    // from the edge seeds a pool with probability `chance`, one draw per tile
+    static void AddWaterPools(std::vector<TileType>& tiles, int width, int height,
                               float chance, std::mt19937& rng);
+
+    // Add water pools (Algorithm::SequentialSkip): the same pool rate, but
+    // draws only one gap and one size per pool, so its cost scales with the
+    // pool count. Consumes `rng` differently, so the pools differ.
+    static void AddWaterPoolsSkipAhead(std::vector<TileType>& tiles, int width, int height,
+                                       float chance, std::mt19937& rng);
+
+private:
+    // Count walls among the 8 neighbours of an interior tile (no bounds checks:
+    // the generator's wall border guarantees every neighbour exists)
+    [[nodiscard]] static int CountWallNeighbors(const TileType* center, size_t stride) noexcept;
+    
+    // Add water pools (Algorithm::CounterHash): pool centres are chosen from the
+    // smoothed floor independently per tile, so the result has no order dependence.
+    // `tiles` holds map rows [firstRow, firstRow + tiles.size() / width) of a
+    // width x height map; every pool that reaches rows [reachFirst, reachEnd)
+    // is stamped, clipped to the rows held.
+    static void AddWaterPoolsHashed(std::span<TileType> tiles, int width, int height, int firstRow,
+                                    int reachFirst, int reachEnd, float chance, uint32_t seed);
 };
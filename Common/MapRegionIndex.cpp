@@ -0,0 +1,165 @@
+#include "MapRegionIndex.h"
+#include "Map.h"
+#include <algorithm>
+
+namespace {
+    constexpr int kDirX[] = {1, -1, 0, 0};
+    constexpr int kDirY[] = {0, 0, 1, -1};
+}
+
+void MapRegionIndex::Build(const Map& map)
+{
+    Clear();
+    m_width = std::max(map.GetWidth(), 0);
+    m_height = std::max(map.GetHeight(), 0);
+    m_labels.assign(static_cast<size_t>(m_width) * static_cast<size_t>(m_height), kNoRegion);
+    m_built = true;
+
+    for (int y = 0; y < m_height; ++y) {
+        for (int x = 0; x < m_width; ++x) {
+            if (m_labels[Index(x, y)] == kNoRegion && map.IsWalkableUnchecked(x, y)) {
+                const RegionId region = NewRegion();
+                m_sizes[region] = static_cast<uint32_t>(Fill(map, x, y, kNoRegion, region));
+            }
+        }
+    }
+}
+
+void MapRegionIndex::Clear() noexcept
+{
+    m_width = 0;
+    m_height = 0;
+    m_built = false;
+    m_labels.clear();
+    m_sizes.clear();
+    m_freeIds.clear();
+    m_regionCount = 0;
+}
+
+MapRegionIndex::RegionId MapRegionIndex::NewRegion()
+{
+    ++m_regionCount;
+    if (!m_freeIds.empty()) {
+        const RegionId region = m_freeIds.back();
+        m_freeIds.pop_back();
+        return region;
+    }
+    if (m_sizes.empty()) {
+        m_sizes.push_back(0);  // Id 0 is kNoRegion
+    }
+    m_sizes.push_back(0);
+    return static_cast<RegionId>(m_sizes.size() - 1);
+}
+
+void MapRegionIndex::FreeRegion(RegionId region)
+{
+    m_sizes[region] = 0;
+    m_freeIds.push_back(region);
+    --m_regionCount;
+}
+
+size_t MapRegionIndex::Fill(const Map& map, int x, int y, RegionId from, RegionId to)
+{
+    const size_t width = static_cast<size_t>(m_width);
+    size_t count = 0;
+    m_stack.clear();
+    m_stack.push_back(Index(x, y));
+    m_labels[Index(x, y)] = to;
+
+    while (!m_stack.empty()) {
+        const size_t index = m_stack.back();
+        m_stack.pop_back();
+        ++count;
+
+        const int cx = static_cast<int>(index % width);
+        const int cy = static_cast<int>(index / width);
+        for (int i = 0; i < 4; ++i) {
+            const int nx = cx + kDirX[i];
+            const int ny = cy + kDirY[i];
+            if (static_cast<unsigned>(nx) >= static_cast<unsigned>(m_width) ||
+                static_cast<unsigned>(ny) >= static_cast<unsigned>(m_height)) {
+                continue;
+            }
+            const size_t next = Index(nx, ny);
+            if (m_labels[next] != from || (from == kNoRegion && !map.IsWalkableUnchecked(nx, ny))) {
+                continue;
+            }
+            m_labels[next] = to;
+            m_stack.push_back(next);
+        }
+    }
+    return count;
+}
+
+void MapRegionIndex::OnBecameWalkable(const Map& map, int x, int y)
+{
+    if (!m_built || GetRegion(x, y) != kNoRegion) {
+        return;
+    }
+
+    // Distinct neighbouring regions; the largest absorbs the others
+    RegionId neighbours[4];
+    int count = 0;
+    for (int i = 0; i < 4; ++i) {
+        const RegionId region = GetRegion(x + kDirX[i], y + kDirY[i]);
+        if (region != kNoRegion && std::find(neighbours, neighbours + count, region) == neighbours + count) {
+            neighbours[count++] = region;
+        }
+    }
+
+    if (count == 0) {
+        const RegionId region = NewRegion();
+        m_labels[Index(x, y)] = region;
+        m_sizes[region] = 1;
+        return;
+    }
+
+    const RegionId target = *std::max_element(neighbours, neighbours + count,
+        [this](RegionId a, RegionId b) { return m_sizes[a] < m_sizes[b]; });
+    m_labels[Index(x, y)] = target;
+    ++m_sizes[target];
+
+    for (int i = 0; i < 4; ++i) {
+        const int nx = x + kDirX[i];
+        const int ny = y + kDirY[i];
+        const RegionId region = GetRegion(nx, ny);
+        if (region != kNoRegion && region != target) {
+            m_sizes[target] += static_cast<uint32_t>(Fill(map, nx, ny, region, target));
+            FreeRegion(region);
+        }
+    }
+}
+
+void MapRegionIndex::OnBecameUnwalkable(const Map& map, int x, int y)
+{
+    const RegionId old = GetRegion(x, y);
+    if (!m_built || old == kNoRegion) {
+        return;
+    }
+    m_labels[Index(x, y)] = kNoRegion;
+    if (--m_sizes[old] == 0) {
+        FreeRegion(old);
+        return;
+    }
+
+    // With a single walkable neighbour the rest of the region stays connected
+    int neighbours = 0;
+    for (int i = 0; i < 4; ++i) {
+        neighbours += GetRegion(x + kDirX[i], y + kDirY[i]) == old;
+    }
+    if (neighbours < 2) {
+        return;
+    }
+
+    // The region may have split: give each remaining piece its own label
+    // (the old id is released last so no piece can reuse it mid-relabel)
+    for (int i = 0; i < 4; ++i) {
+        const int nx = x + kDirX[i];
+        const int ny = y + kDirY[i];
+        if (GetRegion(nx, ny) == old) {
+            const RegionId piece = NewRegion();
+            m_sizes[piece] = static_cast<uint32_t>(Fill(map, nx, ny, old, piece));
+        }
+    }
+    FreeRegion(old);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Map;
+
+// Connected-region labels over walkable tiles
+//
+// Two walkable tiles share a region exactly when a path exists between them.
+// Regions are 4-connected: movement never cuts corners, so every diagonal step
+// implies an orthogonal detour through walkable tiles. Labels are stored per
+// tile, making a region lookup a single read.
+//
+// Labels are kept current incrementally: a tile becoming walkable merges its
+// neighbours' regions (relabelling the smaller ones), and a tile becoming
+// unwalkable relabels its old region only if it may have been split.
+class MapRegionIndex {
+public:
+    using RegionId = uint32_t;
+    static constexpr RegionId kNoRegion = 0;
+
+    MapRegionIndex() = default;
+
+    // Label every walkable tile of `map`
+    void Build(const Map& map);
+
+    // Drop all labels (IsBuilt becomes false)
+    void Clear() noexcept;
+
+    [[nodiscard]] bool IsBuilt() const noexcept { return m_built; }
+
+    // Region of tile (x, y); kNoRegion for unwalkable or out-of-bounds tiles
+    [[nodiscard]] RegionId GetRegion(int x, int y) const noexcept {
+        if (static_cast<unsigned>(x) >= static_cast<unsigned>(m_width) ||
+            static_cast<unsigned>(y) >= static_cast<unsigned>(m_height)) {
+            return kNoRegion;
+        }
+        return m_labels[Index(x, y)];
+    }
+
+    [[nodiscard]] size_t GetRegionCount() const noexcept { return m_regionCount; }
+    [[nodiscard]] size_t GetRegionSize(RegionId region) const noexcept {
+        return region < m_sizes.size() ? m_sizes[region] : 0;
+    }
+
+    // Tile (x, y) of `map` just became walkable / unwalkable
+    void OnBecameWalkable(const Map& map, int x, int y);
+    void OnBecameUnwalkable(const Map& map, int x, int y);
+
+private:
+    [[nodiscard]] size_t Index(int x, int y) const noexcept {
+        return static_cast<size_t>(y) * static_cast<size_t>(m_width) + static_cast<size_t>(x);
+    }
+
+    [[nodiscard]] RegionId NewRegion();
+    void FreeRegion(RegionId region);
+
+    // Relabel the 4-connected tiles labelled `from` around (x, y) as `to`.
+    // With from == kNoRegion it claims unlabelled walkable tiles instead.
+    // Returns the number of tiles relabelled.
+    size_t Fill(const Map& map, int x, int y, RegionId from, RegionId to);
+
+    int m_width{};
+    int m_height{};
+    bool m_built{};
+    std::vector<RegionId> m_labels;   // Per tile, row-major
+    std::vector<uint32_t> m_sizes;    // Tiles per region id, 0 = unused id
+    std::vector<RegionId> m_freeIds;  // Unused ids below m_sizes.size()
+    size_t m_regionCount{};
+    std::vector<size_t> m_stack;      // Flood fill scratch (tile indices)
+};
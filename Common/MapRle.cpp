@@ -0,0 +1,165 @@
+#include "MapRle.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace {
+    constexpr uint8_t kEscapeCode = 3;      // Tile value stored in the next byte
+    constexpr int kInlineLengthBits = 5;
+    constexpr uint64_t kInlineLengthMask = (1u << kInlineLengthBits) - 1;
+    constexpr uint8_t kContinueBit = 0x80;
+}
+
+namespace MapRle {
+
+    void Encoder::Append(std::span<const TileType> tiles)
+    {
+        const TileType* it = tiles.data();
+        const TileType* const end = it + tiles.size();
+        while (it != end) {
+            const TileType tile = *it;
+            const TileType* runEnd = std::find_if(it + 1, end, [tile](TileType t) { return t != tile; });
+            AppendRun(tile, static_cast<uint64_t>(runEnd - it));
+            it = runEnd;
+        }
+    }
+
+    void Encoder::AppendRun(TileType tile, uint64_t count)
+    {
+        if (count == 0) {
+            return;
+        }
+        if (m_runLength > 0 && tile == m_runTile) {
+            m_runLength += count;
+            return;
+        }
+        FlushRun();
+        m_runTile = tile;
+        m_runLength = count;
+    }
+
+    void Encoder::Finish()
+    {
+        FlushRun();
+    }
+
+    void Encoder::FlushRun()
+    {
+        if (m_runLength == 0) {
+            return;
+        }
+
+        const uint8_t tile = static_cast<uint8_t>(m_runTile);
+        const uint8_t code = tile < kEscapeCode ? tile : kEscapeCode;
+        const uint64_t length = m_runLength - 1;
+        uint64_t rest = length >> kInlineLengthBits;
+
+        m_out.push_back(static_cast<uint8_t>(code | ((length & kInlineLengthMask) << 2) |
+                                             (rest != 0 ? kContinueBit : 0)));
+        if (code == kEscapeCode) {
+            m_out.push_back(tile);
+        }
+        if (rest != 0) {
+            while (rest >= 0x80) {
+                m_out.push_back(static_cast<uint8_t>(rest | 0x80));
+                rest >>= 7;
+            }
+            m_out.push_back(static_cast<uint8_t>(rest));
+        }
+
+        m_tileCount += m_runLength;
+        m_runLength = 0;
+    }
+
+    bool Decoder::NextRun() noexcept
+    {
+        if (m_pos >= m_data.size()) {
+            return false;
+        }
+        const uint8_t header = m_data[m_pos++];
+        const uint8_t code = header & 3;
+        if (code == kEscapeCode) {
+            if (m_pos >= m_data.size()) {
+                return false;
+            }
+            m_tile = static_cast<TileType>(m_data[m_pos++]);
+        } else {
+            m_tile = static_cast<TileType>(code);
+        }
+
+        uint64_t length = (header >> 2) & kInlineLengthMask;
+        if (header & kContinueBit) {
+            uint64_t rest = 0;
+            for (int shift = 0;; shift += 7) {
+                // Run lengths never need more than 64 bits
+                if (shift > 64 - kInlineLengthBits - 7 || m_pos >= m_data.size()) {
+                    return false;
+                }
+                const uint8_t byte = m_data[m_pos++];
+                rest |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            length |= rest << kInlineLengthBits;
+        }
+
+        m_pending = length + 1;
+        return true;
+    }
+
+    bool Decoder::Read(std::span<TileType> out) noexcept
+    {
+        TileType* it = out.data();
+        size_t remaining = out.size();
+        while (remaining > 0) {
+            if (m_pending == 0 && !NextRun()) {
+                return false;
+            }
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(m_pending, remaining));
+            std::fill_n(it, count, m_tile);
+            it += count;
+            remaining -= count;
+            m_pending -= count;
+        }
+        return true;
+    }
+
+    std::optional<uint64_t> Decoder::SkipRun() noexcept
+    {
+        if (m_pending == 0 && !NextRun()) {
+            return std::nullopt;
+        }
+        return std::exchange(m_pending, 0);
+    }
+
+    std::optional<uint64_t> CountTiles(std::span<const uint8_t> data) noexcept
+    {
+        Decoder decoder(data);
+        uint64_t total = 0;
+        while (!decoder.AtEnd()) {
+            const std::optional<uint64_t> run = decoder.SkipRun();
+            if (!run || *run > std::numeric_limits<uint64_t>::max() - total) {
+                return std::nullopt;
+            }
+            total += *run;
+        }
+        return total;
+    }
+
+    std::vector<uint8_t> Encode(std::span<const TileType> tiles)
+    {
+        std::vector<uint8_t> bytes;
+        Encoder encoder(bytes);
+        encoder.Append(tiles);
+        encoder.Finish();
+        return bytes;
+    }
+
+    bool Decode(std::span<const uint8_t> data, std::span<TileType> out) noexcept
+    {
+        Decoder decoder(data);
+        return decoder.Read(out) && decoder.AtEnd();
+    }
+
+} // namespace MapRle
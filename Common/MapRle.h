@@ -0,0 +1,90 @@
+#pragma once
+
+#include "TileType.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// Run-length tile encoding for compressed .dmap files and network map transfer
+//
+// A stream is a sequence of runs over the tiles in row-major order; runs may
+// cross row boundaries. Each run starts with a header byte:
+//   bits 0-1  tile code: 0-2 are the tile value itself, 3 means the tile value
+//             follows in the next byte (Water and any other tile above 2)
+//   bits 2-6  low 5 bits of (run length - 1)
+//   bit 7     set if the remaining bits of (run length - 1) follow as an
+//             unsigned LEB128 varint
+// A run of up to 32 Empty/Floor/Wall tiles therefore costs a single byte.
+namespace MapRle {
+
+    // Appends encoded runs to a byte vector. Tiles can be fed in any number of
+    // calls; the caller may drain the output vector between calls to stream it.
+    class Encoder {
+    public:
+        explicit Encoder(std::vector<uint8_t>& out) noexcept : m_out(out) {}
+
+        void Append(TileType tile) {
+            if (m_runLength > 0 && tile == m_runTile) {
+                ++m_runLength;
+                return;
+            }
+            FlushRun();
+            m_runTile = tile;
+            m_runLength = 1;
+        }
+
+        void Append(std::span<const TileType> tiles);
+        void AppendRun(TileType tile, uint64_t count);
+
+        // Emit the pending run (call once after the last tile)
+        void Finish();
+
+        [[nodiscard]] uint64_t GetTileCount() const noexcept { return m_tileCount + m_runLength; }
+
+    private:
+        void FlushRun();
+
+        std::vector<uint8_t>& m_out;
+        TileType m_runTile{TileType::Empty};
+        uint64_t m_runLength{};
+        uint64_t m_tileCount{};   // Tiles already emitted
+    };
+
+    // Reads runs back from an encoded byte range
+    class Decoder {
+    public:
+        explicit Decoder(std::span<const uint8_t> data) noexcept : m_data(data) {}
+
+        // Fill `out` with the next out.size() tiles (runs may be split across
+        // calls). Returns false if the stream is malformed or ends early.
+        [[nodiscard]] bool Read(std::span<TileType> out) noexcept;
+
+        // Skip the rest of the current run, or the next whole run if none is
+        // pending, without writing tiles. Returns the tiles skipped.
+        [[nodiscard]] std::optional<uint64_t> SkipRun() noexcept;
+
+        // True once every byte has been consumed and no partial run is pending
+        [[nodiscard]] bool AtEnd() const noexcept { return m_pending == 0 && m_pos == m_data.size(); }
+
+    private:
+        [[nodiscard]] bool NextRun() noexcept;
+
+        std::span<const uint8_t> m_data;
+        size_t m_pos{};
+        TileType m_tile{TileType::Empty};
+        uint64_t m_pending{};     // Tiles left in the current run
+    };
+
+    // Whole-buffer helpers
+    [[nodiscard]] std::vector<uint8_t> Encode(std::span<const TileType> tiles);
+
+    // Total tiles in a stream without decoding it (nullopt if malformed).
+    // Lets callers check a claimed size before allocating for it.
+    [[nodiscard]] std::optional<uint64_t> CountTiles(std::span<const uint8_t> data) noexcept;
+
+    // Decode exactly out.size() tiles; fails if the stream has more or fewer
+    [[nodiscard]] bool Decode(std::span<const uint8_t> data, std::span<TileType> out) noexcept;
+
+} // namespace MapRle
@@ -0,0 +1,127 @@
+#include "MapStreamWriter.h"
+#include "MapFileFormat.h"
+#include "MapTextFormat.h"
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+    constexpr size_t kFlushBytes = size_t{1} << 20;
+}
+
+bool MapStreamWriter::Open(std::string_view filename, std::string_view name, int width, int height,
+                           MapFileFormat format)
+{
+    if (width < 0 || height < 0) {
+        return false;
+    }
+    m_file.open(std::string(filename), std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        return false;
+    }
+
+    m_format = format;
+    m_width = width;
+    m_height = height;
+    m_rowsWritten = 0;
+    m_failed = false;
+    m_text.clear();
+    m_encoded.clear();
+    m_encoder.emplace(m_encoded);
+    m_encodedBytes = 0;
+
+    if (format == MapFileFormat::Text) {
+        const std::string header = MapTextFormat::FormatHeader(name, width, height);
+        m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        m_text.reserve(kFlushBytes + MapTextFormat::MaxRowBytes(width));
+    } else {
+        // The compressed size is patched in by Finish
+        const uint16_t tileFormat = format == MapFileFormat::Compressed ? DmapFormat::kTileFormatRle
+                                                                        : DmapFormat::kTileFormat;
+        DmapFormat::WriteHeader(m_file, DmapFormat::MakeHeader(tileFormat, width, height,
+            static_cast<uint64_t>(width) * static_cast<uint64_t>(height), name));
+    }
+    return m_file.good();
+}
+
+bool MapStreamWriter::WriteRows(std::span<const TileType> tiles)
+{
+    if (m_failed || !m_file.is_open()) {
+        return false;
+    }
+    if (tiles.empty()) {
+        return true;
+    }
+    const size_t width = static_cast<size_t>(m_width);
+    const size_t remaining = static_cast<size_t>(m_height - m_rowsWritten);
+    if (width == 0 || tiles.size() % width != 0 || tiles.size() / width > remaining) {
+        m_failed = true;
+        return false;
+    }
+
+    switch (m_format) {
+        case MapFileFormat::Binary:
+            m_file.write(reinterpret_cast<const char*>(tiles.data()), static_cast<std::streamsize>(tiles.size()));
+            break;
+        case MapFileFormat::Compressed:
+            m_encoder->Append(tiles);
+            if (m_encoded.size() >= kFlushBytes) {
+                Flush();
+            }
+            break;
+        case MapFileFormat::Text: {
+            // Rows are formatted into one large buffer that is flushed when nearly full
+            const size_t rowBytes = MapTextFormat::MaxRowBytes(m_width);
+            for (size_t offset = 0; offset < tiles.size(); offset += width) {
+                const size_t used = m_text.size();
+                m_text.resize(used + rowBytes);
+                char* end = MapTextFormat::FormatRow(tiles.data() + offset, m_width, m_text.data() + used);
+                m_text.resize(static_cast<size_t>(end - m_text.data()));
+                if (m_text.size() >= kFlushBytes) {
+                    Flush();
+                }
+            }
+            break;
+        }
+    }
+
+    m_rowsWritten += static_cast<int>(tiles.size() / width);
+    if (!m_file.good()) {
+        m_failed = true;
+    }
+    return !m_failed;
+}
+
+void MapStreamWriter::Flush()
+{
+    if (!m_text.empty()) {
+        m_file.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+        m_text.clear();
+    }
+    if (!m_encoded.empty()) {
+        m_file.write(reinterpret_cast<const char*>(m_encoded.data()), static_cast<std::streamsize>(m_encoded.size()));
+        m_encodedBytes += m_encoded.size();
+        m_encoded.clear();
+    }
+}
+
+bool MapStreamWriter::Finish()
+{
+    if (m_failed || !m_file.is_open() || m_rowsWritten != m_height) {
+        m_file.close();
+        return false;
+    }
+
+    if (m_format == MapFileFormat::Compressed) {
+        m_encoder->Finish();
+    }
+    Flush();
+
+    // The compressed size is only known now; the other header fields stand
+    if (m_format == MapFileFormat::Compressed) {
+        DmapFormat::PatchDataSize(m_file, m_encodedBytes);
+    }
+
+    const bool ok = m_file.good();
+    m_file.close();
+    return ok && !m_file.fail();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Map.h"
+#include "MapRle.h"
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes a map file in any MapFileFormat one band of rows at a time
+//
+// Rows go to disk as they arrive (through a 1 MiB buffer), so a map never
+// has to exist in memory as a whole; MapGenerator::GenerateBands feeds it
+// directly. The files are byte-identical to Map::SaveToFile's. Compressed
+// .dmap files get their final data size patched into the header by Finish.
+class MapStreamWriter {
+public:
+    MapStreamWriter() = default;
+    MapStreamWriter(const MapStreamWriter&) = delete;
+    MapStreamWriter& operator=(const MapStreamWriter&) = delete;
+
+    // Create the file and write its header
+    [[nodiscard]] bool Open(std::string_view filename, std::string_view name, int width, int height,
+                            MapFileFormat format);
+
+    // Append whole rows (row-major, a multiple of width tiles), top to bottom
+    [[nodiscard]] bool WriteRows(std::span<const TileType> tiles);
+
+    // Flush everything; fails unless exactly width * height tiles were written
+    [[nodiscard]] bool Finish();
+
+    [[nodiscard]] int GetRowsWritten() const noexcept { return m_rowsWritten; }
+
+private:
+    void Flush();
+
+    std::ofstream m_file;
+    MapFileFormat m_format{MapFileFormat::Text};
+    int m_width{};
+    int m_height{};
+    int m_rowsWritten{};
+    bool m_failed{};
+    std::vector<char> m_text{};          // Text: formatted rows awaiting a write
+    std::vector<uint8_t> m_encoded{};    // Compressed: encoded runs awaiting a write
+    std::optional<MapRle::Encoder> m_encoder{};
+    uint64_t m_encodedBytes{};           // Compressed bytes already written
+};
@@ -0,0 +1,344 @@
+#include "MapTextFormat.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <system_error>
+
+const char* ToString(MapLoadError::Code code) noexcept
+{
+    switch (code) {
+        case MapLoadError::Code::None:              return "no error";
+        case MapLoadError::Code::OpenFailed:        return "cannot open file";
+        case MapLoadError::Code::InvalidBinary:     return "invalid binary map";
+        case MapLoadError::Code::MissingHeader:     return "missing header field";
+        case MapLoadError::Code::InvalidNumber:     return "invalid number";
+        case MapLoadError::Code::InvalidDimensions: return "invalid dimensions";
+        case MapLoadError::Code::InvalidTile:       return "tile value out of range";
+        case MapLoadError::Code::ShortRow:          return "row has too few tiles";
+        case MapLoadError::Code::LongRow:           return "row has too many tiles";
+        case MapLoadError::Code::MissingRows:       return "file ends before all rows";
+    }
+    return "unknown error";
+}
+
+namespace {
+
+    // Forward-only scanner over the file buffer that tracks line/column
+    class Scanner {
+    public:
+        explicit Scanner(std::string_view text, int firstLine = 1) noexcept
+            : m_pos(text.data()), m_end(text.data() + text.size()), m_lineStart(m_pos), m_line(firstLine) {}
+
+        [[nodiscard]] bool AtEnd() const noexcept { return m_pos == m_end; }
+        [[nodiscard]] bool AtLineEnd() const noexcept {
+            return m_pos == m_end || *m_pos == '\n' || *m_pos == '\r';
+        }
+        [[nodiscard]] const char* Pos() const noexcept { return m_pos; }
+        [[nodiscard]] const char* End() const noexcept { return m_end; }
+        [[nodiscard]] size_t Remaining() const noexcept { return static_cast<size_t>(m_end - m_pos); }
+        [[nodiscard]] int Line() const noexcept { return m_line; }
+
+        void Advance(const char* to) noexcept { m_pos = to; }
+
+        void SkipBlanks() noexcept {
+            while (m_pos != m_end && (*m_pos == ' ' || *m_pos == '\t')) ++m_pos;
+        }
+
+        // Rest of the current line without its terminator; moves to the next line
+        [[nodiscard]] std::string_view TakeLine() noexcept {
+            const char* begin = m_pos;
+            const void* newline = std::memchr(m_pos, '\n', Remaining());
+            const char* end = newline ? static_cast<const char*>(newline) : m_end;
+            m_pos = end;
+            NextLine();
+            if (end != begin && end[-1] == '\r') --end;
+            return {begin, static_cast<size_t>(end - begin)};
+        }
+
+        // Consume an optional "\r\n" or "\n"
+        void NextLine() noexcept {
+            if (m_pos != m_end && *m_pos == '\r') ++m_pos;
+            if (m_pos != m_end && *m_pos == '\n') ++m_pos;
+            ++m_line;
+            m_lineStart = m_pos;
+        }
+
+        [[nodiscard]] MapLoadError Error(MapLoadError::Code code) const noexcept {
+            return {code, m_line, static_cast<int>(m_pos - m_lineStart) + 1};
+        }
+
+    private:
+        const char* m_pos;
+        const char* m_end;
+        const char* m_lineStart;
+        int m_line;
+    };
+
+    [[nodiscard]] bool ParseInt(std::string_view text, int& value) noexcept {
+        const char* end = text.data() + text.size();
+        const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+        return ec == std::errc{} && ptr == end;
+    }
+
+    // Decimal text of every tile value, so formatting is a table lookup
+    struct TileDigits {
+        char text[3];
+        uint8_t length;
+    };
+
+    constexpr std::array<TileDigits, 256> MakeTileDigits() noexcept {
+        std::array<TileDigits, 256> table{};
+        for (int value = 0; value < 256; ++value) {
+            TileDigits& digits = table[static_cast<size_t>(value)];
+            if (value >= 100) {
+                digits = {{static_cast<char>('0' + value / 100),
+                           static_cast<char>('0' + value / 10 % 10),
+                           static_cast<char>('0' + value % 10)}, 3};
+            } else if (value >= 10) {
+                digits = {{static_cast<char>('0' + value / 10),
+                           static_cast<char>('0' + value % 10), 0}, 2};
+            } else {
+                digits = {{static_cast<char>('0' + value), 0, 0}, 1};
+            }
+        }
+        return table;
+    }
+
+    constexpr std::array<TileDigits, 256> kTileDigits = MakeTileDigits();
+
+    // Header: key=value lines up to and including "data="
+    [[nodiscard]] bool ParseHeader(Scanner& scan, MapTextFormat::ParsedMap& out, MapLoadError& error)
+    {
+        bool hasWidth = false;
+        bool hasHeight = false;
+        bool hasData = false;
+        while (!scan.AtEnd() && !hasData) {
+            const int line = scan.Line();
+            const std::string_view entry = scan.TakeLine();
+            const size_t eq = entry.find('=');
+            if (eq == std::string_view::npos) {
+                error = {MapLoadError::Code::MissingHeader, line, 1};
+                return false;
+            }
+
+            const std::string_view key = entry.substr(0, eq);
+            const std::string_view value = entry.substr(eq + 1);
+            const int valueColumn = static_cast<int>(eq) + 2;
+            if (key == "name") {
+                out.name.assign(value);
+            } else if (key == "width" || key == "height") {
+                int number = 0;
+                if (!ParseInt(value, number)) {
+                    error = {MapLoadError::Code::InvalidNumber, line, valueColumn};
+                    return false;
+                }
+                if (number < 0) {
+                    error = {MapLoadError::Code::InvalidDimensions, line, valueColumn};
+                    return false;
+                }
+                (key == "width" ? out.width : out.height) = number;
+                (key == "width" ? hasWidth : hasHeight) = true;
+            } else if (key == "data") {
+                hasData = true;
+            }
+            // Unknown keys are ignored so newer files still load
+        }
+
+        if (!hasWidth || !hasHeight || !hasData) {
+            error = scan.Error(MapLoadError::Code::MissingHeader);
+            return false;
+        }
+
+        // Every tile needs at least one byte; reject before allocating
+        const size_t tileCount = static_cast<size_t>(out.width) * static_cast<size_t>(out.height);
+        if (tileCount > scan.Remaining()) {
+            error = scan.Error(MapLoadError::Code::MissingRows);
+            return false;
+        }
+        return true;
+    }
+
+    // Parse `rows` rows of `width` tiles into `tile`
+    [[nodiscard]] bool ParseRows(Scanner& scan, TileType* tile, int width, int rows, MapLoadError& error)
+    {
+        for (int y = 0; y < rows; ++y) {
+            if (scan.AtEnd()) {
+                error = scan.Error(MapLoadError::Code::MissingRows);
+                return false;
+            }
+
+            int x = 0;
+            scan.SkipBlanks();
+            while (!scan.AtLineEnd()) {
+                if (x == width) {
+                    error = scan.Error(MapLoadError::Code::LongRow);
+                    return false;
+                }
+
+                int value = 0;
+                const auto [ptr, ec] = std::from_chars(scan.Pos(), scan.End(), value);
+                if (ec == std::errc::invalid_argument) {
+                    error = scan.Error(MapLoadError::Code::InvalidNumber);
+                    return false;
+                }
+                if (ec == std::errc::result_out_of_range || value < 0 || value > 255) {
+                    error = scan.Error(MapLoadError::Code::InvalidTile);
+                    return false;
+                }
+                scan.Advance(ptr);
+                *tile++ = static_cast<TileType>(value);
+                ++x;
+
+                scan.SkipBlanks();
+                if (scan.AtLineEnd()) break;
+                if (*scan.Pos() != ',') {
+                    error = scan.Error(MapLoadError::Code::InvalidNumber);
+                    return false;
+                }
+                scan.Advance(scan.Pos() + 1);  // A trailing comma is tolerated
+                scan.SkipBlanks();
+            }
+
+            if (x < width) {
+                error = scan.Error(MapLoadError::Code::ShortRow);
+                return false;
+            }
+            scan.NextLine();
+        }
+        return true;
+    }
+
+    // Parse the tile rows on several threads. The data block is cut into byte
+    // bands at line starts; a first pass counts each band's lines so every band
+    // knows its first row, then each band parses straight into its tile slice.
+    [[nodiscard]] bool ParseRowsParallel(std::string_view data, int firstLine, TileType* tiles,
+                                         int width, int height, unsigned bands, MapLoadError& error)
+    {
+        const char* const begin = data.data();
+        const char* const end = begin + data.size();
+
+        std::vector<const char*> cuts(bands + 1, end);
+        cuts[0] = begin;
+        for (unsigned b = 1; b < bands; ++b) {
+            const Parallel::Range range = Parallel::BandRange(data.size(), b, bands);
+            const char* cut = std::max(begin + range.begin, cuts[b - 1]);
+            const void* newline = std::memchr(cut, '\n', static_cast<size_t>(end - cut));
+            cuts[b] = newline ? static_cast<const char*>(newline) + 1 : end;
+        }
+
+        // Pass 1: lines per band (a final line without '\n' still counts)
+        std::vector<int> lineCounts(bands, 0);
+        Parallel::ForEachBand(bands, [&](unsigned b) {
+            lineCounts[b] = static_cast<int>(std::count(cuts[b], cuts[b + 1], '\n'));
+            if (b == bands - 1 && cuts[b] != end && end[-1] != '\n') {
+                ++lineCounts[b];
+            }
+        });
+
+        std::vector<int> firstRows(bands, 0);
+        for (unsigned b = 1; b < bands; ++b) {
+            firstRows[b] = firstRows[b - 1] + lineCounts[b - 1];
+        }
+        const int totalLines = firstRows[bands - 1] + lineCounts[bands - 1];
+
+        // Pass 2: parse; lines past `height` are ignored like the serial parser does
+        std::vector<MapLoadError> errors(bands);
+        Parallel::ForEachBand(bands, [&](unsigned b) {
+            const int rows = std::min(lineCounts[b], height - firstRows[b]);
+            if (rows <= 0) return;
+            Scanner scan({cuts[b], static_cast<size_t>(cuts[b + 1] - cuts[b])}, firstLine + firstRows[b]);
+            TileType* out = tiles + static_cast<size_t>(firstRows[b]) * static_cast<size_t>(width);
+            (void)ParseRows(scan, out, width, rows, errors[b]);
+        });
+
+        // Report the earliest error, as a serial parse would
+        for (const MapLoadError& bandError : errors) {
+            if (!bandError.IsOk()) {
+                error = bandError;
+                return false;
+            }
+        }
+        if (totalLines < height) {
+            error = {MapLoadError::Code::MissingRows, firstLine + totalLines, 1};
+            return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] double MillisecondsSince(std::chrono::steady_clock::time_point start) noexcept
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+} // namespace
+
+namespace MapTextFormat {
+
+    bool Parse(std::string_view text, ParsedMap& out, MapLoadError& error,
+               unsigned threadCount, MapLoadTimings* timings)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Scanner scan(text);
+        error = {};
+
+        if (!ParseHeader(scan, out, error)) {
+            return false;
+        }
+
+        const int width = out.width;
+        const int height = out.height;
+        out.tiles.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+        const auto tilesStart = std::chrono::steady_clock::now();
+
+        // Bands smaller than a few rows cost more in thread start-up than they save
+        constexpr int kMinRowsPerBand = 64;
+        const unsigned bands = std::min(Parallel::ResolveThreadCount(threadCount),
+                                        static_cast<unsigned>(std::max(1, height / kMinRowsPerBand)));
+
+        bool ok = false;
+        if (bands <= 1) {
+            ok = ParseRows(scan, out.tiles.data(), width, height, error);
+        } else {
+            const std::string_view data(scan.Pos(), scan.Remaining());
+            ok = ParseRowsParallel(data, scan.Line(), out.tiles.data(), width, height, bands, error);
+        }
+
+        if (timings) {
+            timings->headerMs = std::chrono::duration<double, std::milli>(tilesStart - start).count();
+            timings->tilesMs = MillisecondsSince(tilesStart);
+            timings->threads = std::max(bands, 1u);
+        }
+        return ok;
+    }
+
+    char* FormatRow(const TileType* tiles, int width, char* out) noexcept
+    {
+        for (int x = 0; x < width; ++x) {
+            const TileDigits& digits = kTileDigits[static_cast<uint8_t>(tiles[x])];
+            // Copying all three bytes is branch-free; the extra bytes are overwritten
+            std::memcpy(out, digits.text, sizeof(digits.text));
+            out += digits.length;
+            *out++ = ',';
+        }
+        if (width > 0) {
+            --out;  // No comma after the last tile
+        }
+        *out++ = '\n';
+        return out;
+    }
+
+    std::string FormatHeader(std::string_view name, int width, int height)
+    {
+        std::string header;
+        header.reserve(name.size() + 48);
+        header.append("name=").append(name);
+        header.append("\nwidth=").append(std::to_string(width));
+        header.append("\nheight=").append(std::to_string(height));
+        header.append("\ndata=\n");
+        return header;
+    }
+
+} // namespace MapTextFormat
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "TileType.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Why a map failed to load
+struct MapLoadError {
+    enum class Code : uint8_t {
+        None,
+        OpenFailed,         // File missing, empty or unreadable
+        InvalidBinary,      // .dmap header or size mismatch
+        MissingHeader,      // name/width/height/data= block incomplete
+        InvalidNumber,      // Token is not a decimal integer
+        InvalidDimensions,  // Negative width or height
+        InvalidTile,        // Tile value outside 0-255
+        ShortRow,           // Row has fewer than `width` tiles
+        LongRow,            // Row has more than `width` tiles
+        MissingRows         // File ends before `height` rows
+    };
+
+    Code code{Code::None};
+    int line{};     // 1-based, 0 if not tied to a line
+    int column{};   // 1-based byte column, 0 if not tied to a column
+
+    [[nodiscard]] bool IsOk() const noexcept { return code == Code::None; }
+};
+
+// Short human-readable description of an error code
+[[nodiscard]] const char* ToString(MapLoadError::Code code) noexcept;
+
+// Where the time went during a map load
+struct MapLoadTimings {
+    double openMs{};      // Opening and mapping the file
+    double headerMs{};    // Header parsing
+    double tilesMs{};     // Tile parsing or decoding
+    double totalMs{};
+    unsigned threads{1};  // Threads that parsed tiles
+};
+
+struct MapLoadOptions {
+    unsigned threadCount{1};             // Text maps: parse row bands on this many threads (0 = all cores)
+    MapLoadTimings* timings{nullptr};    // Receives a timing breakdown if set
+};
+
+// Text map format (.map / .txt):
+//   name=<name>
+//   width=<n>
+//   height=<n>
+//   data=
+//   <width comma-separated tile values>   x height rows
+namespace MapTextFormat {
+
+    struct ParsedMap {
+        std::string name;
+        int width{};
+        int height{};
+        std::vector<TileType> tiles;
+    };
+
+    // Parse a whole file held in memory. Tiles are decoded with std::from_chars
+    // straight from the buffer; the only allocation is the tile vector.
+    // With threadCount != 1 the rows are split into bands at line boundaries and
+    // parsed in parallel, each band writing its own slice of out.tiles. Results
+    // and errors are identical to a serial parse.
+    [[nodiscard]] bool Parse(std::string_view text, ParsedMap& out, MapLoadError& error,
+                             unsigned threadCount = 1, MapLoadTimings* timings = nullptr);
+
+    // Longest formatted row: up to 3 digits plus a comma per tile, then '\n'
+    [[nodiscard]] constexpr size_t MaxRowBytes(int width) noexcept {
+        return static_cast<size_t>(width > 0 ? width : 0) * 4 + 1;
+    }
+
+    // Format one row at `out` (at least MaxRowBytes(width) bytes) and return
+    // the end of the written bytes
+    [[nodiscard]] char* FormatRow(const TileType* tiles, int width, char* out) noexcept;
+
+    // Format the header block (name, width, height, data=)
+    [[nodiscard]] std::string FormatHeader(std::string_view name, int width, int height);
+
+} // namespace MapTextFormat
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Memory-mapped view of a file (RAII)
+// The view is private copy-on-write: writes through Data() are visible to this
+// process only and never reach the file on disk.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Non-copyable (owns OS handles)
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Movable
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map a whole file; fails for missing or empty files
+    [[nodiscard]] bool Open(std::string_view filename);
+
+    // Unmap and release handles
+    void Close() noexcept;
+
+    [[nodiscard]] bool IsOpen() const noexcept { return m_data != nullptr; }
+    [[nodiscard]] uint8_t* Data() noexcept { return m_data; }
+    [[nodiscard]] const uint8_t* Data() const noexcept { return m_data; }
+    [[nodiscard]] size_t Size() const noexcept { return m_size; }
+
+private:
+    uint8_t* m_data{};
+    size_t m_size{};
+#ifdef _WIN32
+    void* m_fileHandle{};
+    void* m_mappingHandle{};
+#else
+    int m_fd{-1};
+#endif
+};
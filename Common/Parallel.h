@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Minimal fork-join helpers for data-parallel loops
+namespace Parallel {
+
+    // Threads to use for a requested count (0 = one per hardware thread)
+    [[nodiscard]] inline unsigned ResolveThreadCount(unsigned requested) noexcept {
+        if (requested != 0) {
+            return requested;
+        }
+        const unsigned hardware = std::thread::hardware_concurrency();
+        return hardware != 0 ? hardware : 1;
+    }
+
+    // Half-open index range
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    // Band `band` of `bandCount` near-equal contiguous bands covering [0, count)
+    [[nodiscard]] constexpr Range BandRange(size_t count, unsigned band, unsigned bandCount) noexcept {
+        return {count * band / bandCount, count * (band + 1) / bandCount};
+    }
+
+    // Call fn(band) for every band in [0, bandCount), each on its own thread.
+    // The calling thread runs band 0; returns once every band has finished.
+    template<typename Fn>
+    void ForEachBand(unsigned bandCount, Fn&& fn) {
+        if (bandCount <= 1) {
+            fn(0u);
+            return;
+        }
+
+        std::vector<std::jthread> workers;
+        workers.reserve(bandCount - 1);
+        for (unsigned band = 1; band < bandCount; ++band) {
+            workers.emplace_back([&fn, band] { fn(band); });
+        }
+        fn(0u);
+    }   // jthread joins on destruction
+
+} // namespace Parallel
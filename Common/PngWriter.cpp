@@ -0,0 +1,223 @@
+#include "PngWriter.h"
+#include <algorithm>
+#include <array>
+
+namespace PngWriter {
+
+    namespace {
+        class BitWriter {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& out) noexcept : m_out(out) {}
+
+            void Put(uint32_t value, int count)
+            {
+                m_bits |= value << m_count;
+                m_count += count;
+                while (m_count >= 8) {
+                    m_out.push_back(static_cast<uint8_t>(m_bits));
+                    m_bits >>= 8;
+                    m_count -= 8;
+                }
+            }
+
+            // Huffman codes are packed most significant bit first
+            void PutCode(uint32_t code, int count)
+            {
+                uint32_t reversed = 0;
+                for (int i = 0; i < count; ++i) {
+                    reversed = (reversed << 1) | ((code >> i) & 1u);
+                }
+                Put(reversed, count);
+            }
+
+            void Flush()
+            {
+                if (m_count > 0) {
+                    m_out.push_back(static_cast<uint8_t>(m_bits));
+                }
+                m_bits = 0;
+                m_count = 0;
+            }
+
+        private:
+            std::vector<uint8_t>& m_out;
+            uint32_t m_bits{};
+            int m_count{};
+        };
+
+        void PutLiteralOrLength(BitWriter& bits, int symbol)
+        {
+            if (symbol < 144)      bits.PutCode(static_cast<uint32_t>(0x30 + symbol), 8);
+            else if (symbol < 256) bits.PutCode(static_cast<uint32_t>(0x190 + symbol - 144), 9);
+            else if (symbol < 280) bits.PutCode(static_cast<uint32_t>(symbol - 256), 7);
+            else                   bits.PutCode(static_cast<uint32_t>(0xC0 + symbol - 280), 8);
+        }
+
+        void PutMatch(BitWriter& bits, int length, int distance)
+        {
+            static constexpr int kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+            static constexpr int kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                     3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+            static constexpr int kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                      257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                                      8193, 12289, 16385, 24577};
+            static constexpr int kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                       7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+            int code = 28;
+            while (kLengthBase[code] > length) --code;
+            PutLiteralOrLength(bits, 257 + code);
+            bits.Put(static_cast<uint32_t>(length - kLengthBase[code]), kLengthExtra[code]);
+
+            code = 29;
+            while (kDistanceBase[code] > distance) --code;
+            bits.PutCode(static_cast<uint32_t>(code), 5);
+            bits.Put(static_cast<uint32_t>(distance - kDistanceBase[code]), kDistanceExtra[code]);
+        }
+
+        void PutBigEndian(std::vector<uint8_t>& out, uint32_t value)
+        {
+            for (int shift = 24; shift >= 0; shift -= 8) {
+                out.push_back(static_cast<uint8_t>(value >> shift));
+            }
+        }
+
+        void PutChunk(std::vector<uint8_t>& png, const char type[4], const std::vector<uint8_t>& data)
+        {
+            PutBigEndian(png, static_cast<uint32_t>(data.size()));
+            const size_t start = png.size();
+            png.insert(png.end(), type, type + 4);
+            png.insert(png.end(), data.begin(), data.end());
+            PutBigEndian(png, Crc32(std::span(png).subspan(start)));
+        }
+    }
+
+    uint32_t Crc32(std::span<const uint8_t> data, uint32_t crc)
+    {
+        static const auto table = [] {
+            std::array<uint32_t, 256> entries{};
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+            return entries;
+        }();
+        crc = ~crc;
+        for (const uint8_t byte : data) {
+            crc = table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    uint32_t Adler32(std::span<const uint8_t> data)
+    {
+        uint32_t a = 1, b = 0;
+        for (const uint8_t byte : data) {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    std::vector<uint8_t> ZlibCompress(std::span<const uint8_t> data)
+    {
+        constexpr int kWindow = 32768;
+        constexpr int kMinMatch = 3;
+        constexpr int kMaxMatch = 258;
+        constexpr int kHashBits = 15;
+        constexpr int kMaxChain = 16;
+        constexpr int kNiceLength = 64;   // Long enough: stop searching (as zlib's nice_length)
+
+        std::vector<uint8_t> out = {0x78, 0x01};
+        BitWriter bits(out);
+        bits.Put(1, 1);   // Final block
+        bits.Put(1, 2);   // Fixed Huffman codes
+
+        const int64_t size = static_cast<int64_t>(data.size());
+        std::vector<int64_t> head(size_t{1} << kHashBits, -1);
+        std::vector<int64_t> previous(kWindow, -1);
+        const auto hash = [&](int64_t i) {
+            const uint32_t key = static_cast<uint32_t>(data[static_cast<size_t>(i)]) |
+                                 static_cast<uint32_t>(data[static_cast<size_t>(i + 1)]) << 8 |
+                                 static_cast<uint32_t>(data[static_cast<size_t>(i + 2)]) << 16;
+            return (key * 2654435761u) >> (32 - kHashBits);
+        };
+        const auto insert = [&](int64_t i) {
+            if (i + kMinMatch > size) return;
+            const uint32_t h = hash(i);
+            previous[static_cast<size_t>(i % kWindow)] = head[h];
+            head[h] = i;
+        };
+
+        for (int64_t i = 0; i < size;) {
+            int bestLength = 0;
+            int64_t bestDistance = 0;
+            if (i + kMinMatch <= size) {
+                const int limit = static_cast<int>(std::min<int64_t>(kMaxMatch, size - i));
+                int64_t candidate = head[hash(i)];
+                for (int chain = 0; chain < kMaxChain && candidate >= 0 && i - candidate <= kWindow; ++chain) {
+                    int length = 0;
+                    while (length < limit && data[static_cast<size_t>(candidate + length)] ==
+                                             data[static_cast<size_t>(i + length)]) {
+                        ++length;
+                    }
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = i - candidate;
+                        if (length >= std::min(limit, kNiceLength)) break;
+                    }
+                    const int64_t next = previous[static_cast<size_t>(candidate % kWindow)];
+                    if (next >= candidate) break;
+                    candidate = next;
+                }
+            }
+
+            if (bestLength >= kMinMatch) {
+                PutMatch(bits, bestLength, static_cast<int>(bestDistance));
+                for (int k = 0; k < bestLength; ++k) {
+                    insert(i + k);
+                }
+                i += bestLength;
+            } else {
+                PutLiteralOrLength(bits, data[static_cast<size_t>(i)]);
+                insert(i);
+                ++i;
+            }
+        }
+        PutLiteralOrLength(bits, 256);   // End of block
+        bits.Flush();
+
+        const uint32_t adler = Adler32(data);
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<uint8_t>(adler >> shift));
+        }
+        return out;
+    }
+
+    std::vector<uint8_t> EncodeRgb(int width, int height, std::span<const uint8_t> rgb)
+    {
+        // Scanlines with filter type 0 (none); repeats are left to LZ77
+        const size_t stride = static_cast<size_t>(width) * 3;
+        std::vector<uint8_t> raw;
+        raw.reserve((stride + 1) * static_cast<size_t>(height));
+        for (int y = 0; y < height; ++y) {
+            raw.push_back(0);
+            const auto row = rgb.begin() + static_cast<std::ptrdiff_t>(static_cast<size_t>(y) * stride);
+            raw.insert(raw.end(), row, row + static_cast<std::ptrdiff_t>(stride));
+        }
+
+        std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        std::vector<uint8_t> header;
+        PutBigEndian(header, static_cast<uint32_t>(width));
+        PutBigEndian(header, static_cast<uint32_t>(height));
+        header.insert(header.end(), {8, 2, 0, 0, 0});   // 8-bit RGB, no interlace
+        PutChunk(png, "IHDR", header);
+        PutChunk(png, "IDAT", ZlibCompress(raw));
+        PutChunk(png, "IEND", {});
+        return png;
+    }
+
+} // namespace PngWriter
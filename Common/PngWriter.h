@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Minimal PNG encoder for map overview images (no zlib dependency)
+//
+// Pixels go into one zlib stream holding a single fixed-Huffman deflate
+// block with LZ77 matches: far from zlib's ratio on photos, but map images
+// are long runs of a few colors, which LZ77 alone compresses well.
+namespace PngWriter {
+
+    // CRC-32 as used by PNG chunks and zip (pass the previous result to continue)
+    [[nodiscard]] uint32_t Crc32(std::span<const uint8_t> data, uint32_t crc = 0);
+
+    // Adler-32 checksum that ends a zlib stream
+    [[nodiscard]] uint32_t Adler32(std::span<const uint8_t> data);
+
+    // zlib stream (RFC 1950) of `data`, decodable by any inflate
+    [[nodiscard]] std::vector<uint8_t> ZlibCompress(std::span<const uint8_t> data);
+
+    // Complete PNG file of an 8-bit RGB image (row-major, width * height * 3 bytes)
+    [[nodiscard]] std::vector<uint8_t> EncodeRgb(int width, int height, std::span<const uint8_t> rgb);
+
+} // namespace PngWriter
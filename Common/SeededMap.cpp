@@ -0,0 +1,322 @@
+#include "SeededMap.h"
+#include "MapFileFormat.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <tuple>
+
+namespace {
+    // Each smoothing pass sweeps the whole map (and widens world chunk aprons)
+    constexpr int kMaxSmoothIterations = 64;
+
+    [[nodiscard]] bool IsUnitInterval(float value) noexcept {
+        return std::isfinite(value) && value >= 0.0f && value <= 1.0f;
+    }
+
+    class PayloadWriter {
+    public:
+        explicit PayloadWriter(std::vector<uint8_t>& out) noexcept : m_out(out) {}
+
+        void Add(uint32_t value) {
+            for (int i = 0; i < 4; ++i) {
+                m_out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+            }
+        }
+        void Add(int value) { Add(static_cast<uint32_t>(value)); }
+        void Add(float value) { Add(std::bit_cast<uint32_t>(value)); }
+
+        void AddVarint(uint64_t value) {
+            while (value >= 0x80) {
+                m_out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            m_out.push_back(static_cast<uint8_t>(value));
+        }
+
+        void AddByte(uint8_t value) { m_out.push_back(value); }
+
+    private:
+        std::vector<uint8_t>& m_out;
+    };
+
+    // Reads fail (return false) once the payload is exhausted or malformed
+    class PayloadReader {
+    public:
+        explicit PayloadReader(std::span<const uint8_t> data) noexcept : m_data(data) {}
+
+        [[nodiscard]] bool Read(uint32_t& value) noexcept {
+            if (m_data.size() - m_pos < 4) {
+                return false;
+            }
+            value = 0;
+            for (int i = 0; i < 4; ++i) {
+                value |= static_cast<uint32_t>(m_data[m_pos++]) << (i * 8);
+            }
+            return true;
+        }
+        [[nodiscard]] bool Read(int& value) noexcept {
+            uint32_t bits = 0;
+            if (!Read(bits)) return false;
+            value = static_cast<int>(bits);
+            return true;
+        }
+        [[nodiscard]] bool Read(float& value) noexcept {
+            uint32_t bits = 0;
+            if (!Read(bits)) return false;
+            value = std::bit_cast<float>(bits);
+            return true;
+        }
+
+        [[nodiscard]] bool ReadVarint(uint64_t& value) noexcept {
+            value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (m_pos >= m_data.size()) {
+                    return false;
+                }
+                const uint8_t byte = m_data[m_pos++];
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] bool ReadByte(uint8_t& value) noexcept {
+            if (m_pos >= m_data.size()) {
+                return false;
+            }
+            value = m_data[m_pos++];
+            return true;
+        }
+
+        [[nodiscard]] bool AtEnd() const noexcept { return m_pos == m_data.size(); }
+
+    private:
+        std::span<const uint8_t> m_data;
+        size_t m_pos{};
+    };
+}
+
+SeededMap::SeededMap(const MapGenerator::Config& config)
+    : m_config(config)
+{
+}
+
+std::optional<SeededMap> SeededMap::Capture(const MapGenerator::Config& config, const Map& map)
+{
+    if (config.seed == 0 || map.GetWidth() != config.width || map.GetHeight() != config.height) {
+        return std::nullopt;
+    }
+
+    SeededMap seeded(config);
+    const Map base = MapGenerator::Generate(config);
+    map.ForEachRowInRect({0, 0, map.GetWidth(), map.GetHeight()},
+        [&](int, int y, std::span<const TileType> row) {
+            const auto baseRow = base.GetRowSpan(y);
+            auto it = row.begin();
+            auto baseIt = baseRow.begin();
+            while (true) {
+                std::tie(it, baseIt) = std::mismatch(it, row.end(), baseIt);
+                if (it == row.end()) {
+                    break;
+                }
+                seeded.m_edits.push_back({seeded.Index(static_cast<int>(it - row.begin()), y), *it});
+                ++it;
+                ++baseIt;
+            }
+        });
+    return seeded;
+}
+
+void SeededMap::SetTile(int x, int y, TileType tile)
+{
+    if (!IsInBounds(x, y)) {
+        return;
+    }
+
+    const uint64_t index = Index(x, y);
+    const auto it = std::lower_bound(m_edits.begin(), m_edits.end(), index,
+        [](const Edit& edit, uint64_t value) { return edit.index < value; });
+    if (it != m_edits.end() && it->index == index) {
+        it->tile = tile;
+    } else {
+        m_edits.insert(it, Edit{index, tile});
+    }
+
+    if (m_map) {
+        m_map->SetTile(x, y, tile);
+    }
+}
+
+TileType SeededMap::GetTile(int x, int y)
+{
+    if (!IsInBounds(x, y)) {
+        return TileType::Empty;
+    }
+    const uint64_t index = Index(x, y);
+    const auto it = std::lower_bound(m_edits.begin(), m_edits.end(), index,
+        [](const Edit& edit, uint64_t value) { return edit.index < value; });
+    if (it != m_edits.end() && it->index == index) {
+        return it->tile;
+    }
+    return GetMap().GetTileUnchecked(x, y);
+}
+
+const Map& SeededMap::GetMap()
+{
+    if (!m_map) {
+        m_map = Materialize();
+    }
+    return *m_map;
+}
+
+Map SeededMap::Materialize() const
+{
+    Map map = MapGenerator::Generate(m_config);
+    const uint64_t width = static_cast<uint64_t>(m_config.width);
+    for (const Edit& edit : m_edits) {
+        map.SetTile(static_cast<int>(edit.index % width), static_cast<int>(edit.index / width), edit.tile);
+    }
+    return map;
+}
+
+std::vector<uint8_t> SeededMap::Encode() const
+{
+    std::vector<uint8_t> bytes;
+    PayloadWriter writer(bytes);
+    writer.Add(MapGenerator::kVersion);
+    writer.Add(m_config.width);
+    writer.Add(m_config.height);
+    writer.Add(m_config.wallDensity);
+    writer.Add(m_config.smoothIterations);
+    writer.Add(m_config.wallThreshold);
+    writer.Add(m_config.waterChance);
+    writer.Add(m_config.seed);
+    writer.AddByte(static_cast<uint8_t>(m_config.algorithm));
+    writer.AddByte(static_cast<uint8_t>(m_config.connectivity));
+    writer.Add(m_config.minRegionSize);
+
+    writer.AddVarint(m_edits.size());
+    uint64_t previous = 0;
+    for (const Edit& edit : m_edits) {
+        writer.AddVarint(edit.index - previous);
+        writer.AddByte(static_cast<uint8_t>(edit.tile));
+        previous = edit.index;
+    }
+    return bytes;
+}
+
+std::optional<SeededMap> SeededMap::Decode(std::span<const uint8_t> bytes)
+{
+    PayloadReader reader(bytes);
+    uint32_t version = 0;
+    uint8_t algorithm = 0;
+    uint8_t connectivity = 0;
+    MapGenerator::Config config;
+    if (!reader.Read(version) || version != MapGenerator::kVersion ||
+        !reader.Read(config.width) || !reader.Read(config.height) ||
+        !reader.Read(config.wallDensity) || !reader.Read(config.smoothIterations) ||
+        !reader.Read(config.wallThreshold) || !reader.Read(config.waterChance) ||
+        !reader.Read(config.seed) || !reader.ReadByte(algorithm) ||
+        !reader.ReadByte(connectivity) || !reader.Read(config.minRegionSize)) {
+        return std::nullopt;
+    }
+    config.algorithm = static_cast<MapGenerator::Algorithm>(algorithm);
+    config.connectivity = static_cast<MapGenerator::Connectivity>(connectivity);
+    // Decoding is cheap but Materialize is not: bound the map like an RLE stream
+    if (config.width <= 0 || config.height <= 0 || config.seed == 0 ||
+        static_cast<uint64_t>(config.width) * static_cast<uint64_t>(config.height) > Map::kMaxDecodedTiles ||
+        (config.algorithm != MapGenerator::Algorithm::Sequential &&
+         config.algorithm != MapGenerator::Algorithm::CounterHash &&
+         config.algorithm != MapGenerator::Algorithm::SequentialSkip) ||
+        connectivity > static_cast<uint8_t>(MapGenerator::Connectivity::CarveTunnels)) {
+        return std::nullopt;
+    }
+
+    // Parameters a peer could use to stall or break generation
+    const uint64_t tileCount = static_cast<uint64_t>(config.width) * static_cast<uint64_t>(config.height);
+    if (!IsUnitInterval(config.wallDensity) || !IsUnitInterval(config.waterChance) ||
+        config.smoothIterations < 0 || config.smoothIterations > kMaxSmoothIterations ||
+        config.wallThreshold < 0 || config.wallThreshold > 8 ||
+        config.minRegionSize < 0 || static_cast<uint64_t>(config.minRegionSize) > tileCount) {
+        return std::nullopt;
+    }
+
+    uint64_t count = 0;
+    if (!reader.ReadVarint(count) || count > tileCount) {
+        return std::nullopt;
+    }
+
+    SeededMap seeded(config);
+    seeded.m_edits.reserve(static_cast<size_t>(count));
+    uint64_t index = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t delta = 0;
+        uint8_t tile = 0;
+        if (!reader.ReadVarint(delta) || !reader.ReadByte(tile)) {
+            return std::nullopt;
+        }
+        // Indices strictly increase (the first may be 0) and stay inside the map
+        if ((i > 0 && delta == 0) || delta >= tileCount - index) {
+            return std::nullopt;
+        }
+        index += delta;
+        seeded.m_edits.push_back({index, static_cast<TileType>(tile)});
+    }
+    if (!reader.AtEnd()) {
+        return std::nullopt;
+    }
+    return seeded;
+}
+
+bool SeededMap::SaveToFile(std::string_view filename) const
+{
+    std::ofstream file{std::string(filename), std::ios::binary};
+    if (!file.is_open()) {
+        return false;
+    }
+
+    const std::vector<uint8_t> payload = Encode();
+    DmapFormat::WriteHeader(file, DmapFormat::MakeHeader(DmapFormat::kTileFormatSeeded, m_config.width,
+                                                         m_config.height, payload.size(), {}));
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    return file.good();
+}
+
+bool SeededMap::LoadFromFile(std::string_view filename)
+{
+    std::ifstream file{std::string(filename), std::ios::binary};
+    if (!file.is_open()) {
+        return false;
+    }
+
+    DmapFormat::Header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        !DmapFormat::HasMagic(&header, sizeof(header)) ||
+        header.version != DmapFormat::kVersion ||
+        header.tileFormat != DmapFormat::kTileFormatSeeded ||
+        header.dataOffset < sizeof(header)) {
+        return false;
+    }
+
+    // Payloads are tiny; anything large is not one of ours
+    constexpr uint64_t kMaxPayload = uint64_t{1} << 30;
+    if (header.dataSize > kMaxPayload) {
+        return false;
+    }
+    std::vector<uint8_t> payload(static_cast<size_t>(header.dataSize));
+    file.seekg(header.dataOffset);
+    if (!file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()))) {
+        return false;
+    }
+
+    auto decoded = Decode(payload);
+    if (!decoded || decoded->m_config.width != header.width || decoded->m_config.height != header.height) {
+        return false;
+    }
+    *this = std::move(*decoded);
+    return true;
+}
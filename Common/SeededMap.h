@@ -0,0 +1,83 @@
+#pragma once
+
+#include "MapGenerator.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// A generated map stored as its generator Config plus a sparse overlay of the
+// tiles that differ from the generator output
+//
+// Generation is deterministic for a non-zero seed, so a level that players
+// have only dented (a few broken walls) is fully described by the Config and
+// a handful of edits: tens of bytes instead of width*height. The tiles are
+// materialized on first access to GetMap, not when the map is decoded.
+//
+// Encoded form (little-endian, varints are unsigned LEB128):
+//   u32 MapGenerator::kVersion, the Config fields that shape the output in
+//   declaration order (int/unsigned as 4 bytes, float as its IEEE bits, the
+//   algorithm and connectivity IDs as 1 byte), varint edit count,
+//   then per edit: varint (index - previous index), tile byte.
+// Payloads from another generator version are rejected, since the same
+// Config would no longer produce the same base tiles.
+class SeededMap {
+public:
+    // One overlay entry; index is y * width + x
+    struct Edit {
+        uint64_t index;
+        TileType tile;
+    };
+
+    SeededMap() = default;
+
+    // Unedited map for `config`; the seed must be non-zero to be reproducible
+    explicit SeededMap(const MapGenerator::Config& config);
+
+    // Overlay of the tiles in which `map` differs from the output for `config`.
+    // Fails for seed 0 or if the map size does not match the Config.
+    [[nodiscard]] static std::optional<SeededMap> Capture(const MapGenerator::Config& config,
+                                                          const Map& map);
+
+    // Record an edit (and apply it, if the map is already materialized)
+    void SetTile(int x, int y, TileType tile);
+
+    // Tile at (x, y): the overlay entry if there is one, else the materialized tile
+    [[nodiscard]] TileType GetTile(int x, int y);
+
+    // Generated tiles with the overlay applied, built on first call
+    [[nodiscard]] const Map& GetMap();
+
+    // Build a fresh copy without caching it
+    [[nodiscard]] Map Materialize() const;
+
+    [[nodiscard]] bool IsMaterialized() const noexcept { return m_map.has_value(); }
+    [[nodiscard]] const MapGenerator::Config& GetConfig() const noexcept { return m_config; }
+    [[nodiscard]] const std::vector<Edit>& GetEdits() const noexcept { return m_edits; }
+
+    // Compact byte form (see above) for save files and network transfer.
+    // Decode rejects maps of more than Map::kMaxDecodedTiles tiles and
+    // generator parameters out of range (densities outside [0, 1], more than
+    // 64 smoothing passes, a threshold outside 0-8, a negative or oversized
+    // minimum region).
+    [[nodiscard]] std::vector<uint8_t> Encode() const;
+    [[nodiscard]] static std::optional<SeededMap> Decode(std::span<const uint8_t> bytes);
+
+    // .dmap container with DmapFormat::kTileFormatSeeded data. Map::LoadFromFile
+    // rejects these files; load them here and call GetMap.
+    [[nodiscard]] bool SaveToFile(std::string_view filename) const;
+    [[nodiscard]] bool LoadFromFile(std::string_view filename);
+
+private:
+    [[nodiscard]] bool IsInBounds(int x, int y) const noexcept {
+        return x >= 0 && x < m_config.width && y >= 0 && y < m_config.height;
+    }
+    [[nodiscard]] uint64_t Index(int x, int y) const noexcept {
+        return static_cast<uint64_t>(y) * static_cast<uint64_t>(m_config.width) + static_cast<uint64_t>(x);
+    }
+
+    MapGenerator::Config m_config{};
+    std::vector<Edit> m_edits{};     // Sorted by index, at most one per tile
+    std::optional<Map> m_map{};      // Materialized tiles (lazy)
+};
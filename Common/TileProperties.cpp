@@ -0,0 +1,61 @@
+#include "TileProperties.h"
+#include "IniFile.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+    void ReadColor(const IniFile& ini, std::string_view section, std::string_view key, TileColor& color)
+    {
+        if (const auto rgba = ini.GetRgba(section, key)) {
+            color = {rgba->r, rgba->g, rgba->b, rgba->a};
+        }
+    }
+}
+
+bool LoadTileSettings(std::string_view filename, TileSettings& settings)
+{
+    IniFile ini;
+    if (!ini.Load(filename)) {
+        return false;
+    }
+
+    // Named colors of the built-in tiles
+    TileColorSet& floor = settings.colors[static_cast<uint8_t>(TileType::Floor)];
+    TileColorSet& wall = settings.colors[static_cast<uint8_t>(TileType::Wall)];
+    TileColorSet& water = settings.colors[static_cast<uint8_t>(TileType::Water)];
+    ReadColor(ini, "Colors", "FloorFill", floor.fill);
+    ReadColor(ini, "Colors", "FloorOutline", floor.outline);
+    ReadColor(ini, "Colors", "WallTop", wall.top);
+    ReadColor(ini, "Colors", "WallLeft", wall.left);
+    ReadColor(ini, "Colors", "WallRight", wall.right);
+    ReadColor(ini, "Colors", "WaterFill", water.fill);
+    ReadColor(ini, "Colors", "WaterOutline", water.outline);
+    ReadColor(ini, "Colors", "Shadow", settings.shadow);
+    ReadColor(ini, "Colors", "PathLine", settings.pathLine);
+
+    // Per-tile sections
+    for (size_t id = 0; id < settings.properties.size(); ++id) {
+        const std::string section = "Tile." + std::to_string(id);
+        if (!ini.HasSection(section)) {
+            continue;
+        }
+
+        TileProperties& properties = settings.properties[id];
+        properties.walkable = ini.GetBool(section, "Walkable", properties.walkable);
+        properties.blocksSight = ini.GetBool(section, "BlocksSight", properties.blocksSight);
+        properties.moveCost = std::max(1.0f, ini.GetFloat(section, "MoveCost", properties.moveCost));
+        if (const auto render = ini.GetString(section, "Render")) {
+            if (*render == "None") properties.renderClass = TileRenderClass::None;
+            else if (*render == "Ground") properties.renderClass = TileRenderClass::Ground;
+            else if (*render == "Block") properties.renderClass = TileRenderClass::Block;
+        }
+
+        TileColorSet& colors = settings.colors[id];
+        ReadColor(ini, section, "Fill", colors.fill);
+        ReadColor(ini, section, "Outline", colors.outline);
+        ReadColor(ini, section, "Top", colors.top);
+        ReadColor(ini, section, "Left", colors.left);
+        ReadColor(ini, section, "Right", colors.right);
+    }
+    return true;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "TileType.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// How the renderer draws a tile
+enum class TileRenderClass : uint8_t {
+    None,    // Nothing drawn (Empty)
+    Ground,  // Flat diamond in the ground pass (Floor, Water)
+    Block    // Raised block, depth-sorted with entities (Wall)
+};
+
+// Gameplay and rendering properties of one tile type
+struct TileProperties {
+    bool walkable{false};
+    bool blocksSight{false};
+    float moveCost{1.0f};    // Step cost multiplier on walkable tiles (>= 1 keeps A* admissible)
+    TileRenderClass renderClass{TileRenderClass::None};
+};
+
+// Property table indexed by the tile byte: every query is one indexed load.
+// Defaults describe the built-in tile types; TileConfig::Load (game side)
+// overrides them from config/tiles.ini (see LoadTileSettings). Maps bake walkability into their
+// walkability plane, so change the table before building or loading maps.
+class TileTable {
+public:
+    [[nodiscard]] static const TileProperties& Get(TileType tile) noexcept {
+        return s_properties[static_cast<uint8_t>(tile)];
+    }
+
+    [[nodiscard]] static bool IsWalkable(TileType tile) noexcept { return Get(tile).walkable; }
+
+    static void Set(TileType tile, const TileProperties& properties) noexcept {
+        s_properties[static_cast<uint8_t>(tile)] = properties;
+    }
+
+    // Restore the built-in defaults
+    static void Reset() noexcept { s_properties = MakeDefaults(); }
+
+    [[nodiscard]] static constexpr std::array<TileProperties, 256> MakeDefaults() noexcept {
+        std::array<TileProperties, 256> table{};
+        table[static_cast<uint8_t>(TileType::Floor)] = {true, false, 1.0f, TileRenderClass::Ground};
+        table[static_cast<uint8_t>(TileType::Wall)] = {false, true, 1.0f, TileRenderClass::Block};
+        table[static_cast<uint8_t>(TileType::Water)] = {false, false, 1.0f, TileRenderClass::Ground};
+        return table;
+    }
+
+private:
+    inline static std::array<TileProperties, 256> s_properties = MakeDefaults();
+};
+
+// 8-bit RGBA color (raylib's Color layout, without the raylib dependency)
+struct TileColor {
+    uint8_t r{}, g{}, b{}, a{};
+};
+
+// Colors used to draw one tile type (which ones apply depends on its render class)
+struct TileColorSet {
+    TileColor fill{};      // Ground tiles
+    TileColor outline{};
+    TileColor top{};       // Block tiles
+    TileColor left{};
+    TileColor right{};
+};
+
+// Everything config/tiles.ini describes, initialized to the built-in tiles.
+// The game (TileConfig) and the map tools both start from these defaults.
+struct TileSettings {
+    std::array<TileProperties, 256> properties = TileTable::MakeDefaults();
+    std::array<TileColorSet, 256> colors = MakeDefaultColors();
+    TileColor shadow{0, 0, 0, 80};
+    TileColor pathLine{144, 238, 144, 200};
+
+    [[nodiscard]] static constexpr std::array<TileColorSet, 256> MakeDefaultColors() noexcept {
+        std::array<TileColorSet, 256> colors{};
+        colors[static_cast<uint8_t>(TileType::Floor)].fill = {60, 60, 65, 255};
+        colors[static_cast<uint8_t>(TileType::Floor)].outline = {40, 40, 45, 255};
+        colors[static_cast<uint8_t>(TileType::Wall)].top = {100, 100, 110, 255};
+        colors[static_cast<uint8_t>(TileType::Wall)].left = {70, 70, 80, 255};
+        colors[static_cast<uint8_t>(TileType::Wall)].right = {85, 85, 95, 255};
+        colors[static_cast<uint8_t>(TileType::Water)].fill = {50, 100, 150, 200};
+        colors[static_cast<uint8_t>(TileType::Water)].outline = {30, 80, 130, 200};
+        return colors;
+    }
+};
+
+// Override `settings` from a tiles.ini file; false if it cannot be read
+//
+// [Colors] keeps the named colors of the built-in tiles (FloorFill,
+// FloorOutline, WallTop, WallLeft, WallRight, WaterFill, WaterOutline,
+// Shadow, PathLine). A [Tile.<id>] section (id = tile byte 0-255) defines
+// or overrides one tile type:
+//   Walkable, BlocksSight, MoveCost (at least 1), Render (None/Ground/Block),
+//   Fill, Outline (ground tiles), Top, Left, Right (block tiles)
+// Missing keys keep their current values.
+[[nodiscard]] bool LoadTileSettings(std::string_view filename, TileSettings& settings);
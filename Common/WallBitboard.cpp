@@ -0,0 +1,156 @@
+#include "WallBitboard.h"
+#include <algorithm>
+
+namespace {
+    // Neighbour bits of word `w`: bit i of `west` is tile i - 1, of `east` tile i + 1
+    inline void Sideways(const uint64_t* row, int w, int words, uint64_t& west, uint64_t& east) noexcept {
+        const uint64_t mid = row[w];
+        west = (mid << 1) | (w > 0 ? row[w - 1] >> 63 : 0);
+        east = (mid >> 1) | (w + 1 < words ? row[w + 1] << 63 : 0);
+    }
+
+    inline void FullAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t& sum, uint64_t& carry) noexcept {
+        const uint64_t ab = a ^ b;
+        sum = ab ^ c;
+        carry = (a & b) | (c & ab);
+    }
+}
+
+WallBitboard::WallBitboard(int width, int height)
+    : m_width(std::max(width, 0))
+    , m_height(std::max(height, 0))
+    , m_wordsPerRow((std::max(width, 0) + 63) / 64)
+    , m_words(static_cast<size_t>(m_wordsPerRow) * static_cast<size_t>(m_height))
+{
+}
+
+WallBitboard WallBitboard::FromTiles(std::span<const TileType> tiles, int width, int height)
+{
+    WallBitboard board(width, height);
+    board.PackRows(tiles, 0, board.m_height);
+    return board;
+}
+
+void WallBitboard::ToTiles(std::span<TileType> out) const
+{
+    UnpackRows(out, 0, m_height);
+}
+
+void WallBitboard::PackRows(std::span<const TileType> tiles, int firstRow, int endRow) noexcept
+{
+    for (int y = firstRow; y < endRow; ++y) {
+        const TileType* row = tiles.data() + static_cast<size_t>(y) * static_cast<size_t>(m_width);
+        uint64_t* words = Row(y);
+        for (int w = 0; w < m_wordsPerRow; ++w) {
+            const int begin = w * 64;
+            const int count = std::min(64, m_width - begin);
+            uint64_t word = 0;
+            for (int i = 0; i < count; ++i) {
+                word |= static_cast<uint64_t>(row[begin + i] == TileType::Wall) << i;
+            }
+            words[w] = word;
+        }
+    }
+}
+
+void WallBitboard::UnpackRows(std::span<TileType> tiles, int firstRow, int endRow) const noexcept
+{
+    for (int y = firstRow; y < endRow; ++y) {
+        TileType* row = tiles.data() + static_cast<size_t>(y) * static_cast<size_t>(m_width);
+        const uint64_t* words = Row(y);
+        for (int x = 0; x < m_width; ++x) {
+            row[x] = ((words[x >> 6] >> (x & 63)) & 1u) ? TileType::Wall : TileType::Floor;
+        }
+    }
+}
+
+uint64_t WallBitboard::WordMask(int w) const noexcept
+{
+    const int bits = m_width - w * 64;
+    return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+}
+
+void WallBitboard::Smooth(WallBitboard& out, int threshold) const
+{
+    if (out.m_width != m_width || out.m_height != m_height) {
+        out = WallBitboard(m_width, m_height);
+    }
+    SmoothRows(out, threshold, 0, m_height);
+}
+
+void WallBitboard::SmoothRows(WallBitboard& out, int threshold, int firstRow, int endRow) const noexcept
+{
+    if (m_width == 0) {
+        return;
+    }
+
+    const int words = m_wordsPerRow;
+    const uint64_t leftBorder = 1;
+    const uint64_t rightBorder = uint64_t{1} << ((m_width - 1) & 63);
+    const int rightWord = (m_width - 1) >> 6;
+
+    // Counts are 0-8, so thresholds outside that range decide every tile alike
+    const bool alwaysWall = threshold < 0;
+    const bool alwaysFloor = threshold > 8;
+
+    for (int y = std::max(firstRow, 0); y < std::min(endRow, m_height); ++y) {
+        uint64_t* dst = out.Row(y);
+
+        // Top and bottom rows are border walls
+        if (y == 0 || y == m_height - 1) {
+            for (int w = 0; w < words; ++w) {
+                dst[w] = WordMask(w);
+            }
+            continue;
+        }
+
+        const uint64_t* above = Row(y - 1);
+        const uint64_t* center = Row(y);
+        const uint64_t* below = Row(y + 1);
+
+        for (int w = 0; w < words; ++w) {
+            uint64_t aWest, aEast, cWest, cEast, bWest, bEast;
+            Sideways(above, w, words, aWest, aEast);
+            Sideways(center, w, words, cWest, cEast);
+            Sideways(below, w, words, bWest, bEast);
+
+            // Per-row partial sums, then the four count bit-planes
+            uint64_t aOnes, aTwos, bOnes, bTwos;
+            FullAdd(aWest, above[w], aEast, aOnes, aTwos);
+            FullAdd(bWest, below[w], bEast, bOnes, bTwos);
+            const uint64_t cOnes = cWest ^ cEast;
+            const uint64_t cTwos = cWest & cEast;
+
+            uint64_t ones, onesCarry;
+            FullAdd(aOnes, bOnes, cOnes, ones, onesCarry);
+            uint64_t twosPartial, foursA;
+            FullAdd(aTwos, bTwos, cTwos, twosPartial, foursA);
+            const uint64_t twos = twosPartial ^ onesCarry;
+            const uint64_t foursB = twosPartial & onesCarry;
+            const uint64_t fours = foursA ^ foursB;
+            const uint64_t eights = foursA & foursB;
+
+            // Compare the count against the threshold, most significant plane first
+            uint64_t greater = 0;
+            uint64_t equal = ~uint64_t{0};
+            const uint64_t planes[4] = {eights, fours, twos, ones};
+            for (int bit = 0; bit < 4; ++bit) {
+                const uint64_t plane = planes[bit];
+                if ((threshold >> (3 - bit)) & 1) {
+                    equal &= plane;
+                } else {
+                    greater |= equal & plane;
+                    equal &= ~plane;
+                }
+            }
+
+            uint64_t result = greater | (equal & center[w]);
+            if (alwaysWall) result = ~uint64_t{0};
+            if (alwaysFloor) result = 0;
+            dst[w] = result & WordMask(w);
+        }
+
+        dst[0] |= leftBorder;
+        dst[rightWord] |= rightBorder;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "TileType.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Wall mask of a tile grid, one bit per tile, for the generator's cellular automaton
+//
+// Rows are padded to whole 64-bit words (bit i of word w is tile w * 64 + i);
+// padding bits are always 0. A smoothing step counts the 8 neighbours of 64
+// tiles at once with bit-sliced adders: each neighbour direction is the row
+// word shifted by one, and the counts are summed as four bit-planes (1, 2, 4
+// and 8) using full adders, then compared against the threshold bitwise.
+class WallBitboard {
+public:
+    WallBitboard() = default;
+    WallBitboard(int width, int height);
+
+    // Wall bit for every tile of a row-major grid
+    [[nodiscard]] static WallBitboard FromTiles(std::span<const TileType> tiles, int width, int height);
+
+    // Write the mask back as Wall/Floor tiles (row-major, width * height)
+    void ToTiles(std::span<TileType> out) const;
+
+    // Pack / unpack rows [firstRow, endRow) only, so bands can run on separate
+    // threads; `tiles` always spans the whole row-major grid
+    void PackRows(std::span<const TileType> tiles, int firstRow, int endRow) noexcept;
+    void UnpackRows(std::span<TileType> tiles, int firstRow, int endRow) const noexcept;
+
+    // One MapGenerator smoothing step into `out` (same size): an interior
+    // tile becomes a wall with more than `threshold` wall neighbours, a floor
+    // with fewer, and keeps its state at exactly `threshold`. Border tiles
+    // always become walls. Matches MapGenerator::SmoothMap bit for bit.
+    void Smooth(WallBitboard& out, int threshold) const;
+
+    // The same step for output rows [firstRow, endRow) only; `out` must
+    // already have this board's size. Rows only read this board, so disjoint
+    // row bands can be smoothed concurrently.
+    void SmoothRows(WallBitboard& out, int threshold, int firstRow, int endRow) const noexcept;
+
+    [[nodiscard]] bool IsWall(int x, int y) const noexcept {
+        return (m_words[WordIndex(x, y)] >> (x & 63)) & 1u;
+    }
+    void SetWall(int x, int y, bool wall) noexcept {
+        const uint64_t bit = uint64_t{1} << (x & 63);
+        uint64_t& word = m_words[WordIndex(x, y)];
+        word = wall ? (word | bit) : (word & ~bit);
+    }
+
+    [[nodiscard]] int GetWidth() const noexcept { return m_width; }
+    [[nodiscard]] int GetHeight() const noexcept { return m_height; }
+    [[nodiscard]] int GetWordsPerRow() const noexcept { return m_wordsPerRow; }
+
+private:
+    [[nodiscard]] size_t WordIndex(int x, int y) const noexcept {
+        return static_cast<size_t>(y) * static_cast<size_t>(m_wordsPerRow) + static_cast<size_t>(x >> 6);
+    }
+    [[nodiscard]] const uint64_t* Row(int y) const noexcept {
+        return m_words.data() + static_cast<size_t>(y) * static_cast<size_t>(m_wordsPerRow);
+    }
+    [[nodiscard]] uint64_t* Row(int y) noexcept {
+        return m_words.data() + static_cast<size_t>(y) * static_cast<size_t>(m_wordsPerRow);
+    }
+
+    // Valid bits of word `w` in a row (all ones except in the last word)
+    [[nodiscard]] uint64_t WordMask(int w) const noexcept;
+
+    int m_width{};
+    int m_height{};
+    int m_wordsPerRow{};
+    std::vector<uint64_t> m_words{};
+};
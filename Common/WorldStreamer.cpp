@@ -0,0 +1,81 @@
+#include "WorldStreamer.h"
+#include <algorithm>
+#include <chrono>
+
+WorldStreamer::WorldStreamer(const MapGenerator::Config& config)
+    : m_config(config)
+{
+    if (m_config.seed == 0) {
+        m_config.seed = static_cast<unsigned int>(
+            std::chrono::high_resolution_clock::now().time_since_epoch().count()
+        );
+    }
+    m_config.width = kWorldSize;
+    m_config.height = kWorldSize;
+    m_config.algorithm = MapGenerator::Algorithm::CounterHash;
+}
+
+void WorldStreamer::InitMap(Map& map)
+{
+    map.InitChunked("World", kWorldSize, kWorldSize, TileType::Wall);
+    m_generated.clear();
+    m_minChunkX = m_minChunkY = 0;
+    m_maxChunkX = m_maxChunkY = -1;
+}
+
+std::vector<MapRect> WorldStreamer::EnsureAround(Map& map, int x, int y, int radiusChunks)
+{
+    constexpr int chunksPerSide = kWorldSize / kChunkSize;
+    const int centerX = x / kChunkSize;
+    const int centerY = y / kChunkSize;
+    const int cx0 = std::max(centerX - radiusChunks, 0);
+    const int cy0 = std::max(centerY - radiusChunks, 0);
+    const int cx1 = std::min(centerX + radiusChunks, chunksPerSide - 1);
+    const int cy1 = std::min(centerY + radiusChunks, chunksPerSide - 1);
+
+    std::vector<MapRect> generated;
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            if (!m_generated.insert(Key(cx, cy)).second) {
+                continue;
+            }
+
+            // The map starts as wall and SetTile skips unchanged tiles, so
+            // only the open parts of a chunk allocate or journal anything
+            const std::vector<TileType> tiles = MapGenerator::GenerateChunk(m_config, cx, cy);
+            const int originX = cx * kChunkSize;
+            const int originY = cy * kChunkSize;
+            for (int ty = 0; ty < kChunkSize; ++ty) {
+                for (int tx = 0; tx < kChunkSize; ++tx) {
+                    map.SetTile(originX + tx, originY + ty, tiles[static_cast<size_t>(ty * kChunkSize + tx)]);
+                }
+            }
+
+            if (m_generated.size() == 1) {
+                m_minChunkX = m_maxChunkX = cx;
+                m_minChunkY = m_maxChunkY = cy;
+            } else {
+                m_minChunkX = std::min(m_minChunkX, cx);
+                m_minChunkY = std::min(m_minChunkY, cy);
+                m_maxChunkX = std::max(m_maxChunkX, cx);
+                m_maxChunkY = std::max(m_maxChunkY, cy);
+            }
+            generated.push_back({originX, originY, kChunkSize, kChunkSize});
+        }
+    }
+    return generated;
+}
+
+bool WorldStreamer::IsGenerated(int chunkX, int chunkY) const
+{
+    return m_generated.contains(Key(chunkX, chunkY));
+}
+
+MapRect WorldStreamer::GetExploredBounds() const noexcept
+{
+    if (m_generated.empty()) {
+        return {};
+    }
+    return {m_minChunkX * kChunkSize, m_minChunkY * kChunkSize,
+            (m_maxChunkX - m_minChunkX + 1) * kChunkSize, (m_maxChunkY - m_minChunkY + 1) * kChunkSize};
+}
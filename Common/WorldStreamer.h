@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MapGenerator.h"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// Unbounded cave world generated one 64x64 chunk at a time as it is explored
+//
+// The world is a chunked Map of kWorldSize x kWorldSize tiles that starts as
+// solid wall; only chunks near the player are ever generated, so memory and
+// generation time scale with the explored area instead of the world size.
+// Chunks come from MapGenerator::GenerateChunk, a pure function of the Config
+// and the chunk position, so they line up seamlessly whatever order they are
+// generated in and the same seed always yields the same world.
+//
+// kWorldSize is bounded by the map's dense per-chunk bookkeeping (change
+// journal, chunk directory): 65536 tiles square keeps that at a few MB and
+// is far more than a player can walk. Region labels (EnableRegionIndex) are
+// dense too and must stay off for streamed maps.
+class WorldStreamer {
+public:
+    static constexpr int kWorldSize = 1 << 16;
+    static constexpr int kChunkSize = MapGenerator::kChunkSize;
+
+    // `config.width/height` are ignored; seed 0 picks a random world
+    explicit WorldStreamer(const MapGenerator::Config& config);
+
+    // Reset `map` to an ungenerated (all wall) world
+    void InitMap(Map& map);
+
+    // Generate every missing chunk within `radiusChunks` chunks of tile (x, y)
+    // into `map`. Returns the rectangles of the chunks generated by this call.
+    std::vector<MapRect> EnsureAround(Map& map, int x, int y, int radiusChunks);
+
+    [[nodiscard]] bool IsGenerated(int chunkX, int chunkY) const;
+    [[nodiscard]] size_t GetGeneratedChunkCount() const noexcept { return m_generated.size(); }
+
+    // Bounding box of the generated chunks (empty before the first chunk)
+    [[nodiscard]] MapRect GetExploredBounds() const noexcept;
+
+    [[nodiscard]] const MapGenerator::Config& GetConfig() const noexcept { return m_config; }
+
+private:
+    [[nodiscard]] static uint64_t Key(int chunkX, int chunkY) noexcept {
+        return static_cast<uint64_t>(static_cast<uint32_t>(chunkY)) << 32 | static_cast<uint32_t>(chunkX);
+    }
+
+    MapGenerator::Config m_config;
+    std::unordered_set<uint64_t> m_generated{};
+    int m_minChunkX{}, m_minChunkY{}, m_maxChunkX{-1}, m_maxChunkY{-1};
+};
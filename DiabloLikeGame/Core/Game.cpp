@@ -1,11 +1,13 @@
 #include "Game.h"
 #include "GameConfig.h"
+#include "TileConstants.h"
 #include "../Input/InputManager.h"
 #include "../Input/KeyboardInput.h"
 #include "../Input/MouseInput.h"
 #include "../Input/ControllerInput.h"
 #include "../World/Pathfinder.h"
 #include "../World/MapGenerator.h"
+#include "Common/MapCache.h"
 #include "../Config/ConfigManager.h"
 #include "../Config/MapGeneratorConfig.h"
 #include "../Config/MapConfig.h"
@@ -18,6 +20,18 @@
 #include <algorithm>
 #include <chrono>
 
+namespace {
+    // Part of a block away from the map edge (spawns never use the outer ring)
+    MapRect InteriorOf(const MapBlock& block, const Map& map)
+    {
+        const int x0 = std::max(block.x, 1);
+        const int y0 = std::max(block.y, 1);
+        const int x1 = std::min(block.x + block.width, map.GetWidth() - 1);
+        const int y1 = std::min(block.y + block.height, map.GetHeight() - 1);
+        return {x0, y0, x1 - x0, y1 - y0};
+    }
+}
+
 Game::Game()
     : m_rng(static_cast<unsigned int>(
         std::chrono::high_resolution_clock::now().time_since_epoch().count()))
@@ -33,6 +47,7 @@ bool Game::Init()
     // Load configuration files
     ConfigManager::Instance().LoadAll("config");
     MapGeneratorConfig::Load("config/mapgen.ini");
+    TileConfig::Load("config/tiles.ini");  // Before any map is built: walkability is baked per map
     GameplayDefaults::Instance().Load("config/gameplay/defaults.ini");
     const auto& playerConfig = ConfigManager::Instance().GetPlayerConfig();
     
@@ -43,9 +58,33 @@ bool Game::Init()
     
     // Load default map from file
     const std::string mapPath = "maps/default.map";
-    if (!m_map.LoadFromFile(mapPath)) {
-        // Fallback: generate random map using config from mapgen.ini
-        m_map = MapGenerator::Generate(MapGeneratorConfig::GetPreset("Default"));
+    MapLoadError mapError;
+    if (!m_map.LoadFromFile(mapPath, &mapError)) {
+        TraceLog(LOG_WARNING, "Failed to load %s (%s at line %d, column %d), generating a map",
+                 mapPath.c_str(), ToString(mapError.code), mapError.line, mapError.column);
+        if (MapGeneratorConfig::IsWorldStreamingEnabled()) {
+            // Unbounded world: generate the chunks around the world centre now
+            // and the rest as the player explores (see StreamWorld)
+            m_world.emplace(MapGeneratorConfig::GetWorld());
+            m_world->InitMap(m_map);
+            constexpr int center = WorldStreamer::kWorldSize / 2;
+            (void)m_world->EnsureAround(m_map, center, center, MapGeneratorConfig::GetWorldChunkRadius());
+            TraceLog(LOG_INFO, "Streaming world with seed %u", m_world->GetConfig().seed);
+        } else {
+            // Fallback: generate a map using config from mapgen.ini. Seeded presets
+            // are generated once and reloaded from the cache on later launches.
+            MapCache cache("cache/maps");
+            m_map = cache.GetOrGenerate(MapGeneratorConfig::GetPreset("Default"));
+            if (cache.GetHitCount() > 0) {
+                TraceLog(LOG_INFO, "Loaded generated map from %s", cache.GetDirectory().string().c_str());
+            }
+        }
+    }
+    
+    // Region labels let FindPath reject unreachable targets without searching.
+    // The index is dense (one label per tile), so streamed worlds go without.
+    if (!m_world) {
+        m_map.EnableRegionIndex();
     }
     
     // Load map-specific configuration (with global defaults as fallback)
@@ -60,7 +99,7 @@ bool Game::Init()
     
     // Find spawn position and initialize player from config
     int spawnX, spawnY;
-    if (!FindPlayerSpawnPosition(spawnX, spawnY)) {
+    if (!FindPlayerSpawnPosition(GetPlayableArea(), spawnX, spawnY)) {
         return false;
     }
     m_player.Init(spawnX, spawnY, playerConfig.maxHealth);
@@ -93,7 +132,7 @@ bool Game::Init()
     m_camera.CenterOn(static_cast<float>(spawnX), static_cast<float>(spawnY));
     
     // Spawn enemies using map-specific config (with difficulty multiplier applied)
-    SpawnEnemies(m_mapConfig.GetEffectiveSpawnRate());
+    SpawnEnemies(m_mapConfig.GetEffectiveSpawnRate(), GetPlayableArea());
     
     // Initialize occupancy map with all entity positions
     InitOccupancyMap();
@@ -102,21 +141,34 @@ bool Game::Init()
     return true;
 }
 
-bool Game::FindPlayerSpawnPosition(int& outX, int& outY) const
+MapRect Game::GetPlayableArea() const noexcept
 {
-    for (int y = 1; y < m_map.GetHeight() - 1; ++y) {
-        for (int x = 1; x < m_map.GetWidth() - 1; ++x) {
-            if (Pathfinder::IsTileWalkable(m_map, x, y)) {
-                outX = x;
-                outY = y;
-                return true;
-            }
-        }
-    }
-    return false;
+    return m_world ? m_world->GetExploredBounds() : MapRect{0, 0, m_map.GetWidth(), m_map.GetHeight()};
+}
+
+bool Game::FindPlayerSpawnPosition(MapRect area, int& outX, int& outY) const
+{
+    bool found = false;
+    
+    // Walk the area block by block so chunked worlds skip solid chunks wholesale
+    m_map.ForEachBlock(area, [&](const MapBlock& block) {
+        if (block.uniform && !Map::IsWalkableTile(block.tile)) return true;
+        
+        m_map.ForEachRowInRect(InteriorOf(block, m_map), [&](int x0, int y, std::span<const TileType> row) {
+            const auto it = std::find_if(row.begin(), row.end(), Map::IsWalkableTile);
+            if (it == row.end()) return true;
+            outX = x0 + static_cast<int>(it - row.begin());
+            outY = y;
+            found = true;
+            return false;
+        });
+        return !found;
+    });
+    
+    return found;
 }
 
-void Game::SpawnEnemies(float spawnRate)
+void Game::SpawnEnemies(float spawnRate, MapRect area)
 {
     std::uniform_real_distribution<float> spawnDist(0.0f, 1.0f);
     
@@ -130,19 +182,23 @@ void Game::SpawnEnemies(float spawnRate)
     const int playerY = m_player.GetTileY();
     constexpr int safeRadius = CombatConfig::Spawn::kSafeRadiusFromPlayer;
     
-    // Reserve estimated space
-    const size_t estimatedEnemies = static_cast<size_t>(
-        m_map.GetWidth() * m_map.GetHeight() * spawnRate * 0.5f);
-    m_enemies.reserve(estimatedEnemies);
+    // Reserve estimated space (chunked worlds are mostly solid, so skip the estimate)
+    if (!m_map.IsChunked()) {
+        const size_t estimatedEnemies = static_cast<size_t>(
+            static_cast<float>(m_map.GetWidth()) * static_cast<float>(m_map.GetHeight()) * spawnRate * 0.5f);
+        m_enemies.reserve(estimatedEnemies);
+    }
     
-    // Iterate through all floor tiles
-    for (int y = 1; y < m_map.GetHeight() - 1; ++y) {
-        for (int x = 1; x < m_map.GetWidth() - 1; ++x) {
-            if (m_map.GetTile(x, y) != TileType::Floor) continue;
+    // Iterate through all walkable tiles, skipping uniform unwalkable chunks
+    m_map.ForEachBlock(area, [&](const MapBlock& block) {
+        if (block.uniform && !Map::IsWalkableTile(block.tile)) return true;
+        
+        m_map.ForEachInRect(InteriorOf(block, m_map), [&](int x, int y, TileType tile) {
+            if (!Map::IsWalkableTile(tile)) return;
             
             const int dx = x - playerX;
             const int dy = y - playerY;
-            if (dx * dx + dy * dy < safeRadius * safeRadius) continue;
+            if (dx * dx + dy * dy < safeRadius * safeRadius) return;
             
             if (spawnDist(m_rng) < spawnRate) {
                 // Pick random enemy type from config
@@ -151,13 +207,34 @@ void Game::SpawnEnemies(float spawnRate)
                     const auto* config = ConfigManager::Instance().GetEnemyType(typeId);
                     if (config) {
                         m_enemies.emplace_back(x, y, *config, m_rng);
-                        continue;
+                        return;
                     }
                 }
                 // Fallback to default
                 m_enemies.emplace_back(x, y, m_rng);
             }
-        }
+        });
+        return true;
+    });
+}
+
+void Game::StreamWorld()
+{
+    const int radius = MapGeneratorConfig::GetWorldChunkRadius();
+    const Vector2 cameraTile = m_camera.ScreenToTile(Config::SCREEN_WIDTH / 2, Config::SCREEN_HEIGHT / 2);
+    
+    std::vector<MapRect> generated = m_world->EnsureAround(m_map, m_player.GetTileX(), m_player.GetTileY(), radius);
+    const std::vector<MapRect> aroundCamera = m_world->EnsureAround(m_map,
+        static_cast<int>(std::floor(cameraTile.x)), static_cast<int>(std::floor(cameraTile.y)), radius);
+    generated.insert(generated.end(), aroundCamera.begin(), aroundCamera.end());
+    
+    // New chunks were solid wall until now, so nothing stands in them yet
+    const size_t firstNew = m_enemies.size();
+    for (const MapRect& chunk : generated) {
+        SpawnEnemies(m_mapConfig.GetEffectiveSpawnRate(), chunk);
+    }
+    for (size_t i = firstNew; i < m_enemies.size(); ++i) {
+        m_occupancy.SetOccupied(m_enemies[i].GetTileX(), m_enemies[i].GetTileY());
     }
 }
 
@@ -427,6 +504,10 @@ void Game::Update(float deltaTime)
 {
     m_player.Update(deltaTime, m_map, m_occupancy);
     
+    if (m_world) {
+        StreamWorld();
+    }
+    
     // Process player punch hit detection
     if (m_player.IsPunching()) {
         Enemy* hitEnemy = m_player.ProcessPunchHit(m_enemies, m_rng);
@@ -449,6 +530,9 @@ void Game::Update(float deltaTime)
             [](const Enemy& e) { return !e.IsAlive(); }),
         m_enemies.end()
     );
+    
+    // Hand this frame's tile edits to map-change subscribers
+    m_map.PublishChanges();
 }
 
 void Game::Render()
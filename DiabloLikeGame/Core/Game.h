@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common/Map.h"
+#include "Common/WorldStreamer.h"
 #include "../Player.h"
 #include "../Enemy.h"
 #include "../Camera/Camera.h"
@@ -8,6 +9,7 @@
 #include "../World/OccupancyMap.h"
 #include "../Config/MapConfig.h"
 #include "GameConfig.h"
+#include <optional>
 #include <vector>
 #include <random>
 
@@ -50,11 +52,18 @@ private:
     // Movement helper - tries diagonal then single axis fallback
     void TryMoveWithFallback(int dx, int dy);
     
-    // Find valid spawn position for player
-    [[nodiscard]] bool FindPlayerSpawnPosition(int& outX, int& outY) const;
+    // Find valid spawn position for player inside `area`
+    [[nodiscard]] bool FindPlayerSpawnPosition(MapRect area, int& outX, int& outY) const;
     
-    // Spawn enemies on floor tiles
-    void SpawnEnemies(float spawnRate);
+    // Spawn enemies on floor tiles inside `area`
+    void SpawnEnemies(float spawnRate, MapRect area);
+    
+    // Part of the map that exists: the whole map, or the generated chunks of a streamed world
+    [[nodiscard]] MapRect GetPlayableArea() const noexcept;
+    
+    // Streamed worlds: generate chunks around the player and the camera, and
+    // populate newly generated chunks with enemies
+    void StreamWorld();
     
     // Initialize occupancy map with all entity positions
     void InitOccupancyMap();
@@ -67,6 +76,7 @@ private:
     IsometricRenderer m_renderer{};
     OccupancyMap m_occupancy{};
     MapConfig m_mapConfig{};  // Current map's configuration
+    std::optional<WorldStreamer> m_world{};  // Set when the map is a streamed world
     
     // Random number generator
     std::mt19937 m_rng;
@@ -1,22 +1,39 @@
 #include "TileConstants.h"
-#include "IniParser.h"
+
+namespace {
+    TileColor ToTileColor(Color color) {
+        return {color.r, color.g, color.b, color.a};
+    }
+}
 
 bool TileColors::Load(const char* filename) {
-    IniParser ini;
-    if (!ini.Load(filename)) {
+    return TileConfig::Load(filename);
+}
+
+bool TileConfig::Load(const char* filename) {
+    // Start from the current tables so missing keys keep their values
+    TileSettings settings;
+    for (size_t id = 0; id < settings.properties.size(); ++id) {
+        const TileStyle& style = TileColors::s_styles[id];
+        settings.properties[id] = TileTable::Get(static_cast<TileType>(id));
+        settings.colors[id] = {ToTileColor(style.fill), ToTileColor(style.outline), ToTileColor(style.top),
+                               ToTileColor(style.left), ToTileColor(style.right)};
+    }
+    settings.shadow = ToTileColor(TileColors::s_shadow);
+    settings.pathLine = ToTileColor(TileColors::s_pathLine);
+
+    if (!LoadTileSettings(filename, settings)) {
         return false;  // Use defaults if file not found
     }
-    
-    // Colors
-    s_floorFill = ini.GetColor("Colors", "FloorFill", s_floorFill);
-    s_floorOutline = ini.GetColor("Colors", "FloorOutline", s_floorOutline);
-    s_wallTop = ini.GetColor("Colors", "WallTop", s_wallTop);
-    s_wallLeft = ini.GetColor("Colors", "WallLeft", s_wallLeft);
-    s_wallRight = ini.GetColor("Colors", "WallRight", s_wallRight);
-    s_waterFill = ini.GetColor("Colors", "WaterFill", s_waterFill);
-    s_waterOutline = ini.GetColor("Colors", "WaterOutline", s_waterOutline);
-    s_shadow = ini.GetColor("Colors", "Shadow", s_shadow);
-    s_pathLine = ini.GetColor("Colors", "PathLine", s_pathLine);
-    
+
+    for (size_t id = 0; id < settings.properties.size(); ++id) {
+        const TileColorSet& colors = settings.colors[id];
+        TileTable::Set(static_cast<TileType>(id), settings.properties[id]);
+        TileColors::s_styles[id] = {TileColors::ToColor(colors.fill), TileColors::ToColor(colors.outline),
+                                    TileColors::ToColor(colors.top), TileColors::ToColor(colors.left),
+                                    TileColors::ToColor(colors.right)};
+    }
+    TileColors::s_shadow = TileColors::ToColor(settings.shadow);
+    TileColors::s_pathLine = TileColors::ToColor(settings.pathLine);
     return true;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "raylib.h"
+#include "Common/TileProperties.h"
+#include <array>
 
 // Isometric tile dimensions (compile-time constants)
 namespace TileConstants {
@@ -9,29 +11,61 @@ namespace TileConstants {
     inline constexpr int TILE_DEPTH = 20;
 }
 
+// Colors used to draw one tile type (which ones apply depends on its render class)
+struct TileStyle {
+    Color fill;      // Ground tiles
+    Color outline;
+    Color top;       // Block tiles
+    Color left;
+    Color right;
+};
+
 // Tile colors - can be loaded from config/tiles.ini
 class TileColors {
 public:
+    // Loads the whole tile configuration (see TileConfig::Load)
     static bool Load(const char* filename = "config/tiles.ini");
-    
-    static Color FloorFill() { return s_floorFill; }
-    static Color FloorOutline() { return s_floorOutline; }
-    static Color WallTop() { return s_wallTop; }
-    static Color WallLeft() { return s_wallLeft; }
-    static Color WallRight() { return s_wallRight; }
-    static Color WaterFill() { return s_waterFill; }
-    static Color WaterOutline() { return s_waterOutline; }
+
+    // Style for any tile byte (one indexed load)
+    static const TileStyle& Style(TileType tile) { return s_styles[static_cast<uint8_t>(tile)]; }
+    static void SetStyle(TileType tile, const TileStyle& style) { s_styles[static_cast<uint8_t>(tile)] = style; }
+
+    static Color FloorFill() { return Style(TileType::Floor).fill; }
+    static Color FloorOutline() { return Style(TileType::Floor).outline; }
+    static Color WallTop() { return Style(TileType::Wall).top; }
+    static Color WallLeft() { return Style(TileType::Wall).left; }
+    static Color WallRight() { return Style(TileType::Wall).right; }
+    static Color WaterFill() { return Style(TileType::Water).fill; }
+    static Color WaterOutline() { return Style(TileType::Water).outline; }
     static Color Shadow() { return s_shadow; }
     static Color PathLine() { return s_pathLine; }
 
 private:
-    inline static Color s_floorFill = {60, 60, 65, 255};
-    inline static Color s_floorOutline = {40, 40, 45, 255};
-    inline static Color s_wallTop = {100, 100, 110, 255};
-    inline static Color s_wallLeft = {70, 70, 80, 255};
-    inline static Color s_wallRight = {85, 85, 95, 255};
-    inline static Color s_waterFill = {50, 100, 150, 200};
-    inline static Color s_waterOutline = {30, 80, 130, 200};
-    inline static Color s_shadow = {0, 0, 0, 80};
-    inline static Color s_pathLine = {144, 238, 144, 200};
+    friend class TileConfig;
+
+    static constexpr Color ToColor(TileColor color) { return {color.r, color.g, color.b, color.a}; }
+
+    // Built-in colors (TileSettings defaults, shared with the map tools)
+    static std::array<TileStyle, 256> MakeDefaultStyles() {
+        const auto colors = TileSettings::MakeDefaultColors();
+        std::array<TileStyle, 256> styles{};
+        for (size_t id = 0; id < styles.size(); ++id) {
+            styles[id] = {ToColor(colors[id].fill), ToColor(colors[id].outline), ToColor(colors[id].top),
+                          ToColor(colors[id].left), ToColor(colors[id].right)};
+        }
+        return styles;
+    }
+
+    inline static std::array<TileStyle, 256> s_styles = MakeDefaultStyles();
+    inline static Color s_shadow = ToColor(TileSettings{}.shadow);
+    inline static Color s_pathLine = ToColor(TileSettings{}.pathLine);
+};
+
+// Loads tile properties (TileTable) and colors (TileColors) from tiles.ini
+//
+// The file format is LoadTileSettings' (Common/TileProperties.h). Missing
+// keys keep their current values. Call before building or loading maps.
+class TileConfig {
+public:
+    static bool Load(const char* filename = "config/tiles.ini");
 };
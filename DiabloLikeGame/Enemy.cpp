@@ -294,6 +294,11 @@ bool Enemy::TryMoveOneStep(const Map& map, OccupancyMap& occupancy, std::mt19937
     const int currentX = GetTileX();
     const int currentY = GetTileY();
     
+    // Neighbours of an in-bounds tile are tested without bounds checks below
+    if (!map.IsInBounds(currentX, currentY)) {
+        return false;
+    }
+    
     // Try each direction in random order
     for (int dir : directions) {
         const int newX = currentX + dx[dir];
@@ -308,7 +313,7 @@ bool Enemy::TryMoveOneStep(const Map& map, OccupancyMap& occupancy, std::mt19937
         }
         
         // Check if tile is walkable
-        if (!Pathfinder::IsTileWalkable(map, newX, newY)) {
+        if (!Pathfinder::IsNeighborWalkable(map, newX, newY)) {
             continue;
         }
         
@@ -320,8 +325,8 @@ bool Enemy::TryMoveOneStep(const Map& map, OccupancyMap& occupancy, std::mt19937
         // For diagonal moves, check corner cutting
         const bool isDiagonal = (dx[dir] != 0 && dy[dir] != 0);
         if (isDiagonal) {
-            if (!Pathfinder::IsTileWalkable(map, currentX + dx[dir], currentY) ||
-                !Pathfinder::IsTileWalkable(map, currentX, currentY + dy[dir])) {
+            if (!Pathfinder::IsNeighborWalkable(map, currentX + dx[dir], currentY) ||
+                !Pathfinder::IsNeighborWalkable(map, currentX, currentY + dy[dir])) {
                 continue;
             }
         }
@@ -436,6 +441,11 @@ bool Enemy::TryMoveAwayFrom(int threatX, int threatY, const Map& map,
     const int awayX = (currentX > threatX) ? 1 : (currentX < threatX) ? -1 : 0;
     const int awayY = (currentY > threatY) ? 1 : (currentY < threatY) ? -1 : 0;
     
+    // Neighbours of an in-bounds tile are tested without bounds checks below
+    if (!map.IsInBounds(currentX, currentY)) {
+        return false;
+    }
+    
     // Static array of escape directions (avoid allocation)
     // Order: direct away, perpendicular variations, then side moves
     static constexpr int kMaxDirections = 9;
@@ -481,13 +491,13 @@ bool Enemy::TryMoveAwayFrom(int threatX, int threatY, const Map& map,
         const int newX = currentX + dx;
         const int newY = currentY + dy;
         
-        if (!Pathfinder::IsTileWalkable(map, newX, newY)) continue;
+        if (!Pathfinder::IsNeighborWalkable(map, newX, newY)) continue;
         if (occupancy.IsOccupied(newX, newY)) continue;
         
         const bool isDiagonal = (dx != 0 && dy != 0);
         if (isDiagonal) {
-            if (!Pathfinder::IsTileWalkable(map, currentX + dx, currentY) ||
-                !Pathfinder::IsTileWalkable(map, currentX, currentY + dy)) {
+            if (!Pathfinder::IsNeighborWalkable(map, currentX + dx, currentY) ||
+                !Pathfinder::IsNeighborWalkable(map, currentX, currentY + dy)) {
                 continue;
             }
         }
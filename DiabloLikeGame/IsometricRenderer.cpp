@@ -382,25 +382,22 @@ void IsometricRenderer::DrawMap(const Map& map) const
     int startX, startY, endX, endY;
     GetVisibleTileRange(map, startX, startY, endX, endY);
     
-    for (int y = startY; y <= endY; ++y) {
-        for (int x = startX; x <= endX; ++x) {
-            if (!IsTileVisible(x, y)) continue;
-            
-            switch (map.GetTileUnchecked(x, y)) {
-                case TileType::Empty:
-                    break;
-                case TileType::Floor:
-                    DrawTile(x, y, TileColors::FloorFill(), TileColors::FloorOutline());
-                    break;
-                case TileType::Wall:
-                    DrawBlock(x, y, TileColors::WallTop(), TileColors::WallLeft(), TileColors::WallRight());
-                    break;
-                case TileType::Water:
-                    DrawTile(x, y, TileColors::WaterFill(), TileColors::WaterOutline());
-                    break;
-            }
+    const MapRect visible{startX, startY, endX - startX + 1, endY - startY + 1};
+    map.ForEachInRect(visible, [this](int x, int y, TileType tile) {
+        if (!IsTileVisible(x, y)) return;
+        
+        const TileStyle& style = TileColors::Style(tile);
+        switch (TileTable::Get(tile).renderClass) {
+            case TileRenderClass::None:
+                break;
+            case TileRenderClass::Ground:
+                DrawTile(x, y, style.fill, style.outline);
+                break;
+            case TileRenderClass::Block:
+                DrawBlock(x, y, style.top, style.left, style.right);
+                break;
         }
-    }
+    });
 }
 
 void IsometricRenderer::DrawScene(const Map& map, const Player& player, Color playerColor,
@@ -409,29 +406,18 @@ void IsometricRenderer::DrawScene(const Map& map, const Player& player, Color pl
     int startX, startY, endX, endY;
     GetVisibleTileRange(map, startX, startY, endX, endY);
     
-    // Cache colors to avoid method calls in tight loops
-    const Color floorFill = TileColors::FloorFill();
-    const Color floorOutline = TileColors::FloorOutline();
-    const Color wallTop = TileColors::WallTop();
-    const Color wallLeft = TileColors::WallLeft();
-    const Color wallRight = TileColors::WallRight();
-    const Color waterFill = TileColors::WaterFill();
-    const Color waterOutline = TileColors::WaterOutline();
     const Color pathLine = TileColors::PathLine();
     
-    // Pass 1: Draw all floor and water tiles (ground layer)
-    for (int y = startY; y <= endY; ++y) {
-        for (int x = startX; x <= endX; ++x) {
-            if (!IsTileVisible(x, y)) continue;
-            
-            const TileType tile = map.GetTileUnchecked(x, y);
-            if (tile == TileType::Floor) {
-                DrawTile(x, y, floorFill, floorOutline);
-            } else if (tile == TileType::Water) {
-                DrawTile(x, y, waterFill, waterOutline);
-            }
-        }
-    }
+    // Pass 1: Draw all ground tiles (floor, water, ...); render class and
+    // colors come from the per-tile tables
+    const MapRect visible{startX, startY, endX - startX + 1, endY - startY + 1};
+    map.ForEachInRect(visible, [this](int x, int y, TileType tile) {
+        if (TileTable::Get(tile).renderClass != TileRenderClass::Ground) return;
+        if (!IsTileVisible(x, y)) return;
+        
+        const TileStyle& style = TileColors::Style(tile);
+        DrawTile(x, y, style.fill, style.outline);
+    });
     
     // Pass 1.5: Draw pathfinding visualization on ground
     DrawPath(player, pathLine);
@@ -487,14 +473,16 @@ void IsometricRenderer::DrawScene(const Map& map, const Player& player, Color pl
     // Iterate through tile rows in depth order (x + y = constant defines a row)
     // Min depth is startX + startY, max depth is endX + endY
     for (int depth = startX + startY; depth <= endX + endY; ++depth) {
-        // Draw all walls at this depth
+        // Draw all blocks (walls) at this depth
         for (int x = std::max(startX, depth - endY); x <= std::min(endX, depth - startY); ++x) {
             const int y = depth - x;
             if (y < startY || y > endY) continue;
             if (!IsTileVisible(x, y)) continue;
-            if (map.GetTileUnchecked(x, y) != TileType::Wall) continue;
+            const TileType tile = map.GetTileUnchecked(x, y);
+            if (TileTable::Get(tile).renderClass != TileRenderClass::Block) continue;
             
-            DrawBlock(x, y, wallTop, wallLeft, wallRight);
+            const TileStyle& style = TileColors::Style(tile);
+            DrawBlock(x, y, style.top, style.left, style.right);
         }
         
         // Draw all entities at this depth (entities with depth in [depth, depth+1))
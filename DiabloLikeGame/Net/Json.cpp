@@ -1,6 +1,7 @@
 #include "Json.h"
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 
 namespace Json {
 
@@ -1,6 +1,69 @@
 #include "NetMessage.h"
+#include "Common/Map.h"
+#include "Common/SeededMap.h"
 #include <stdexcept>
 
+namespace {
+
+constexpr char kBase64Chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string EncodeBase64(const std::vector<uint8_t>& bytes) {
+    std::string out;
+    out.reserve((bytes.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < bytes.size(); i += 3) {
+        const uint32_t n = (static_cast<uint32_t>(bytes[i]) << 16) |
+                           (static_cast<uint32_t>(bytes[i + 1]) << 8) | bytes[i + 2];
+        out.push_back(kBase64Chars[(n >> 18) & 63]);
+        out.push_back(kBase64Chars[(n >> 12) & 63]);
+        out.push_back(kBase64Chars[(n >> 6) & 63]);
+        out.push_back(kBase64Chars[n & 63]);
+    }
+    if (i < bytes.size()) {
+        const bool two = i + 1 < bytes.size();
+        const uint32_t n = (static_cast<uint32_t>(bytes[i]) << 16) |
+                           (two ? static_cast<uint32_t>(bytes[i + 1]) << 8 : 0u);
+        out.push_back(kBase64Chars[(n >> 18) & 63]);
+        out.push_back(kBase64Chars[(n >> 12) & 63]);
+        out.push_back(two ? kBase64Chars[(n >> 6) & 63] : '=');
+        out.push_back('=');
+    }
+    return out;
+}
+
+std::vector<uint8_t> DecodeBase64(const std::string& text) {
+    auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    };
+    
+    std::vector<uint8_t> out;
+    out.reserve(text.size() / 4 * 3);
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (char c : text) {
+        if (c == '=') break;
+        const int v = value(c);
+        if (v < 0) {
+            throw std::runtime_error("Invalid base64 character");
+        }
+        bits = (bits << 6) | static_cast<uint32_t>(v);
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            out.push_back(static_cast<uint8_t>(bits >> bitCount));
+        }
+    }
+    return out;
+}
+
+} // namespace
+
 namespace NetMessage {
 
 // ============== PlayerInput ==============
@@ -218,6 +281,64 @@ WorldSnapshot WorldSnapshot::FromJson(const Json::Value& json) {
     return snapshot;
 }
 
+// ============== MapData ==============
+
+MapData MapData::FromMap(const Map& map) {
+    MapData data;
+    data.name = map.GetName();
+    data.width = map.GetWidth();
+    data.height = map.GetHeight();
+    data.tiles = map.EncodeRle();
+    return data;
+}
+
+MapData MapData::FromSeededMap(const SeededMap& map) {
+    MapData data;
+    data.width = map.GetConfig().width;
+    data.height = map.GetConfig().height;
+    data.seeded = map.Encode();
+    return data;
+}
+
+bool MapData::ApplyTo(Map& map) const {
+    if (width > kMaxDimension || height > kMaxDimension) {
+        return false;
+    }
+    if (!seeded.empty()) {
+        auto decoded = SeededMap::Decode(seeded);
+        if (!decoded || decoded->GetConfig().width != width || decoded->GetConfig().height != height) {
+            return false;
+        }
+        map = decoded->Materialize();
+        return true;
+    }
+    return map.InitFromRle(name, width, height, tiles);
+}
+
+Json::Value MapData::ToJson() const {
+    auto builder = Json::MakeObject()
+        .Add("name", name)
+        .Add("width", width)
+        .Add("height", height)
+        .Add("tiles", EncodeBase64(tiles));
+    if (!seeded.empty()) {
+        builder.Add("seeded", EncodeBase64(seeded));
+    }
+    return builder.Build();
+}
+
+MapData MapData::FromJson(const Json::Value& json) {
+    MapData data;
+    data.name = json["name"].AsString();
+    data.width = static_cast<int>(json["width"].AsInt());
+    data.height = static_cast<int>(json["height"].AsInt());
+    data.tiles = DecodeBase64(json["tiles"].AsString());
+    if (json.Has("seeded")) {
+        data.seeded = DecodeBase64(json["seeded"].AsString());
+    }
+    return data;
+}
+
 // ============== Handshake ==============
 
 Json::Value Handshake::ToJson() const {
@@ -295,6 +416,9 @@ std::optional<Message> Message::Deserialize(const std::string& jsonStr) {
             case Type::WorldSnapshot:
                 msg.data = WorldSnapshot::FromJson(dataJson);
                 break;
+            case Type::MapData:
+                msg.data = MapData::FromJson(dataJson);
+                break;
             case Type::Handshake:
                 msg.data = Handshake::FromJson(dataJson);
                 break;
@@ -9,6 +9,9 @@
 #include <variant>
 #include <optional>
 
+class Map;
+class SeededMap;
+
 // Network message types for client-server communication
 // 
 // Architecture: Messages follow a command pattern where:
@@ -200,6 +203,39 @@ struct WorldSnapshot {
     static WorldSnapshot FromJson(const Json::Value& json);
 };
 
+// Map tiles (sent on join or map change)
+// Tiles travel as a MapRle run-length stream, base64-encoded in the JSON body.
+// Generated levels can travel as a SeededMap payload (generator Config plus
+// edited tiles) instead, which the receiver regenerates: a few dozen bytes.
+struct MapData {
+    static constexpr Type kType = Type::MapData;
+    
+    std::string name;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> tiles;    // MapRle stream, row-major
+    std::vector<uint8_t> seeded;   // SeededMap::Encode payload (used instead of tiles if set)
+    
+    // Largest width or height ApplyTo accepts (the CLI's generation limit).
+    // A few bytes from a peer must not make the client decode or generate a
+    // huge map; local files have only Map::kMaxDecodedTiles.
+    static constexpr int kMaxDimension = 10000;
+    
+    // Encode a map for transfer
+    static MapData FromMap(const Map& map);
+    
+    // Encode a generated map by its Config and edits
+    static MapData FromSeededMap(const SeededMap& map);
+    
+    // Decode into `map`; fails (leaving it unchanged) if the tile stream or
+    // seeded payload is invalid or either dimension exceeds kMaxDimension.
+    // Seeded maps take the generator's map name.
+    [[nodiscard]] bool ApplyTo(Map& map) const;
+    
+    [[nodiscard]] Json::Value ToJson() const;
+    static MapData FromJson(const Json::Value& json);
+};
+
 // Connection handshake
 struct Handshake {
     static constexpr Type kType = Type::Handshake;
@@ -233,6 +269,7 @@ using MessageData = std::variant<
     EntityDamage,
     EntityDeath,
     WorldSnapshot,
+    MapData,
     Handshake
 >;
 
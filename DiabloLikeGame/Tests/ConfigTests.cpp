@@ -1,6 +1,9 @@
 #include "CppUnitTest.h"
 #include "../Core/GameConfig.h"
 #include "../Core/TileConstants.h"
+#include "Common/Map.h"
+#include <filesystem>
+#include <fstream>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -84,6 +87,97 @@ namespace ConfigTests
         }
     };
 
+    TEST_CLASS(TileConfigTests)
+    {
+    public:
+        static constexpr const char* TEST_INI_FILE = "test_tiles_temp.ini";
+
+        TEST_METHOD_CLEANUP(Cleanup)
+        {
+            std::filesystem::remove(TEST_INI_FILE);
+            TileTable::Reset();
+        }
+
+        static void WriteIni(const char* content)
+        {
+            std::ofstream file(TEST_INI_FILE);
+            file << content;
+        }
+
+        TEST_METHOD(DefaultsMatchBuiltInTiles)
+        {
+            Assert::IsTrue(TileTable::IsWalkable(TileType::Floor));
+            Assert::IsFalse(TileTable::IsWalkable(TileType::Wall));
+            Assert::IsFalse(TileTable::IsWalkable(TileType::Water));
+            Assert::IsFalse(TileTable::IsWalkable(TileType::Empty));
+            Assert::IsTrue(TileTable::Get(TileType::Wall).blocksSight);
+            Assert::IsTrue(TileRenderClass::Block == TileTable::Get(TileType::Wall).renderClass);
+            Assert::IsTrue(TileRenderClass::Ground == TileTable::Get(TileType::Water).renderClass);
+            Assert::IsTrue(TileRenderClass::None == TileTable::Get(static_cast<TileType>(200)).renderClass);
+        }
+
+        TEST_METHOD(LoadDefinesNewTileType)
+        {
+            WriteIni("[Tile.4]\nWalkable=true\nMoveCost=3\nRender=Ground\nFill=180,60,20,255\n");
+            Assert::IsTrue(TileConfig::Load(TEST_INI_FILE));
+
+            const TileType lava = static_cast<TileType>(4);
+            Assert::IsTrue(TileTable::IsWalkable(lava));
+            Assert::AreEqual(3.0f, TileTable::Get(lava).moveCost);
+            Assert::IsTrue(TileRenderClass::Ground == TileTable::Get(lava).renderClass);
+            Assert::AreEqual(static_cast<int>(180), static_cast<int>(TileColors::Style(lava).fill.r));
+        }
+
+        TEST_METHOD(LoadOverridesBuiltInTile)
+        {
+            WriteIni("[Tile.3]\nWalkable=true\nMoveCost=0.5\n");
+            Assert::IsTrue(TileConfig::Load(TEST_INI_FILE));
+
+            Assert::IsTrue(TileTable::IsWalkable(TileType::Water));
+            Assert::AreEqual(1.0f, TileTable::Get(TileType::Water).moveCost);  // Clamped to 1
+            Assert::IsTrue(TileRenderClass::Ground == TileTable::Get(TileType::Water).renderClass);
+        }
+
+        TEST_METHOD(GameColorsStartFromSharedDefaults)
+        {
+            const TileSettings defaults;
+            const TileColor wallTop = defaults.colors[static_cast<uint8_t>(TileType::Wall)].top;
+            Assert::AreEqual(static_cast<int>(wallTop.r), static_cast<int>(TileColors::WallTop().r));
+            Assert::AreEqual(static_cast<int>(wallTop.b), static_cast<int>(TileColors::WallTop().b));
+            Assert::AreEqual(static_cast<int>(defaults.shadow.a), static_cast<int>(TileColors::Shadow().a));
+        }
+
+        TEST_METHOD(LoadTileSettingsKeepsMissingKeys)
+        {
+            WriteIni("[Colors]\nWallTop=1,2,3\n[Tile.5]\nRender=Block ; raised\nTop=300,20,30,40\n");
+            TileSettings settings;
+            Assert::IsTrue(LoadTileSettings(TEST_INI_FILE, settings));
+
+            const TileColorSet& wall = settings.colors[static_cast<uint8_t>(TileType::Wall)];
+            Assert::AreEqual(3, static_cast<int>(wall.top.b));
+            Assert::AreEqual(255, static_cast<int>(wall.top.a));
+            Assert::AreEqual(70, static_cast<int>(wall.left.r));    // Default kept
+            Assert::IsTrue(TileRenderClass::Block == settings.properties[5].renderClass);
+            Assert::AreEqual(255, static_cast<int>(settings.colors[5].top.r));  // Clamped
+            Assert::AreEqual(40, static_cast<int>(settings.colors[5].top.a));
+            Assert::IsFalse(settings.properties[5].walkable);
+            Assert::IsFalse(TileTable::IsWalkable(static_cast<TileType>(5)));   // Game tables untouched
+            Assert::IsFalse(LoadTileSettings("missing_tiles.ini", settings));
+        }
+
+        TEST_METHOD(MapWalkabilityFollowsTable)
+        {
+            TileProperties water = TileTable::Get(TileType::Water);
+            water.walkable = true;
+            TileTable::Set(TileType::Water, water);
+
+            Map map;
+            map.Init("Water", 2, 1, {TileType::Water, TileType::Wall});
+            Assert::IsTrue(map.IsWalkable(0, 0));
+            Assert::IsFalse(map.IsWalkable(1, 0));
+        }
+    };
+
     TEST_CLASS(InputModeTests)
     {
     public:
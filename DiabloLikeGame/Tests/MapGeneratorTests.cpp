@@ -1,11 +1,46 @@
 #include "CppUnitTest.h"
 #include "../World/MapGenerator.h"
 #include "../World/Pathfinder.h"
+#include "Common/CounterRng.h"
+#include "Common/MapCache.h"
+#include "Common/MapStreamWriter.h"
+#include "Common/SeededMap.h"
+#include "Common/WallBitboard.h"
+#include "Common/WorldStreamer.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <span>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace MapGeneratorTests
 {
+    // Helper to create a fixed-seed config (reproducible, cacheable, seedable)
+    MapGenerator::Config SeededConfig(unsigned seed, int width = 80, int height = 50)
+    {
+        MapGenerator::Config config;
+        config.width = width;
+        config.height = height;
+        config.seed = seed;
+        return config;
+    }
+
+    // Helper to compare every tile of two maps
+    void AssertSameTiles(const Map& expected, const Map& actual)
+    {
+        Assert::AreEqual(expected.GetWidth(), actual.GetWidth());
+        Assert::AreEqual(expected.GetHeight(), actual.GetHeight());
+        for (int y = 0; y < expected.GetHeight(); ++y) {
+            for (int x = 0; x < expected.GetWidth(); ++x) {
+                Assert::IsTrue(expected.GetTile(x, y) == actual.GetTile(x, y));
+            }
+        }
+    }
+
     TEST_CLASS(GenerateBasicTests)
     {
     public:
@@ -253,5 +288,1010 @@ namespace MapGeneratorTests
             Assert::AreEqual(500, map.GetWidth());
             Assert::AreEqual(500, map.GetHeight());
         }
+
+        TEST_METHOD(LargePresetEncodesToKilobytes)
+        {
+            MapGenerator::Config config;
+            config.width = 400;
+            config.height = 400;
+            config.smoothIterations = 6;
+            config.waterChance = 0.03f;
+            config.seed = 12345;
+            auto map = MapGenerator::Generate(config);
+
+            // 160,000 tiles; caves are long runs of Wall/Floor
+            Assert::IsTrue(map.EncodeRle().size() < 48 * 1024);
+        }
+    };
+
+    TEST_CLASS(BitboardSmoothingTests)
+    {
+    public:
+        static std::vector<TileType> RandomWalls(int width, int height, unsigned seed)
+        {
+            std::mt19937 rng(seed);
+            std::vector<TileType> tiles(static_cast<size_t>(width) * static_cast<size_t>(height));
+            for (auto& tile : tiles) {
+                tile = rng() % 2 ? TileType::Wall : TileType::Floor;
+            }
+            return tiles;
+        }
+
+        TEST_METHOD(PackingRoundTrips)
+        {
+            const auto tiles = RandomWalls(130, 7, 1);
+            const WallBitboard board = WallBitboard::FromTiles(tiles, 130, 7);
+            Assert::AreEqual(3, board.GetWordsPerRow());
+
+            std::vector<TileType> unpacked(tiles.size());
+            board.ToTiles(unpacked);
+            Assert::IsTrue(tiles == unpacked);
+            Assert::AreEqual(tiles[6 * 130 + 129] == TileType::Wall, board.IsWall(129, 6));
+        }
+
+        TEST_METHOD(SmoothMatchesScalarForEveryThreshold)
+        {
+            const int sizes[][2] = {{1, 1}, {2, 5}, {3, 3}, {63, 9}, {64, 8}, {65, 11}, {130, 20}, {200, 3}};
+            unsigned seed = 0;
+            for (const auto& size : sizes) {
+                const int width = size[0];
+                const int height = size[1];
+                for (int threshold = -1; threshold <= 9; ++threshold) {
+                    const auto tiles = RandomWalls(width, height, ++seed);
+                    std::vector<TileType> expected(tiles.size());
+                    MapGenerator::SmoothMap(tiles, expected, width, height, threshold);
+
+                    WallBitboard smoothed;
+                    WallBitboard::FromTiles(tiles, width, height).Smooth(smoothed, threshold);
+                    std::vector<TileType> actual(tiles.size());
+                    smoothed.ToTiles(actual);
+                    Assert::IsTrue(expected == actual);
+                }
+            }
+        }
+
+        TEST_METHOD(GenerateMatchesScalarPipeline)
+        {
+            // Step 1 of Generate, then the scalar smoothing passes
+            MapGenerator::Config config;
+            config.width = 150;
+            config.height = 97;
+            config.seed = 2024;
+            config.waterChance = 0.0f;
+            config.algorithm = MapGenerator::Algorithm::Sequential;
+
+            std::mt19937 rng(config.seed);
+            std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+            std::vector<TileType> tiles(static_cast<size_t>(config.width * config.height));
+            for (int y = 0; y < config.height; ++y) {
+                for (int x = 0; x < config.width; ++x) {
+                    const bool border = x == 0 || x == config.width - 1 || y == 0 || y == config.height - 1;
+                    tiles[static_cast<size_t>(y * config.width + x)] =
+                        border || dist(rng) < config.wallDensity ? TileType::Wall : TileType::Floor;
+                }
+            }
+            std::vector<TileType> buffer(tiles.size());
+            for (int i = 0; i < config.smoothIterations; ++i) {
+                MapGenerator::SmoothMap(tiles, buffer, config.width, config.height, config.wallThreshold);
+                std::swap(tiles, buffer);
+            }
+
+            const Map map = MapGenerator::Generate(config);
+            for (int y = 0; y < config.height; ++y) {
+                for (int x = 0; x < config.width; ++x) {
+                    Assert::IsTrue(tiles[static_cast<size_t>(y * config.width + x)] == map.GetTile(x, y));
+                }
+            }
+        }
+    };
+
+    TEST_CLASS(ParallelGenerationTests)
+    {
+    public:
+        TEST_METHOD(OutputIndependentOfThreadCount)
+        {
+            MapGenerator::Config config;
+            config.width = 301;
+            config.height = 517;
+            config.seed = 99;
+            const Map serial = MapGenerator::Generate(config);
+
+            for (const unsigned threads : {2u, 3u, 7u, 0u}) {
+                config.threadCount = threads;
+                AssertSameTiles(serial, MapGenerator::Generate(config));
+            }
+        }
+
+        TEST_METHOD(SequentialOutputIndependentOfThreadCount)
+        {
+            MapGenerator::Config config;
+            config.width = 180;
+            config.height = 300;
+            config.seed = 99;
+            config.algorithm = MapGenerator::Algorithm::Sequential;
+            const Map serial = MapGenerator::Generate(config);
+
+            config.threadCount = 4;
+            AssertSameTiles(serial, MapGenerator::Generate(config));
+        }
+
+        TEST_METHOD(MoreThreadsThanRowsIsSafe)
+        {
+            MapGenerator::Config config;
+            config.width = 40;
+            config.height = 12;
+            config.seed = 5;
+            const Map serial = MapGenerator::Generate(config);
+
+            config.threadCount = 64;
+            AssertSameTiles(serial, MapGenerator::Generate(config));
+        }
+    };
+
+    TEST_CLASS(CounterHashAlgorithmTests)
+    {
+    public:
+        TEST_METHOD(DrawsDependOnlyOnKey)
+        {
+            const uint64_t fill = CounterRng::StreamKey(7, 0);
+            Assert::AreEqual(CounterRng::Hash(fill, 12, 34), CounterRng::Hash(fill, 12, 34));
+            Assert::AreNotEqual(CounterRng::Hash(fill, 12, 34), CounterRng::Hash(fill, 34, 12));
+            Assert::AreNotEqual(CounterRng::Hash(fill, 12, 34), CounterRng::Hash(CounterRng::StreamKey(7, 1), 12, 34));
+            Assert::AreNotEqual(CounterRng::Hash(fill, 12, 34), CounterRng::Hash(CounterRng::StreamKey(8, 0), 12, 34));
+        }
+
+        TEST_METHOD(UnitFloatsAreUniform)
+        {
+            const uint64_t stream = CounterRng::StreamKey(123, 0);
+            int buckets[10]{};
+            for (int y = 0; y < 100; ++y) {
+                for (int x = 0; x < 100; ++x) {
+                    const float value = CounterRng::ToUnitFloat(CounterRng::Hash(stream, x, y));
+                    Assert::IsTrue(value >= 0.0f && value < 1.0f);
+                    ++buckets[static_cast<int>(value * 10.0f)];
+                }
+            }
+            for (const int count : buckets) {
+                Assert::IsTrue(count > 900 && count < 1100);
+            }
+        }
+
+        TEST_METHOD(InitialFillIsPerTile)
+        {
+            // Without smoothing the fill of an interior tile ignores the map size
+            MapGenerator::Config small;
+            small.width = 60;
+            small.height = 40;
+            small.seed = 31;
+            small.smoothIterations = 0;
+            small.waterChance = 0.0f;
+            MapGenerator::Config large = small;
+            large.width = 200;
+            large.height = 90;
+
+            const Map a = MapGenerator::Generate(small);
+            const Map b = MapGenerator::Generate(large);
+            for (int y = 1; y < small.height - 1; ++y) {
+                for (int x = 1; x < small.width - 1; ++x) {
+                    Assert::IsTrue(a.GetTile(x, y) == b.GetTile(x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(AlgorithmsDifferForTheSameSeed)
+        {
+            MapGenerator::Config config;
+            config.width = 80;
+            config.height = 60;
+            config.seed = 11;
+            const Map hashed = MapGenerator::Generate(config);
+            config.algorithm = MapGenerator::Algorithm::Sequential;
+            const Map sequential = MapGenerator::Generate(config);
+
+            bool differs = false;
+            for (int y = 0; y < 60 && !differs; ++y) {
+                for (int x = 0; x < 80 && !differs; ++x) {
+                    differs = hashed.GetTile(x, y) != sequential.GetTile(x, y);
+                }
+            }
+            Assert::IsTrue(differs);
+        }
+
+        TEST_METHOD(HashedWaterPoolsAppear)
+        {
+            MapGenerator::Config config;
+            config.width = 200;
+            config.height = 200;
+            config.seed = 4;
+            config.waterChance = 0.05f;
+            const Map map = MapGenerator::Generate(config);
+
+            int water = 0;
+            for (int y = 0; y < 200; ++y) {
+                for (int x = 0; x < 200; ++x) {
+                    water += map.GetTile(x, y) == TileType::Water;
+                }
+            }
+            Assert::IsTrue(water > 0);
+        }
+    };
+
+    TEST_CLASS(WaterPlacementTests)
+    {
+    public:
+        TEST_METHOD(PoolRateMatchesChance)
+        {
+            // On open floor nearly every trial lands on floor, so there are
+            // about chance * candidates pools (size 2-3 pools are 3x3, 4-5 are 5x5)
+            constexpr int kSize = 1010;
+            std::vector<TileType> tiles(kSize * kSize, TileType::Floor);
+            std::mt19937 rng(42);
+            MapGenerator::AddWaterPoolsSkipAhead(tiles, kSize, kSize, 0.001f, rng);
+
+            int water = 0;
+            for (int y = 0; y < kSize; ++y) {
+                for (int x = 0; x < kSize; ++x) {
+                    if (tiles[y * kSize + x] != TileType::Water) continue;
+                    ++water;
+                    Assert::IsTrue(x >= 3 && x < kSize - 3 && y >= 3 && y < kSize - 3);
+                }
+            }
+            // ~1000 pools of 9 or 25 tiles (mean 17), minus overlaps
+            Assert::IsTrue(water > 13000 && water < 21000);
+        }
+
+        TEST_METHOD(CertainChanceStartsAtFirstCandidate)
+        {
+            constexpr int kSize = 20;
+            std::vector<TileType> tiles(kSize * kSize, TileType::Floor);
+            std::mt19937 rng(7);
+            MapGenerator::AddWaterPoolsSkipAhead(tiles, kSize, kSize, 1.0f, rng);
+            Assert::IsTrue(tiles[5 * kSize + 5] == TileType::Water);
+            Assert::IsTrue(tiles[2 * kSize + 2] == TileType::Floor);
+        }
+
+        TEST_METHOD(TinyChancesPlaceNoPools)
+        {
+            // Gaps far past the map (or the epsilon cut-off) end placement cleanly
+            constexpr int kSize = 200;
+            for (const float chance : {1e-10f, 1e-30f, 1e-45f, 0.0f, -1.0f, std::numeric_limits<float>::quiet_NaN()}) {
+                std::vector<TileType> tiles(kSize * kSize, TileType::Floor);
+                std::mt19937 rng(11);
+                MapGenerator::AddWaterPoolsSkipAhead(tiles, kSize, kSize, chance, rng);
+                Assert::IsTrue(std::find(tiles.begin(), tiles.end(), TileType::Water) == tiles.end());
+            }
+        }
+
+        TEST_METHOD(SequentialMatchesMapsFromBeforeTheHashScheme)
+        {
+            // mapgen -s 12345 -w 40 -h 30 --water 0.05, built from the
+            // original generator (# wall, . floor, ~ water)
+            static const char* const kExpected[] = {
+                "########################################",
+                "##############....#############.....####",
+                "###...########............###.......####",
+                "##.....########.....................####",
+                "##.........######...................####",
+                "##.........~#######....~~~...........###",
+                "##.........~~#######...~~~............##",
+                "##...##....~~~#######..~~~.............#",
+                "##..####...~~~~~######......~~~........#",
+                "##..####...~~~~~~#####......~~~.......##",
+                "##...##~~~.~~~~~~####~~.....~###.....###",
+                "##.....~~~.~~~#~~~##~~~...#######....###",
+                "###....~~~.~~####.~~~~~..#########...###",
+                "#######......#####~~~~~..#########...###",
+                "########.....########~~~..#########...##",
+                "########.....###~~####~~....#######...##",
+                "#######.....###~~~~###~~~~~~.###########",
+                "######.....####~~~~~##.~~~~~~###########",
+                "####.......####~~~~~...~~~~~~~##########",
+                "###........####~~~~~...~~~~~~~~~.#######",
+                "###.........##~~~~~~...~~~~~~~~~~~######",
+                "###..........~~~~~~~.......~~~~~~~######",
+                "###..........~~~~~..##.......~~~~~######",
+                "####.........~~~~~.####......~~~~~.#####",
+                "####.........~~~~~#####......~~~~~.#####",
+                "###..............######............#####",
+                "###.........##..########...###.....#####",
+                "###..##....######################.######",
+                "########################################",
+                "########################################",
+            };
+            MapGenerator::Config config = SeededConfig(12345, 40, 30);
+            config.waterChance = 0.05f;
+            config.algorithm = MapGenerator::Algorithm::Sequential;
+            const Map map = MapGenerator::Generate(config);
+            for (int y = 0; y < 30; ++y) {
+                for (int x = 0; x < 40; ++x) {
+                    const char symbol = map.GetTile(x, y) == TileType::Wall ? '#'
+                                      : map.GetTile(x, y) == TileType::Water ? '~' : '.';
+                    Assert::AreEqual(kExpected[y][x], symbol);
+                }
+            }
+        }
+
+        TEST_METHOD(SkipAheadOnlyChangesTheWater)
+        {
+            MapGenerator::Config config = SeededConfig(321, 120, 90);
+            config.waterChance = 0.05f;
+            config.algorithm = MapGenerator::Algorithm::SequentialSkip;
+            const Map skip = MapGenerator::Generate(config);
+            AssertSameTiles(skip, MapGenerator::Generate(config));
+            config.algorithm = MapGenerator::Algorithm::Sequential;
+            const Map perTile = MapGenerator::Generate(config);
+
+            int water = 0;
+            for (int y = 0; y < config.height; ++y) {
+                for (int x = 0; x < config.width; ++x) {
+                    const bool wall = skip.GetTile(x, y) == TileType::Wall;
+                    Assert::AreEqual(wall, perTile.GetTile(x, y) == TileType::Wall);
+                    water += skip.GetTile(x, y) == TileType::Water;
+                }
+            }
+            Assert::IsTrue(water > 0);
+        }
+    };
+
+    TEST_CLASS(ConnectivityTests)
+    {
+    public:
+        // Two rooms three walls apart: room A is x 1-3, room B x 7-10 (y 1-5)
+        static std::vector<TileType> TwoRooms(int& width, int& height)
+        {
+            width = 12;
+            height = 7;
+            std::vector<TileType> tiles(width * height, TileType::Wall);
+            for (int y = 1; y <= 5; ++y) {
+                for (int x = 1; x <= 10; ++x) {
+                    if (x <= 3 || x >= 7) tiles[y * width + x] = TileType::Floor;
+                }
+            }
+            return tiles;
+        }
+
+        static size_t CountRegions(const std::vector<TileType>& tiles, int width, int height)
+        {
+            Map map;
+            map.Init("Regions", width, height, tiles);
+            map.EnableRegionIndex();
+            return map.GetRegionIndex().GetRegionCount();
+        }
+
+        TEST_METHOD(TunnelCrossesTheFewestWalls)
+        {
+            int width = 0, height = 0;
+            std::vector<TileType> tiles = TwoRooms(width, height);
+            const std::vector<TileType> before = tiles;
+            MapGenerator::ConnectRegions(tiles, width, height, MapGenerator::Connectivity::CarveTunnels, 1);
+
+            Assert::AreEqual(size_t{1}, CountRegions(tiles, width, height));
+            int opened = 0;
+            for (size_t i = 0; i < tiles.size(); ++i) {
+                if (tiles[i] != before[i]) {
+                    Assert::IsTrue(TileType::Floor == tiles[i]);
+                    ++opened;
+                }
+            }
+            Assert::AreEqual(3, opened);
+        }
+
+        TEST_METHOD(SmallRegionsAreFilled)
+        {
+            // Room A (15 tiles) is below the minimum, room B (20) is the largest
+            int width = 0, height = 0;
+            std::vector<TileType> tiles = TwoRooms(width, height);
+            MapGenerator::ConnectRegions(tiles, width, height, MapGenerator::Connectivity::CarveTunnels, 16);
+
+            Assert::AreEqual(size_t{1}, CountRegions(tiles, width, height));
+            Assert::IsTrue(TileType::Wall == tiles[3 * width + 2]);
+            Assert::IsTrue(TileType::Floor == tiles[3 * width + 8]);
+        }
+
+        TEST_METHOD(GeneratedMapsAreOneRegion)
+        {
+            MapGenerator::Config config;
+            config.width = 150;
+            config.height = 120;
+            config.seed = 4242;
+            const Map plain = MapGenerator::Generate(config);
+            Map plainCopy = plain;
+            plainCopy.EnableRegionIndex();
+            Assert::IsTrue(plainCopy.GetRegionIndex().GetRegionCount() > 1);
+
+            for (const auto mode : {MapGenerator::Connectivity::FillPockets, MapGenerator::Connectivity::CarveTunnels}) {
+                config.connectivity = mode;
+                Map connected = MapGenerator::Generate(config);
+                connected.EnableRegionIndex();
+                Assert::AreEqual(size_t{1}, connected.GetRegionIndex().GetRegionCount());
+
+                // Deterministic, and the border stays wall
+                const Map again = MapGenerator::Generate(config);
+                for (int y = 0; y < config.height; ++y) {
+                    for (int x = 0; x < config.width; ++x) {
+                        Assert::IsTrue(connected.GetTile(x, y) == again.GetTile(x, y));
+                    }
+                }
+                for (int x = 0; x < config.width; ++x) {
+                    Assert::IsTrue(TileType::Wall == connected.GetTile(x, 0));
+                    Assert::IsTrue(TileType::Wall == connected.GetTile(x, config.height - 1));
+                }
+            }
+        }
+
+        TEST_METHOD(IgnoresTileTableWalkability)
+        {
+            // The game may make water walkable; generated maps must not change
+            MapGenerator::Config config = SeededConfig(4242, 150, 120);
+            config.connectivity = MapGenerator::Connectivity::CarveTunnels;
+            const Map expected = MapGenerator::Generate(config);
+
+            TileProperties water = TileTable::Get(TileType::Water);
+            water.walkable = true;
+            TileTable::Set(TileType::Water, water);
+            const Map actual = MapGenerator::Generate(config);
+            TileTable::Reset();
+            AssertSameTiles(expected, actual);
+        }
+    };
+
+    TEST_CLASS(WorldChunkTests)
+    {
+    public:
+        TEST_METHOD(ChunksMatchOneContinuousRegion)
+        {
+            // Reference: fill and smooth world tiles [-64, 192)^2 in one piece.
+            // Tiles at least smoothIterations from its edge are exact, which
+            // covers chunks (0, 0) to (1, 1) and the seams between them.
+            MapGenerator::Config config;
+            config.seed = 2024;
+            config.waterChance = 0.0f;
+            constexpr int kSize = 256;
+            constexpr int kOrigin = -64;
+            const uint64_t fill = CounterRng::StreamKey(config.seed, 0);
+            std::vector<TileType> tiles(kSize * kSize);
+            for (int y = 0; y < kSize; ++y) {
+                for (int x = 0; x < kSize; ++x) {
+                    const float roll = CounterRng::ToUnitFloat(CounterRng::Hash(fill, kOrigin + x, kOrigin + y));
+                    tiles[y * kSize + x] = roll < config.wallDensity ? TileType::Wall : TileType::Floor;
+                }
+            }
+            std::vector<TileType> buffer(tiles.size());
+            for (int i = 0; i < config.smoothIterations; ++i) {
+                MapGenerator::SmoothMap(tiles, buffer, kSize, kSize, config.wallThreshold);
+                std::swap(tiles, buffer);
+            }
+
+            for (int chunkY = 0; chunkY < 2; ++chunkY) {
+                for (int chunkX = 0; chunkX < 2; ++chunkX) {
+                    const auto chunk = MapGenerator::GenerateChunk(config, chunkX, chunkY);
+                    for (int y = 0; y < MapGenerator::kChunkSize; ++y) {
+                        for (int x = 0; x < MapGenerator::kChunkSize; ++x) {
+                            const int refX = chunkX * MapGenerator::kChunkSize + x - kOrigin;
+                            const int refY = chunkY * MapGenerator::kChunkSize + y - kOrigin;
+                            Assert::IsTrue(tiles[refY * kSize + refX] == chunk[y * MapGenerator::kChunkSize + x]);
+                        }
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(WaterOnlyFloodsFloor)
+        {
+            MapGenerator::Config dry;
+            dry.seed = 77;
+            dry.waterChance = 0.0f;
+            MapGenerator::Config wet = dry;
+            wet.waterChance = 0.05f;
+
+            const auto base = MapGenerator::GenerateChunk(dry, 3, -2);
+            const auto chunk = MapGenerator::GenerateChunk(wet, 3, -2);
+            int water = 0;
+            for (size_t i = 0; i < chunk.size(); ++i) {
+                if (chunk[i] == TileType::Water) {
+                    Assert::IsTrue(base[i] == TileType::Floor);
+                    ++water;
+                } else {
+                    Assert::IsTrue(chunk[i] == base[i]);
+                }
+            }
+            Assert::IsTrue(water > 0);
+        }
+
+        TEST_METHOD(ChunksAreDeterministic)
+        {
+            MapGenerator::Config config;
+            config.seed = 5;
+            Assert::IsTrue(MapGenerator::GenerateChunk(config, 10, 20) == MapGenerator::GenerateChunk(config, 10, 20));
+            Assert::IsFalse(MapGenerator::GenerateChunk(config, 10, 20) == MapGenerator::GenerateChunk(config, 11, 20));
+        }
+
+        TEST_METHOD(StreamerGeneratesOnlyExploredChunks)
+        {
+            MapGenerator::Config config;
+            config.seed = 99;
+            WorldStreamer world(config);
+            Map map;
+            world.InitMap(map);
+            Assert::AreEqual(WorldStreamer::kWorldSize, map.GetWidth());
+
+            constexpr int center = WorldStreamer::kWorldSize / 2;
+            const auto generated = world.EnsureAround(map, center, center, 1);
+            Assert::AreEqual(size_t{9}, generated.size());
+            Assert::AreEqual(size_t{9}, world.GetGeneratedChunkCount());
+            Assert::IsTrue(map.GetAllocatedChunkCount() <= 9);
+            Assert::IsTrue(world.EnsureAround(map, center + 10, center, 1).empty());
+
+            const MapRect bounds = world.GetExploredBounds();
+            Assert::AreEqual(center - 64, bounds.x);
+            Assert::AreEqual(192, bounds.width);
+
+            // Tiles in the map are the chunk generator's output
+            const int chunkX = center / MapGenerator::kChunkSize;
+            const auto chunk = MapGenerator::GenerateChunk(world.GetConfig(), chunkX, chunkX);
+            for (int y = 0; y < MapGenerator::kChunkSize; ++y) {
+                for (int x = 0; x < MapGenerator::kChunkSize; ++x) {
+                    Assert::IsTrue(chunk[y * MapGenerator::kChunkSize + x] ==
+                                   map.GetTile(center + x, center + y));
+                }
+            }
+
+            // Walking east generates one new column of chunks
+            Assert::AreEqual(size_t{3}, world.EnsureAround(map, center + 64, center, 1).size());
+            Assert::IsTrue(world.IsGenerated(chunkX + 2, chunkX));
+            Assert::IsFalse(world.IsGenerated(chunkX + 3, chunkX));
+        }
+
+        TEST_METHOD(StreamerClampsToWorldEdge)
+        {
+            WorldStreamer world(MapGenerator::Config{});
+            Map map;
+            world.InitMap(map);
+            Assert::AreEqual(size_t{4}, world.EnsureAround(map, 0, 0, 1).size());
+            Assert::AreNotEqual(0u, world.GetConfig().seed);
+        }
+    };
+
+    TEST_CLASS(BandGenerationTests)
+    {
+    public:
+        static constexpr const char* TEST_FILE = "test_band_stream_temp.dmap";
+        static constexpr const char* REFERENCE_FILE = "test_band_reference_temp.dmap";
+
+        TEST_METHOD_CLEANUP(CleanupTestFiles)
+        {
+            std::filesystem::remove(TEST_FILE);
+            std::filesystem::remove(REFERENCE_FILE);
+        }
+
+        static std::vector<TileType> Collect(const MapGenerator::Config& config, int bandRows)
+        {
+            std::vector<TileType> tiles;
+            const bool ok = MapGenerator::GenerateBands(config, bandRows,
+                [&](int firstRow, std::span<const TileType> rows) {
+                    // Bands arrive in order, whole rows at a time
+                    Assert::AreEqual(static_cast<size_t>(firstRow) * config.width, tiles.size());
+                    Assert::AreEqual(size_t{0}, rows.size() % config.width);
+                    tiles.insert(tiles.end(), rows.begin(), rows.end());
+                    return true;
+                });
+            Assert::IsTrue(ok);
+            return tiles;
+        }
+
+        static std::vector<uint8_t> ReadBytes(const char* filename)
+        {
+            std::ifstream file(filename, std::ios::binary);
+            return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        }
+
+        TEST_METHOD(BandsMatchGenerate)
+        {
+            MapGenerator::Config config;
+            config.width = 90;
+            config.height = 130;
+            config.seed = 31;
+            for (const float water : {0.0f, 0.05f}) {
+                config.waterChance = water;
+                const Map map = MapGenerator::Generate(config);
+                for (const int bandRows : {1, 7, 64, 1000}) {
+                    const auto tiles = Collect(config, bandRows);
+                    Assert::AreEqual(static_cast<size_t>(config.width * config.height), tiles.size());
+                    for (int y = 0; y < config.height; ++y) {
+                        for (int x = 0; x < config.width; ++x) {
+                            Assert::IsTrue(map.GetTile(x, y) == tiles[static_cast<size_t>(y * config.width + x)]);
+                        }
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(RejectsWholeMapStages)
+        {
+            MapGenerator::Config config;
+            config.width = 40;
+            config.height = 40;
+            config.seed = 3;
+            const auto sink = [](int, std::span<const TileType>) { return true; };
+            Assert::IsFalse(MapGenerator::GenerateBands(config, 0, sink));
+
+            MapGenerator::Config sequential = config;
+            sequential.algorithm = MapGenerator::Algorithm::Sequential;
+            Assert::IsFalse(MapGenerator::GenerateBands(sequential, 8, sink));
+
+            MapGenerator::Config connected = config;
+            connected.connectivity = MapGenerator::Connectivity::FillPockets;
+            Assert::IsFalse(MapGenerator::GenerateBands(connected, 8, sink));
+
+            // A sink returning false stops after its first band
+            int bands = 0;
+            Assert::IsFalse(MapGenerator::GenerateBands(config, 8,
+                [&](int, std::span<const TileType>) { ++bands; return false; }));
+            Assert::AreEqual(1, bands);
+        }
+
+        TEST_METHOD(StreamedFilesMatchSaveToFile)
+        {
+            MapGenerator::Config config;
+            config.width = 150;
+            config.height = 97;
+            config.seed = 8;
+            const Map map = MapGenerator::Generate(config);
+            for (const MapFileFormat format : {MapFileFormat::Text, MapFileFormat::Binary, MapFileFormat::Compressed}) {
+                MapStreamWriter writer;
+                Assert::IsTrue(writer.Open(TEST_FILE, map.GetName(), config.width, config.height, format));
+                Assert::IsTrue(MapGenerator::GenerateBands(config, 10,
+                    [&](int, std::span<const TileType> rows) { return writer.WriteRows(rows); }));
+                Assert::IsTrue(writer.Finish());
+
+                Assert::IsTrue(map.SaveToFile(REFERENCE_FILE, format));
+                Assert::IsTrue(ReadBytes(REFERENCE_FILE) == ReadBytes(TEST_FILE));
+            }
+        }
+
+        TEST_METHOD(WriterRejectsPartialRowsAndShortMaps)
+        {
+            const std::vector<TileType> row(20, TileType::Floor);
+            MapStreamWriter writer;
+            Assert::IsTrue(writer.Open(TEST_FILE, "short", 20, 3, MapFileFormat::Binary));
+            Assert::IsTrue(writer.WriteRows(row));
+            Assert::AreEqual(1, writer.GetRowsWritten());
+            Assert::IsFalse(writer.Finish());
+
+            Assert::IsTrue(writer.Open(TEST_FILE, "partial", 20, 3, MapFileFormat::Compressed));
+            Assert::IsFalse(writer.WriteRows(std::span<const TileType>(row).first(15)));
+            Assert::IsFalse(writer.WriteRows(row));
+            Assert::IsFalse(writer.Finish());
+        }
+    };
+
+    TEST_CLASS(RegenerateAreaTests)
+    {
+    public:
+        // Walls in the tiles next to the area's edge, for blending checks
+        static int EdgeWalls(const Map& map, MapRect area)
+        {
+            int walls = 0;
+            for (int y = area.y; y < area.y + area.height; ++y) {
+                for (int x = area.x; x < area.x + area.width; ++x) {
+                    const bool edge = x == area.x || x == area.x + area.width - 1 ||
+                                      y == area.y || y == area.y + area.height - 1;
+                    walls += edge && map.GetTile(x, y) == TileType::Wall;
+                }
+            }
+            return walls;
+        }
+
+        TEST_METHOD(WholeInteriorReproducesGenerate)
+        {
+            Map map = MapGenerator::Generate(SeededConfig(1, 120, 90));
+            const Map expected = MapGenerator::Generate(SeededConfig(2, 120, 90));
+            MapGenerator::RegenerateArea(map, {0, 0, 120, 90}, SeededConfig(2, 120, 90));
+            AssertSameTiles(expected, map);
+        }
+
+        TEST_METHOD(OnlyTheAreaChangesAndEveryChangeIsReported)
+        {
+            const Map original = MapGenerator::Generate(SeededConfig(5, 120, 90));
+            Map map = MapGenerator::Generate(SeededConfig(5, 120, 90));
+            const MapRect area{30, 20, 40, 25};
+            const auto changes = MapGenerator::RegenerateArea(map, area, SeededConfig(6, 120, 90));
+            Assert::IsFalse(changes.empty());
+            Assert::IsTrue(map.GetChangeJournal().HasChanges());
+
+            size_t next = 0;
+            for (int y = 0; y < 90; ++y) {
+                for (int x = 0; x < 120; ++x) {
+                    if (original.GetTile(x, y) == map.GetTile(x, y)) {
+                        continue;
+                    }
+                    // Changes come in row-major order with both tile states
+                    Assert::IsTrue(area.Contains(x, y));
+                    Assert::IsTrue(next < changes.size());
+                    Assert::AreEqual(x, changes[next].x);
+                    Assert::AreEqual(y, changes[next].y);
+                    Assert::IsTrue(original.GetTile(x, y) == changes[next].before);
+                    Assert::IsTrue(map.GetTile(x, y) == changes[next].after);
+                    ++next;
+                }
+            }
+            Assert::AreEqual(changes.size(), next);
+
+            // Same seed and surroundings again: nothing left to change
+            Assert::IsTrue(MapGenerator::RegenerateArea(map, area, SeededConfig(6, 120, 90)).empty());
+        }
+
+        TEST_METHOD(SurroundingsShapeTheEdges)
+        {
+            const MapRect area{10, 10, 60, 60};
+            Map walled;
+            walled.Init("walled", 80, 80, std::vector<TileType>(80 * 80, TileType::Wall));
+            Map open;
+            open.Init("open", 80, 80, std::vector<TileType>(80 * 80, TileType::Floor));
+            MapGenerator::Config config;
+            config.seed = 12;
+            config.waterChance = 0.0f;
+            MapGenerator::RegenerateArea(walled, area, config);
+            MapGenerator::RegenerateArea(open, area, config);
+
+            // Walls around the area pull its edge towards wall, floor towards floor
+            Assert::IsTrue(EdgeWalls(walled, area) > EdgeWalls(open, area));
+            Assert::IsTrue(walled.GetTile(9, 9) == TileType::Wall);
+            Assert::IsTrue(open.GetTile(9, 9) == TileType::Floor);
+        }
+
+        TEST_METHOD(AreaIsClippedToTheInterior)
+        {
+            Map map;
+            map.Init("open", 40, 30, std::vector<TileType>(40 * 30, TileType::Floor));
+            MapGenerator::Config config;
+            config.seed = 3;
+            Assert::IsTrue(MapGenerator::RegenerateArea(map, {-5, -5, 3, 100}, config).empty());
+            Assert::IsTrue(MapGenerator::RegenerateArea(map, {10, 10, 0, 5}, config).empty());
+
+            for (const auto& change : MapGenerator::RegenerateArea(map, {-10, -10, 100, 100}, config)) {
+                Assert::IsTrue(change.x > 0 && change.x < 39 && change.y > 0 && change.y < 29);
+            }
+            Assert::IsTrue(map.GetTile(0, 0) == TileType::Floor);
+        }
+    };
+
+    TEST_CLASS(MapCacheTests)
+    {
+    public:
+        static constexpr const char* CACHE_DIR = "test_map_cache_temp";
+
+        TEST_METHOD_CLEANUP(CleanupCache)
+        {
+            std::filesystem::remove_all(CACHE_DIR);
+        }
+
+        TEST_METHOD(SecondRequestIsAHit)
+        {
+            MapCache cache(CACHE_DIR);
+            const Map generated = cache.GetOrGenerate(SeededConfig(4242));
+            Assert::AreEqual(uint64_t{0}, cache.GetHitCount());
+            Assert::AreEqual(uint64_t{1}, cache.GetMissCount());
+            Assert::IsTrue(std::filesystem::exists(cache.GetPath(SeededConfig(4242))));
+
+            const Map cached = cache.GetOrGenerate(SeededConfig(4242));
+            Assert::AreEqual(uint64_t{1}, cache.GetHitCount());
+            Assert::AreEqual(uint64_t{1}, cache.GetMissCount());
+            AssertSameTiles(generated, cached);
+            AssertSameTiles(MapGenerator::Generate(SeededConfig(4242)), cached);
+        }
+
+        TEST_METHOD(EveryConfigFieldChangesTheKey)
+        {
+            const MapGenerator::Config base = SeededConfig(4242);
+            const std::string key = MapCache::MakeKey(base);
+            Assert::AreEqual(size_t{16}, key.size());
+            Assert::AreEqual(key, MapCache::MakeKey(base));
+
+            auto changed = [&](auto edit) {
+                MapGenerator::Config config = base;
+                edit(config);
+                return MapCache::MakeKey(config) != key;
+            };
+            Assert::IsTrue(changed([](auto& c) { c.width += 1; }));
+            Assert::IsTrue(changed([](auto& c) { c.height += 1; }));
+            Assert::IsTrue(changed([](auto& c) { c.wallDensity += 0.01f; }));
+            Assert::IsTrue(changed([](auto& c) { c.smoothIterations += 1; }));
+            Assert::IsTrue(changed([](auto& c) { c.wallThreshold += 1; }));
+            Assert::IsTrue(changed([](auto& c) { c.waterChance += 0.01f; }));
+            Assert::IsTrue(changed([](auto& c) { c.seed += 1; }));
+            Assert::IsTrue(changed([](auto& c) { c.algorithm = MapGenerator::Algorithm::Sequential; }));
+            Assert::IsTrue(changed([](auto& c) { c.connectivity = MapGenerator::Connectivity::CarveTunnels; }));
+            Assert::IsTrue(changed([](auto& c) { c.minRegionSize += 1; }));
+            Assert::IsFalse(changed([](auto& c) { c.threadCount = 8; }));
+        }
+
+        TEST_METHOD(RandomSeedIsNeverCached)
+        {
+            MapCache cache(CACHE_DIR);
+            MapGenerator::Config config = SeededConfig(4242);
+            config.seed = 0;
+            (void)cache.GetOrGenerate(config);
+            (void)cache.GetOrGenerate(config);
+
+            Assert::AreEqual(uint64_t{0}, cache.GetHitCount());
+            Assert::AreEqual(uint64_t{0}, cache.GetMissCount());
+            Assert::IsFalse(std::filesystem::exists(CACHE_DIR));
+        }
+
+        TEST_METHOD(CorruptFileIsReplaced)
+        {
+            MapCache cache(CACHE_DIR);
+            std::filesystem::create_directories(CACHE_DIR);
+            {
+                std::ofstream file(cache.GetPath(SeededConfig(4242)), std::ios::binary);
+                file << "DMAP garbage";
+            }
+
+            const Map map = cache.GetOrGenerate(SeededConfig(4242));
+            Assert::AreEqual(uint64_t{1}, cache.GetMissCount());
+            AssertSameTiles(MapGenerator::Generate(SeededConfig(4242)), map);
+
+            (void)cache.GetOrGenerate(SeededConfig(4242));
+            Assert::AreEqual(uint64_t{1}, cache.GetHitCount());
+        }
+    };
+
+    TEST_CLASS(SeededMapTests)
+    {
+    public:
+        static constexpr const char* TEST_FILE = "test_seeded_map_temp.dmap";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_FILE);
+        }
+
+        TEST_METHOD(UneditedMapMatchesGenerator)
+        {
+            SeededMap seeded(SeededConfig(777));
+            Assert::IsFalse(seeded.IsMaterialized());
+            AssertSameTiles(MapGenerator::Generate(SeededConfig(777)), seeded.GetMap());
+            Assert::IsTrue(seeded.IsMaterialized());
+        }
+
+        TEST_METHOD(CaptureRecordsOnlyChangedTiles)
+        {
+            Map edited = MapGenerator::Generate(SeededConfig(777));
+            edited.SetTile(10, 10, edited.GetTile(10, 10) == TileType::Water ? TileType::Floor : TileType::Water);
+            edited.SetTile(0, 0, TileType::Floor);
+            edited.SetTile(79, 49, TileType::Floor);
+            edited.SetTile(5, 5, edited.GetTile(5, 5));
+
+            const auto seeded = SeededMap::Capture(SeededConfig(777), edited);
+            Assert::IsTrue(seeded.has_value());
+            Assert::AreEqual(size_t{3}, seeded->GetEdits().size());
+            Assert::AreEqual(uint64_t{0}, seeded->GetEdits().front().index);
+            Assert::AreEqual(uint64_t{49 * 80 + 79}, seeded->GetEdits().back().index);
+            AssertSameTiles(edited, seeded->Materialize());
+        }
+
+        TEST_METHOD(CaptureRejectsUnreproducibleInput)
+        {
+            const Map map = MapGenerator::Generate(SeededConfig(777));
+            MapGenerator::Config random = SeededConfig(777);
+            random.seed = 0;
+            MapGenerator::Config resized = SeededConfig(777);
+            resized.width = 81;
+
+            Assert::IsFalse(SeededMap::Capture(random, map).has_value());
+            Assert::IsFalse(SeededMap::Capture(resized, map).has_value());
+        }
+
+        TEST_METHOD(SetTileUpdatesOverlayAndMaterializedMap)
+        {
+            SeededMap seeded(SeededConfig(777));
+            seeded.SetTile(3, 4, TileType::Water);
+            Assert::IsTrue(TileType::Water == seeded.GetTile(3, 4));
+            Assert::IsFalse(seeded.IsMaterialized());
+
+            Assert::IsTrue(TileType::Water == seeded.GetMap().GetTile(3, 4));
+            seeded.SetTile(3, 4, TileType::Floor);
+            seeded.SetTile(-1, 4, TileType::Floor);
+            Assert::AreEqual(size_t{1}, seeded.GetEdits().size());
+            Assert::IsTrue(TileType::Floor == seeded.GetMap().GetTile(3, 4));
+        }
+
+        TEST_METHOD(EncodingIsTinyAndRoundTrips)
+        {
+            SeededMap seeded(SeededConfig(777));
+            for (int i = 0; i < 10; ++i) {
+                seeded.SetTile(7 * i + 1, 3 * i + 2, TileType::Floor);
+            }
+
+            const std::vector<uint8_t> bytes = seeded.Encode();
+            Assert::IsTrue(bytes.size() < 80);
+
+            auto decoded = SeededMap::Decode(bytes);
+            Assert::IsTrue(decoded.has_value());
+            Assert::AreEqual(size_t{10}, decoded->GetEdits().size());
+            AssertSameTiles(seeded.Materialize(), decoded->GetMap());
+        }
+
+        TEST_METHOD(DecodeRejectsBadPayloads)
+        {
+            SeededMap seeded(SeededConfig(777));
+            seeded.SetTile(1, 1, TileType::Floor);
+            seeded.SetTile(2, 1, TileType::Floor);
+            const std::vector<uint8_t> bytes = seeded.Encode();
+
+            // Truncated, trailing bytes, other generator version
+            Assert::IsFalse(SeededMap::Decode(std::span(bytes).first(bytes.size() - 1)).has_value());
+            std::vector<uint8_t> longer = bytes;
+            longer.push_back(0);
+            Assert::IsFalse(SeededMap::Decode(longer).has_value());
+            std::vector<uint8_t> otherVersion = bytes;
+            ++otherVersion[0];
+            Assert::IsFalse(SeededMap::Decode(otherVersion).has_value());
+
+            // Index past the end of the map
+            SeededMap outside(SeededConfig(777));
+            outside.SetTile(79, 49, TileType::Floor);
+            std::vector<uint8_t> past = outside.Encode();
+            past[past.size() - 3] = 0xFF;
+            Assert::IsFalse(SeededMap::Decode(past).has_value());
+
+            // Maps above the decode limit (a few bytes must not request a huge map)
+            MapGenerator::Config huge = SeededConfig(777);
+            huge.width = 40000;
+            huge.height = 40000;
+            Assert::IsFalse(SeededMap::Decode(SeededMap(huge).Encode()).has_value());
+            huge.width = 10000;
+            huge.height = 10000;
+            Assert::IsTrue(SeededMap::Decode(SeededMap(huge).Encode()).has_value());
+        }
+
+        TEST_METHOD(DecodeRejectsOutOfRangeParameters)
+        {
+            const auto decodes = [](auto change) {
+                MapGenerator::Config config = SeededConfig(777);
+                change(config);
+                return SeededMap::Decode(SeededMap(config).Encode()).has_value();
+            };
+            Assert::IsTrue(decodes([](auto&) {}));
+
+            Assert::IsFalse(decodes([](auto& c) { c.smoothIterations = -1; }));
+            Assert::IsFalse(decodes([](auto& c) { c.smoothIterations = 1000000; }));
+            Assert::IsTrue(decodes([](auto& c) { c.smoothIterations = 64; }));
+
+            Assert::IsFalse(decodes([](auto& c) { c.wallDensity = -0.1f; }));
+            Assert::IsFalse(decodes([](auto& c) { c.wallDensity = 1.5f; }));
+            Assert::IsFalse(decodes([](auto& c) { c.wallDensity = std::numeric_limits<float>::quiet_NaN(); }));
+            Assert::IsFalse(decodes([](auto& c) { c.waterChance = -0.1f; }));
+            Assert::IsFalse(decodes([](auto& c) { c.waterChance = 2.0f; }));
+            Assert::IsFalse(decodes([](auto& c) { c.waterChance = std::numeric_limits<float>::infinity(); }));
+            Assert::IsTrue(decodes([](auto& c) { c.wallDensity = 1.0f; c.waterChance = 0.0f; }));
+
+            Assert::IsFalse(decodes([](auto& c) { c.wallThreshold = -1; }));
+            Assert::IsFalse(decodes([](auto& c) { c.wallThreshold = 9; }));
+            Assert::IsTrue(decodes([](auto& c) { c.wallThreshold = 8; }));
+
+            Assert::IsFalse(decodes([](auto& c) { c.minRegionSize = -1; }));
+            Assert::IsFalse(decodes([](auto& c) { c.minRegionSize = 80 * 50 + 1; }));
+            Assert::IsTrue(decodes([](auto& c) { c.minRegionSize = 0; }));
+        }
+
+        TEST_METHOD(FileRoundTripLoadsLazily)
+        {
+            SeededMap seeded(SeededConfig(777));
+            seeded.SetTile(20, 20, TileType::Water);
+            Assert::IsTrue(seeded.SaveToFile(TEST_FILE));
+            Assert::IsTrue(std::filesystem::file_size(TEST_FILE) < 256);
+
+            SeededMap loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_FILE));
+            Assert::IsFalse(loaded.IsMaterialized());
+            AssertSameTiles(seeded.Materialize(), loaded.GetMap());
+
+            // Plain maps cannot read the payload and say so
+            Map map;
+            MapLoadError error;
+            Assert::IsFalse(map.LoadFromFile(TEST_FILE, &error));
+        }
     };
 }
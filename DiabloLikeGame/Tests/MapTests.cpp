@@ -1,6 +1,11 @@
 #include "CppUnitTest.h"
 #include "Common/Map.h"
+#include "Common/MapStreamWriter.h"
 #include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <regex>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -266,6 +271,1479 @@ namespace MapTests
         }
     };
 
+    TEST_CLASS(MapTextParsing)
+    {
+    public:
+        static constexpr const char* TEST_MAP_FILE = "test_map_parse_temp.map";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_MAP_FILE);
+        }
+
+        static void WriteRaw(const char* text)
+        {
+            std::ofstream file(TEST_MAP_FILE, std::ios::binary);
+            file << text;
+        }
+
+        static MapLoadError LoadRaw(const char* text)
+        {
+            WriteRaw(text);
+            Map map;
+            MapLoadError error;
+            Assert::IsFalse(map.LoadFromFile(TEST_MAP_FILE, &error));
+            return error;
+        }
+
+        TEST_METHOD(ParsesCrLfAndBlanks)
+        {
+            WriteRaw("name=Crlf\r\nwidth=3\r\nheight=2\r\ndata=\r\n1, 2 ,3\r\n3,2,1,\r\n");
+            Map map;
+            MapLoadError error;
+            Assert::IsTrue(map.LoadFromFile(TEST_MAP_FILE, &error));
+            Assert::IsTrue(error.IsOk());
+            Assert::AreEqual(std::string("Crlf"), map.GetName());
+            Assert::IsTrue(TileType::Water == map.GetTile(2, 0));
+            Assert::IsTrue(TileType::Floor == map.GetTile(2, 1));
+        }
+
+        TEST_METHOD(MissingFileReportsOpenFailed)
+        {
+            Map map;
+            MapLoadError error;
+            Assert::IsFalse(map.LoadFromFile("nonexistent_file.map", &error));
+            Assert::IsTrue(MapLoadError::Code::OpenFailed == error.code);
+        }
+
+        TEST_METHOD(NonNumericTileReportsPosition)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=3\nheight=2\ndata=\n1,1,1\n1,x,1\n");
+            Assert::IsTrue(MapLoadError::Code::InvalidNumber == error.code);
+            Assert::AreEqual(6, error.line);
+            Assert::AreEqual(3, error.column);
+        }
+
+        TEST_METHOD(NonNumericWidthIsRejected)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=abc\nheight=2\ndata=\n");
+            Assert::IsTrue(MapLoadError::Code::InvalidNumber == error.code);
+            Assert::AreEqual(2, error.line);
+        }
+
+        TEST_METHOD(NegativeDimensionsAreRejected)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=-3\nheight=2\ndata=\n");
+            Assert::IsTrue(MapLoadError::Code::InvalidDimensions == error.code);
+        }
+
+        TEST_METHOD(MissingHeaderIsRejected)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=3\ndata=\n1,1,1\n");
+            Assert::IsTrue(MapLoadError::Code::MissingHeader == error.code);
+        }
+
+        TEST_METHOD(ShortRowIsRejected)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=3\nheight=2\ndata=\n1,1,1\n1,1\n");
+            Assert::IsTrue(MapLoadError::Code::ShortRow == error.code);
+            Assert::AreEqual(6, error.line);
+        }
+
+        TEST_METHOD(LongRowIsRejected)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=3\nheight=2\ndata=\n1,1,1,1\n1,1,1\n");
+            Assert::IsTrue(MapLoadError::Code::LongRow == error.code);
+            Assert::AreEqual(5, error.line);
+        }
+
+        TEST_METHOD(MissingRowsAreRejected)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=3\nheight=3\ndata=\n1,1,1\n1,1,1\n");
+            Assert::IsTrue(MapLoadError::Code::MissingRows == error.code);
+        }
+
+        TEST_METHOD(TileOutOfRangeIsRejected)
+        {
+            const MapLoadError error = LoadRaw("name=X\nwidth=2\nheight=1\ndata=\n1,256\n");
+            Assert::IsTrue(MapLoadError::Code::InvalidTile == error.code);
+        }
+
+        TEST_METHOD(FailedLoadLeavesMapUnchanged)
+        {
+            Map map;
+            map.Init("Keep", 2, 2, std::vector<TileType>(4, TileType::Water));
+            WriteRaw("name=X\nwidth=2\nheight=2\ndata=\n1,1\n1\n");
+
+            Assert::IsFalse(map.LoadFromFile(TEST_MAP_FILE));
+            Assert::AreEqual(std::string("Keep"), map.GetName());
+            Assert::IsTrue(TileType::Water == map.GetTile(1, 1));
+        }
+
+        TEST_METHOD(ChunkedMapTextRoundTrip)
+        {
+            Map map;
+            map.InitChunked("Chunked", 130, 70, TileType::Wall);
+            map.SetTile(129, 69, TileType::Floor);
+            map.SetTile(0, 65, TileType::Water);
+            Assert::IsTrue(map.SaveToFile(TEST_MAP_FILE));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            Assert::IsFalse(loaded.IsChunked());
+            Assert::IsTrue(TileType::Floor == loaded.GetTile(129, 69));
+            Assert::IsTrue(TileType::Water == loaded.GetTile(0, 65));
+            Assert::IsTrue(TileType::Wall == loaded.GetTile(64, 64));
+        }
+
+        TEST_METHOD(WideRowsSpanWriterFlushes)
+        {
+            // Rows wider than the writer's buffer still round-trip
+            const int width = 300000;
+            std::vector<TileType> data(static_cast<size_t>(width) * 2, TileType::Floor);
+            data[static_cast<size_t>(width) + 12345] = TileType::Wall;
+            Map map;
+            map.Init("Wide", width, 2, data);
+            Assert::IsTrue(map.SaveToFile(TEST_MAP_FILE));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            Assert::IsTrue(TileType::Wall == loaded.GetTile(12345, 1));
+            Assert::IsTrue(TileType::Floor == loaded.GetTile(width - 1, 1));
+        }
+    };
+
+    TEST_CLASS(MapParallelTextLoading)
+    {
+    public:
+        static constexpr const char* TEST_MAP_FILE = "test_map_parallel_temp.map";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_MAP_FILE);
+        }
+
+        static Map CreatePatternMap(int width, int height)
+        {
+            std::vector<TileType> data(static_cast<size_t>(width) * static_cast<size_t>(height));
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<TileType>((i * 31 + i / 17) % 4);
+            }
+            Map map;
+            map.Init("Parallel", width, height, data);
+            return map;
+        }
+
+        static MapLoadError LoadWithThreads(unsigned threads)
+        {
+            Map map;
+            MapLoadError error;
+            (void)map.LoadFromFile(TEST_MAP_FILE, MapLoadOptions{threads, nullptr}, &error);
+            return error;
+        }
+
+        // Rewrite one line (1-based) of the test file
+        static void ReplaceLine(int lineNumber, const std::string& replacement)
+        {
+            std::ifstream in(TEST_MAP_FILE);
+            std::vector<std::string> lines;
+            for (std::string line; std::getline(in, line);) {
+                lines.push_back(line);
+            }
+            in.close();
+            lines[static_cast<size_t>(lineNumber - 1)] = replacement;
+            std::ofstream out(TEST_MAP_FILE, std::ios::binary);
+            for (const auto& line : lines) {
+                out << line << '\n';
+            }
+        }
+
+        TEST_METHOD(ParallelLoadMatchesSerial)
+        {
+            const Map original = CreatePatternMap(97, 1000);
+            Assert::IsTrue(original.SaveToFile(TEST_MAP_FILE));
+
+            MapLoadTimings timings;
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE, MapLoadOptions{4, &timings}));
+            Assert::AreEqual(4u, timings.threads);
+            Assert::IsTrue(timings.totalMs >= timings.tilesMs);
+
+            for (int y = 0; y < original.GetHeight(); ++y) {
+                for (int x = 0; x < original.GetWidth(); ++x) {
+                    Assert::IsTrue(original.GetTile(x, y) == loaded.GetTile(x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(SmallMapsLoadOnOneThread)
+        {
+            const Map original = CreatePatternMap(10, 10);
+            Assert::IsTrue(original.SaveToFile(TEST_MAP_FILE));
+
+            MapLoadTimings timings;
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE, MapLoadOptions{8, &timings}));
+            Assert::AreEqual(1u, timings.threads);
+        }
+
+        TEST_METHOD(ParallelErrorMatchesSerial)
+        {
+            const Map original = CreatePatternMap(20, 1000);
+            Assert::IsTrue(original.SaveToFile(TEST_MAP_FILE));
+            ReplaceLine(700, "1,2,3");
+            ReplaceLine(900, "1,x");
+
+            const MapLoadError serial = LoadWithThreads(1);
+            const MapLoadError parallel = LoadWithThreads(6);
+            Assert::IsTrue(MapLoadError::Code::ShortRow == serial.code);
+            Assert::IsTrue(serial.code == parallel.code);
+            Assert::AreEqual(700, parallel.line);
+            Assert::AreEqual(serial.column, parallel.column);
+        }
+
+        TEST_METHOD(ParallelMissingRowsMatchesSerial)
+        {
+            const Map original = CreatePatternMap(20, 1000);
+            Assert::IsTrue(original.SaveToFile(TEST_MAP_FILE));
+            {
+                std::ifstream in(TEST_MAP_FILE);
+                std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+                in.close();
+                text = std::regex_replace(text, std::regex("height=1000"), "height=1200");
+                std::ofstream out(TEST_MAP_FILE, std::ios::binary);
+                out << text;
+            }
+
+            const MapLoadError serial = LoadWithThreads(1);
+            const MapLoadError parallel = LoadWithThreads(4);
+            Assert::IsTrue(MapLoadError::Code::MissingRows == parallel.code);
+            Assert::AreEqual(serial.line, parallel.line);
+            Assert::AreEqual(1005, parallel.line);
+        }
+    };
+
+    TEST_CLASS(MapBinaryFileIO)
+    {
+    public:
+        static constexpr const char* TEST_DMAP_FILE = "test_map_temp.dmap";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_DMAP_FILE);
+        }
+
+        static Map CreateMixedMap()
+        {
+            Map map;
+            std::vector<TileType> data = {
+                TileType::Wall, TileType::Floor, TileType::Water,
+                TileType::Floor, TileType::Empty, TileType::Wall
+            };
+            map.Init("BinaryMap", 3, 2, data);
+            return map;
+        }
+
+        TEST_METHOD(BinaryRoundTripPreservesTiles)
+        {
+            Map original = CreateMixedMap();
+            Assert::IsTrue(original.SaveToFile(TEST_DMAP_FILE, MapFileFormat::Binary));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_DMAP_FILE));
+            Assert::AreEqual(std::string("BinaryMap"), loaded.GetName());
+            Assert::AreEqual(3, loaded.GetWidth());
+            Assert::AreEqual(2, loaded.GetHeight());
+            for (int y = 0; y < 2; ++y) {
+                for (int x = 0; x < 3; ++x) {
+                    Assert::IsTrue(original.GetTile(x, y) == loaded.GetTile(x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(BinaryLoadIsMemoryMapped)
+        {
+            Map original = CreateMixedMap();
+            Assert::IsTrue(original.SaveToFile(TEST_DMAP_FILE, MapFileFormat::Binary));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_DMAP_FILE));
+            Assert::IsTrue(loaded.IsMemoryMapped());
+            Assert::IsFalse(original.IsMemoryMapped());
+        }
+
+        TEST_METHOD(SetTileOnMappedMapDoesNotModifyFile)
+        {
+            Map original = CreateMixedMap();
+            Assert::IsTrue(original.SaveToFile(TEST_DMAP_FILE, MapFileFormat::Binary));
+
+            {
+                Map mapped;
+                Assert::IsTrue(mapped.LoadFromFile(TEST_DMAP_FILE));
+                mapped.SetTile(0, 0, TileType::Floor);
+                Assert::IsTrue(TileType::Floor == mapped.GetTile(0, 0));
+            }
+
+            Map reloaded;
+            Assert::IsTrue(reloaded.LoadFromFile(TEST_DMAP_FILE));
+            Assert::IsTrue(TileType::Wall == reloaded.GetTile(0, 0));
+        }
+
+        TEST_METHOD(CopyOfMappedMapIsIndependent)
+        {
+            Map original = CreateMixedMap();
+            Assert::IsTrue(original.SaveToFile(TEST_DMAP_FILE, MapFileFormat::Binary));
+
+            Map mapped;
+            Assert::IsTrue(mapped.LoadFromFile(TEST_DMAP_FILE));
+            Map copy = mapped;
+            copy.SetTile(1, 0, TileType::Wall);
+
+            Assert::IsFalse(copy.IsMemoryMapped());
+            Assert::IsTrue(TileType::Wall == copy.GetTile(1, 0));
+            Assert::IsTrue(TileType::Floor == mapped.GetTile(1, 0));
+        }
+
+        TEST_METHOD(MovedMappedMapKeepsTiles)
+        {
+            Map original = CreateMixedMap();
+            Assert::IsTrue(original.SaveToFile(TEST_DMAP_FILE, MapFileFormat::Binary));
+
+            Map mapped;
+            Assert::IsTrue(mapped.LoadFromFile(TEST_DMAP_FILE));
+            Map moved = std::move(mapped);
+
+            Assert::IsTrue(moved.IsMemoryMapped());
+            Assert::IsTrue(TileType::Water == moved.GetTile(2, 0));
+        }
+
+        TEST_METHOD(TruncatedBinaryFileFailsToLoad)
+        {
+            Map original = CreateMixedMap();
+            Assert::IsTrue(original.SaveToFile(TEST_DMAP_FILE, MapFileFormat::Binary));
+            std::filesystem::resize_file(TEST_DMAP_FILE, 100);
+
+            Map loaded;
+            Assert::IsFalse(loaded.LoadFromFile(TEST_DMAP_FILE));
+        }
+    };
+
+    TEST_CLASS(MapRunLengthEncoding)
+    {
+    public:
+        static constexpr const char* TEST_MAP_FILE = "test_map_rle_temp.dmap";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_MAP_FILE);
+        }
+
+        TEST_METHOD(ShortRunsUseOneByte)
+        {
+            const std::vector<TileType> tiles = {
+                TileType::Wall, TileType::Wall, TileType::Floor, TileType::Water, TileType::Water
+            };
+            const std::vector<uint8_t> bytes = MapRle::Encode(tiles);
+            // Wall x2, Floor x1, then Water x2 with its escaped tile byte
+            const std::vector<uint8_t> expected = {0x06, 0x01, 0x07, 0x03};
+            Assert::IsTrue(expected == bytes);
+
+            std::vector<TileType> decoded(tiles.size());
+            Assert::IsTrue(MapRle::Decode(bytes, decoded));
+            Assert::IsTrue(tiles == decoded);
+        }
+
+        TEST_METHOD(LongRunUsesVarint)
+        {
+            const std::vector<TileType> tiles(300, TileType::Floor);
+            const std::vector<uint8_t> bytes = MapRle::Encode(tiles);
+            // 299 = 9 << 5 | 11: header 0x80 | 11 << 2 | Floor, then varint 9
+            const std::vector<uint8_t> expected = {0xAD, 0x09};
+            Assert::IsTrue(expected == bytes);
+
+            std::vector<TileType> decoded(300);
+            Assert::IsTrue(MapRle::Decode(bytes, decoded));
+            Assert::IsTrue(tiles == decoded);
+        }
+
+        TEST_METHOD(StreamingMatchesWholeBuffer)
+        {
+            std::vector<TileType> tiles(1000);
+            for (size_t i = 0; i < tiles.size(); ++i) {
+                tiles[i] = static_cast<TileType>((i / 7 + i / 13) % 4);
+            }
+
+            std::vector<uint8_t> streamed;
+            MapRle::Encoder encoder(streamed);
+            for (size_t i = 0; i < tiles.size(); i += 37) {
+                encoder.Append(std::span<const TileType>(tiles).subspan(i, std::min<size_t>(37, tiles.size() - i)));
+            }
+            encoder.Finish();
+            Assert::IsTrue(MapRle::Encode(tiles) == streamed);
+
+            MapRle::Decoder decoder(streamed);
+            std::vector<TileType> decoded(tiles.size());
+            for (size_t i = 0; i < decoded.size(); i += 50) {
+                Assert::IsTrue(decoder.Read(std::span<TileType>(decoded).subspan(i, 50)));
+            }
+            Assert::IsTrue(decoder.AtEnd());
+            Assert::IsTrue(tiles == decoded);
+        }
+
+        TEST_METHOD(DecodeRejectsWrongTileCount)
+        {
+            const std::vector<uint8_t> bytes = MapRle::Encode(std::vector<TileType>(10, TileType::Wall));
+            std::vector<TileType> tooMany(11);
+            std::vector<TileType> tooFew(9);
+            Assert::IsFalse(MapRle::Decode(bytes, tooMany));
+            Assert::IsFalse(MapRle::Decode(bytes, tooFew));
+        }
+
+        TEST_METHOD(DecodeRejectsTruncatedVarint)
+        {
+            const std::vector<uint8_t> bytes = {0x81, 0x80};
+            std::vector<TileType> out(1);
+            Assert::IsFalse(MapRle::Decode(bytes, out));
+        }
+
+        TEST_METHOD(MapEncodeRoundTrip)
+        {
+            Map map;
+            std::vector<TileType> data(64, TileType::Floor);
+            data[9] = TileType::Wall;
+            data[63] = TileType::Water;
+            map.Init("Rle", 8, 8, data);
+
+            Map decoded;
+            Assert::IsTrue(decoded.InitFromRle("Rle", 8, 8, map.EncodeRle()));
+            Assert::IsTrue(TileType::Wall == decoded.GetTile(1, 1));
+            Assert::IsTrue(TileType::Water == decoded.GetTile(7, 7));
+            Assert::IsTrue(decoded.IsWalkable(0, 0));
+        }
+
+        TEST_METHOD(InitFromRleFailureLeavesMapUnchanged)
+        {
+            Map map;
+            map.Init("Keep", 2, 2, std::vector<TileType>(4, TileType::Water));
+            const std::vector<uint8_t> bytes = MapRle::Encode(std::vector<TileType>(3, TileType::Wall));
+
+            Assert::IsFalse(map.InitFromRle("Bad", 2, 2, bytes));
+            Assert::AreEqual(std::string("Keep"), map.GetName());
+        }
+
+        TEST_METHOD(CountTilesSumsRunsWithoutDecoding)
+        {
+            std::vector<uint8_t> bytes;
+            MapRle::Encoder encoder(bytes);
+            encoder.AppendRun(TileType::Wall, 5000000000ull);
+            encoder.AppendRun(TileType::Water, 7);
+            encoder.Finish();
+
+            Assert::IsTrue(MapRle::CountTiles(bytes) == 5000000007ull);
+            Assert::IsTrue(MapRle::CountTiles({}) == 0ull);
+            const std::vector<uint8_t> truncated = {0x81, 0x80};
+            Assert::IsFalse(MapRle::CountTiles(truncated).has_value());
+        }
+
+        TEST_METHOD(InitFromRleRejectsOversizedClaimsBeforeAllocating)
+        {
+            // A few bytes claiming 2000000x1000000 tiles: over the chunked decode limit
+            std::vector<uint8_t> huge;
+            MapRle::Encoder encoder(huge);
+            encoder.AppendRun(TileType::Wall, 2000000ull * 1000000ull);
+            encoder.Finish();
+
+            Map map;
+            map.Init("Keep", 2, 2, std::vector<TileType>(4, TileType::Water));
+            Assert::IsFalse(map.InitFromRle("Huge", 2000000, 1000000, huge));
+            Assert::IsFalse(map.InitFromRle("Negative", -1, 4, huge));
+
+            // Rows too wide to buffer a band of chunks
+            std::vector<uint8_t> wide;
+            MapRle::Encoder wideEncoder(wide);
+            wideEncoder.AppendRun(TileType::Wall, 40000000ull * 64ull);
+            wideEncoder.Finish();
+            Assert::IsFalse(map.InitFromRle("Wide", 40000000, 64, wide));
+
+            // Within the limit, but the stream holds fewer tiles than claimed
+            const std::vector<uint8_t> small = MapRle::Encode(std::vector<TileType>(16, TileType::Wall));
+            Assert::IsFalse(map.InitFromRle("Short", 10000, 10000, small));
+            Assert::AreEqual(std::string("Keep"), map.GetName());
+        }
+
+        TEST_METHOD(CompressedFileRoundTrip)
+        {
+            Map map;
+            std::vector<TileType> data(200 * 100, TileType::Wall);
+            for (int x = 20; x < 180; ++x) {
+                data[static_cast<size_t>(50 * 200 + x)] = TileType::Floor;
+            }
+            map.Init("Compressed", 200, 100, data);
+            Assert::IsTrue(map.SaveToFile(TEST_MAP_FILE, MapFileFormat::Compressed));
+            Assert::IsTrue(std::filesystem::file_size(TEST_MAP_FILE) < 256);
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            Assert::IsFalse(loaded.IsMemoryMapped());
+            Assert::AreEqual(std::string("Compressed"), loaded.GetName());
+            Assert::IsTrue(TileType::Floor == loaded.GetTile(100, 50));
+            Assert::IsTrue(TileType::Wall == loaded.GetTile(100, 51));
+        }
+
+        TEST_METHOD(TallStreamedMapRoundTrip)
+        {
+            // Taller than the network cap: files written by mapgen --stream must load back
+            constexpr int kWidth = 100;
+            constexpr int kHeight = 20000;
+            MapStreamWriter writer;
+            Assert::IsTrue(writer.Open(TEST_MAP_FILE, "Tall", kWidth, kHeight, MapFileFormat::Compressed));
+            std::vector<TileType> row(kWidth);
+            for (int y = 0; y < kHeight; ++y) {
+                for (int x = 0; x < kWidth; ++x) {
+                    row[x] = x == y % kWidth ? TileType::Floor : (y % 7 == 0 ? TileType::Water : TileType::Wall);
+                }
+                Assert::IsTrue(writer.WriteRows(row));
+            }
+            Assert::IsTrue(writer.Finish());
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            Assert::AreEqual(kWidth, loaded.GetWidth());
+            Assert::AreEqual(kHeight, loaded.GetHeight());
+            for (int y = 0; y < kHeight; y += 997) {
+                for (int x = 0; x < kWidth; ++x) {
+                    const TileType expected = x == y % kWidth ? TileType::Floor : (y % 7 == 0 ? TileType::Water : TileType::Wall);
+                    Assert::IsTrue(expected == loaded.GetTile(x, y));
+                }
+            }
+            Assert::IsTrue(TileType::Floor == loaded.GetTile((kHeight - 1) % kWidth, kHeight - 1));
+        }
+
+        TEST_METHOD(HugeCompressedMapLoadsChunked)
+        {
+            // Over Map::kMaxDecodedTiles: decoded into chunks, uniform ones unallocated
+            constexpr int kWidth = 32768;
+            constexpr int kHeight = 32769;
+            Map map;
+            map.InitChunked("Huge", kWidth, kHeight, TileType::Wall);
+            map.SetTile(12345, 30000, TileType::Floor);
+            map.SetTile(kWidth - 1, kHeight - 1, TileType::Water);
+            for (int y = 64; y < 128; ++y) {
+                for (int x = 128; x < 192; ++x) {
+                    map.SetTile(x, y, TileType::Floor);
+                }
+            }
+            Assert::IsTrue(map.SaveToFile(TEST_MAP_FILE, MapFileFormat::Compressed));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            Assert::IsTrue(loaded.IsChunked());
+            Assert::AreEqual(kWidth, loaded.GetWidth());
+            Assert::AreEqual(kHeight, loaded.GetHeight());
+            Assert::AreEqual(size_t{2}, loaded.GetAllocatedChunkCount());
+            Assert::IsTrue(TileType::Floor == loaded.GetTile(12345, 30000));
+            Assert::IsTrue(TileType::Wall == loaded.GetTile(12346, 30000));
+            Assert::IsTrue(TileType::Water == loaded.GetTile(kWidth - 1, kHeight - 1));
+            Assert::IsTrue(TileType::Floor == loaded.GetTile(150, 100));
+            Assert::IsTrue(TileType::Wall == loaded.GetTile(150, 128));
+        }
+
+        TEST_METHOD(CompressedChunkedMapRoundTrip)
+        {
+            Map map;
+            map.InitChunked("World", 5000, 5000, TileType::Wall);
+            map.SetTile(4999, 4999, TileType::Floor);
+            Assert::IsTrue(map.SaveToFile(TEST_MAP_FILE, MapFileFormat::Compressed));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            Assert::IsTrue(TileType::Floor == loaded.GetTile(4999, 4999));
+            Assert::IsTrue(TileType::Wall == loaded.GetTile(4998, 4999));
+        }
+    };
+
+    TEST_CLASS(MapChangeJournalTests)
+    {
+    public:
+        static Map CreateFloorMap(int width, int height)
+        {
+            Map map;
+            map.Init("Journal", width, height,
+                     std::vector<TileType>(static_cast<size_t>(width * height), TileType::Floor));
+            return map;
+        }
+
+        TEST_METHOD(InitJournalsFullReset)
+        {
+            Map map = CreateFloorMap(10, 10);
+            Assert::IsTrue(map.GetChangeJournal().IsFullReset());
+
+            bool sawReset = false;
+            map.SubscribeToChanges([&](const Map&, const MapChangeSet& changes) {
+                sawReset = changes.fullReset;
+            });
+            map.PublishChanges();
+            Assert::IsTrue(sawReset);
+            Assert::IsFalse(map.GetChangeJournal().HasChanges());
+        }
+
+        TEST_METHOD(SetTileRecordsChunkBounds)
+        {
+            Map map = CreateFloorMap(200, 200);
+            map.PublishChanges();
+
+            map.SetTile(10, 12, TileType::Wall);
+            map.SetTile(20, 5, TileType::Wall);
+            map.SetTile(130, 70, TileType::Water);
+
+            const auto regions = map.GetChangeJournal().GetChangedRegions();
+            Assert::AreEqual(static_cast<size_t>(2), regions.size());
+            Assert::AreEqual(10, regions[0].x);
+            Assert::AreEqual(5, regions[0].y);
+            Assert::AreEqual(11, regions[0].width);
+            Assert::AreEqual(8, regions[0].height);
+            Assert::AreEqual(130, regions[1].x);
+            Assert::AreEqual(1, regions[1].width);
+        }
+
+        TEST_METHOD(UnchangedWriteIsNotJournaled)
+        {
+            Map map = CreateFloorMap(10, 10);
+            map.PublishChanges();
+            map.SetTile(3, 3, TileType::Floor);
+            map.SetTile(-1, 3, TileType::Wall);
+            Assert::IsFalse(map.GetChangeJournal().HasChanges());
+        }
+
+        TEST_METHOD(AreaSubscriberOnlySeesIntersectingRegions)
+        {
+            Map map = CreateFloorMap(256, 256);
+            map.PublishChanges();
+
+            int calls = 0;
+            size_t regionCount = 0;
+            map.SubscribeToChanges([&](const Map&, const MapChangeSet& changes) {
+                ++calls;
+                regionCount = changes.regions.size();
+            }, MapRect{0, 0, 32, 32});
+
+            map.SetTile(200, 200, TileType::Wall);
+            map.PublishChanges();
+            Assert::AreEqual(0, calls);
+
+            map.SetTile(5, 5, TileType::Wall);
+            map.SetTile(200, 5, TileType::Wall);
+            map.PublishChanges();
+            Assert::AreEqual(1, calls);
+            Assert::AreEqual(static_cast<size_t>(1), regionCount);
+        }
+
+        TEST_METHOD(UnsubscribeStopsNotifications)
+        {
+            Map map = CreateFloorMap(10, 10);
+            int calls = 0;
+            const auto id = map.SubscribeToChanges([&](const Map&, const MapChangeSet&) { ++calls; });
+            map.PublishChanges();
+            map.UnsubscribeFromChanges(id);
+            map.SetTile(1, 1, TileType::Wall);
+            map.PublishChanges();
+
+            Assert::AreEqual(1, calls);
+            Assert::AreEqual(static_cast<size_t>(0), map.GetChangeJournal().GetSubscriberCount());
+        }
+
+        TEST_METHOD(EditsDuringPublishGoToNextFrame)
+        {
+            Map map = CreateFloorMap(10, 10);
+            map.PublishChanges();
+
+            int calls = 0;
+            map.SubscribeToChanges([&](const Map&, const MapChangeSet&) {
+                if (++calls == 1) {
+                    map.SetTile(2, 2, TileType::Wall);
+                }
+            });
+            map.SetTile(1, 1, TileType::Wall);
+            map.PublishChanges();
+            Assert::AreEqual(1, calls);
+            Assert::IsTrue(map.GetChangeJournal().HasChanges());
+
+            map.PublishChanges();
+            Assert::AreEqual(2, calls);
+        }
+
+        TEST_METHOD(AssignmentKeepsSubscribers)
+        {
+            Map map = CreateFloorMap(10, 10);
+            map.PublishChanges();
+
+            bool sawReset = false;
+            map.SubscribeToChanges([&](const Map&, const MapChangeSet& changes) {
+                sawReset = changes.fullReset;
+            });
+            map = CreateFloorMap(20, 20);
+            map.PublishChanges();
+
+            Assert::IsTrue(sawReset);
+            const Map copy = map;
+            Assert::AreEqual(static_cast<size_t>(0), copy.GetChangeJournal().GetSubscriberCount());
+        }
+    };
+
+    TEST_CLASS(MapChunkedStorage)
+    {
+    public:
+        TEST_METHOD(UnwrittenTilesReturnFill)
+        {
+            Map map;
+            map.InitChunked("World", 20000, 20000, TileType::Wall);
+
+            Assert::IsTrue(map.IsChunked());
+            Assert::AreEqual(20000, map.GetWidth());
+            Assert::IsTrue(TileType::Wall == map.GetTile(0, 0));
+            Assert::IsTrue(TileType::Wall == map.GetTile(19999, 19999));
+            Assert::IsTrue(TileType::Empty == map.GetTile(20000, 0));
+            Assert::AreEqual(static_cast<size_t>(0), map.GetAllocatedChunkCount());
+        }
+
+        TEST_METHOD(SetTileAllocatesOnlyTouchedChunks)
+        {
+            Map map;
+            map.InitChunked("World", 20000, 20000, TileType::Wall);
+
+            map.SetTile(10, 10, TileType::Floor);
+            map.SetTile(63, 63, TileType::Floor);
+            map.SetTile(64, 64, TileType::Water);
+            map.SetTile(15000, 12000, TileType::Floor);
+
+            Assert::IsTrue(TileType::Floor == map.GetTile(10, 10));
+            Assert::IsTrue(TileType::Water == map.GetTileUnchecked(64, 64));
+            Assert::IsTrue(TileType::Floor == map.GetTile(15000, 12000));
+            Assert::IsTrue(TileType::Wall == map.GetTile(11, 10));
+            Assert::AreEqual(static_cast<size_t>(3), map.GetAllocatedChunkCount());
+
+            // Far smaller than a flat 20000x20000 byte array
+            Assert::IsTrue(map.GetTileMemoryBytes() < static_cast<size_t>(1) << 20);
+        }
+
+        TEST_METHOD(WritingFillValueAllocatesNothing)
+        {
+            Map map;
+            map.InitChunked("World", 1000, 1000, TileType::Wall);
+            map.SetTile(500, 500, TileType::Wall);
+            Assert::AreEqual(static_cast<size_t>(0), map.GetAllocatedChunkCount());
+        }
+
+        TEST_METHOD(CompactCollapsesUniformChunks)
+        {
+            Map map;
+            map.InitChunked("World", 1000, 1000, TileType::Wall);
+            map.SetTile(100, 100, TileType::Floor);
+            map.SetTile(100, 100, TileType::Wall);
+            Assert::AreEqual(static_cast<size_t>(1), map.GetAllocatedChunkCount());
+
+            Assert::AreEqual(static_cast<size_t>(1), map.Compact());
+            Assert::AreEqual(static_cast<size_t>(0), map.GetAllocatedChunkCount());
+            Assert::IsTrue(TileType::Wall == map.GetTile(100, 100));
+        }
+
+        TEST_METHOD(ForEachBlockFlagsUniformChunks)
+        {
+            Map map;
+            map.InitChunked("World", 128, 100, TileType::Wall);
+            map.SetTile(70, 5, TileType::Floor);
+
+            int blocks = 0;
+            int mixedBlocks = 0;
+            map.ForEachBlock([&](const MapBlock& block) {
+                ++blocks;
+                if (!block.uniform) {
+                    ++mixedBlocks;
+                    Assert::AreEqual(64, block.x);
+                    Assert::AreEqual(0, block.y);
+                } else {
+                    Assert::IsTrue(TileType::Wall == block.tile);
+                }
+                return true;
+            });
+
+            Assert::AreEqual(4, blocks);
+            Assert::AreEqual(1, mixedBlocks);
+        }
+
+        TEST_METHOD(FlatMapIsSingleBlock)
+        {
+            Map map;
+            std::vector<TileType> data(50, TileType::Floor);
+            map.Init("Flat", 10, 5, data);
+
+            int blocks = 0;
+            map.ForEachBlock([&](const MapBlock& block) {
+                ++blocks;
+                Assert::IsFalse(block.uniform);
+                Assert::AreEqual(10, block.width);
+                Assert::AreEqual(5, block.height);
+                return true;
+            });
+            Assert::AreEqual(1, blocks);
+        }
+
+        TEST_METHOD(ForEachBlockInAreaClipsToArea)
+        {
+            Map map;
+            map.InitChunked("World", 4096, 4096, TileType::Wall);
+            map.SetTile(300, 70, TileType::Floor);
+
+            // [100, 200) x [60, 70) overlaps chunk columns 1-3 of chunk rows 0
+            // and 1; the Floor tile is in chunk column 4
+            int blocks = 0;
+            int tiles = 0;
+            map.ForEachBlock(MapRect{100, 60, 100, 10}, [&](const MapBlock& block) {
+                ++blocks;
+                tiles += block.width * block.height;
+                Assert::IsTrue(block.x >= 100 && block.x + block.width <= 200);
+                Assert::IsTrue(block.y >= 60 && block.y + block.height <= 70);
+                Assert::IsTrue(block.uniform);
+                return true;
+            });
+            Assert::AreEqual(6, blocks);
+            Assert::AreEqual(1000, tiles);
+
+            int mixed = 0;
+            map.ForEachBlock(MapRect{100, 60, 250, 10}, [&](const MapBlock& block) {
+                mixed += block.uniform ? 0 : 1;
+                return true;
+            });
+            Assert::AreEqual(1, mixed);
+        }
+
+        TEST_METHOD(CopyIsDeep)
+        {
+            Map map;
+            map.InitChunked("World", 500, 500, TileType::Wall);
+            map.SetTile(1, 1, TileType::Floor);
+
+            Map copy = map;
+            copy.SetTile(1, 1, TileType::Water);
+
+            Assert::IsTrue(copy.IsChunked());
+            Assert::IsTrue(TileType::Floor == map.GetTile(1, 1));
+            Assert::IsTrue(TileType::Water == copy.GetTile(1, 1));
+        }
+
+        TEST_METHOD(InitReplacesChunkedStorage)
+        {
+            Map map;
+            map.InitChunked("World", 500, 500, TileType::Wall);
+            map.Init("Flat", 2, 2, std::vector<TileType>(4, TileType::Floor));
+
+            Assert::IsFalse(map.IsChunked());
+            Assert::IsTrue(TileType::Floor == map.GetTile(1, 1));
+        }
+    };
+
+    TEST_CLASS(MapWalkability)
+    {
+    public:
+        static constexpr const char* TEST_MAP_FILE = "test_map_walk_temp.dmap";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_MAP_FILE);
+        }
+
+        // 150x3 map where walkability follows a fixed irregular pattern
+        static Map CreatePatternMap()
+        {
+            const int width = 150;
+            const int height = 3;
+            std::vector<TileType> data(static_cast<size_t>(width * height));
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = (i * 7 + i / 5) % 3 == 0 ? TileType::Wall : TileType::Floor;
+            }
+            data[64] = TileType::Water;
+            Map map;
+            map.Init("Walk", width, height, data);
+            return map;
+        }
+
+        static void AssertPlaneMatchesTiles(const Map& map)
+        {
+            for (int y = 0; y < map.GetHeight(); ++y) {
+                for (int x = 0; x < map.GetWidth(); ++x) {
+                    Assert::AreEqual(map.GetTile(x, y) == TileType::Floor, map.IsWalkable(x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(InitBuildsPlane)
+        {
+            const Map map = CreatePatternMap();
+            Assert::AreEqual(3, map.GetWalkableWordsPerRow());
+            AssertPlaneMatchesTiles(map);
+        }
+
+        TEST_METHOD(OutOfBoundsIsNotWalkable)
+        {
+            Map map;
+            map.Init("Open", 4, 4, std::vector<TileType>(16, TileType::Floor));
+            Assert::IsFalse(map.IsWalkable(-1, 0));
+            Assert::IsFalse(map.IsWalkable(0, -1));
+            Assert::IsFalse(map.IsWalkable(4, 0));
+            Assert::IsFalse(map.IsWalkable(0, 4));
+        }
+
+        TEST_METHOD(SetTileUpdatesPlane)
+        {
+            Map map = CreatePatternMap();
+            map.SetTile(70, 1, TileType::Wall);
+            Assert::IsFalse(map.IsWalkable(70, 1));
+            map.SetTile(70, 1, TileType::Floor);
+            Assert::IsTrue(map.IsWalkable(70, 1));
+            map.SetTile(0, 0, TileType::Water);
+            Assert::IsFalse(map.IsWalkable(0, 0));
+            AssertPlaneMatchesTiles(map);
+        }
+
+        TEST_METHOD(RowRunMatchesTiles)
+        {
+            const Map map = CreatePatternMap();
+            for (int y = 0; y < map.GetHeight(); ++y) {
+                for (int x = -70; x < map.GetWidth() + 2; ++x) {
+                    const uint64_t run = map.GetWalkableRun(x, y);
+                    for (int i = 0; i < 64; ++i) {
+                        const bool bit = ((run >> i) & 1u) != 0;
+                        Assert::AreEqual(map.IsWalkable(x + i, y), bit);
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(LastWordHasNoPaddingBits)
+        {
+            Map map;
+            map.Init("Open", 70, 1, std::vector<TileType>(70, TileType::Floor));
+            Assert::AreEqual(uint64_t{0x3F}, map.GetWalkableWord(1, 0));
+        }
+
+        TEST_METHOD(BinaryLoadBuildsPlane)
+        {
+            const Map original = CreatePatternMap();
+            Assert::IsTrue(original.SaveToFile(TEST_MAP_FILE, MapFileFormat::Binary));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            AssertPlaneMatchesTiles(loaded);
+            Assert::AreEqual(original.GetWalkableWord(1, 2), loaded.GetWalkableWord(1, 2));
+        }
+
+        TEST_METHOD(CopyKeepsIndependentPlane)
+        {
+            Map map = CreatePatternMap();
+            Map copy = map;
+            copy.SetTile(1, 0, TileType::Wall);
+            map.SetTile(1, 0, TileType::Floor);
+
+            Assert::IsTrue(map.IsWalkable(1, 0));
+            Assert::IsFalse(copy.IsWalkable(1, 0));
+        }
+
+        TEST_METHOD(ChunkedMapAnswersFromTiles)
+        {
+            Map map;
+            map.InitChunked("World", 300, 300, TileType::Wall);
+            map.SetTile(130, 7, TileType::Floor);
+
+            Assert::IsTrue(map.IsWalkable(130, 7));
+            Assert::IsFalse(map.IsWalkable(131, 7));
+            Assert::AreEqual(uint64_t{1} << 2, map.GetWalkableWord(2, 7));
+            Assert::AreEqual(uint64_t{1} << 10, map.GetWalkableRun(120, 7));
+        }
+    };
+
+    TEST_CLASS(MapTiledLayout)
+    {
+    public:
+        static constexpr const char* TEST_MAP_FILE = "test_map_tiled_temp.map";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_MAP_FILE);
+        }
+
+        // Odd dimensions so the last block row and column are partial
+        static std::vector<TileType> CreatePattern(int width, int height)
+        {
+            std::vector<TileType> data(static_cast<size_t>(width) * static_cast<size_t>(height));
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<TileType>((i * 13 + i / 7) % 4);
+            }
+            return data;
+        }
+
+        static void AssertSameTiles(const Map& expected, const Map& actual)
+        {
+            Assert::AreEqual(expected.GetWidth(), actual.GetWidth());
+            Assert::AreEqual(expected.GetHeight(), actual.GetHeight());
+            for (int y = 0; y < expected.GetHeight(); ++y) {
+                for (int x = 0; x < expected.GetWidth(); ++x) {
+                    Assert::IsTrue(expected.GetTile(x, y) == actual.GetTile(x, y));
+                    Assert::AreEqual(expected.IsWalkable(x, y), actual.IsWalkable(x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(TiledMatchesRowMajor)
+        {
+            Map rowMajor;
+            Map tiled;
+            rowMajor.Init("Layout", 21, 13, CreatePattern(21, 13));
+            tiled.Init("Layout", 21, 13, CreatePattern(21, 13), MapLayout::Tiled8x8);
+
+            Assert::IsTrue(MapLayout::RowMajor == rowMajor.GetLayout());
+            Assert::IsTrue(MapLayout::Tiled8x8 == tiled.GetLayout());
+            AssertSameTiles(rowMajor, tiled);
+            Assert::IsTrue(TileType::Empty == tiled.GetTile(21, 0));
+        }
+
+        TEST_METHOD(BlocksHoldSixtyFourContiguousTiles)
+        {
+            Map tiled;
+            tiled.Init("Layout", 20, 20, CreatePattern(20, 20), MapLayout::Tiled8x8);
+
+            Assert::AreEqual(size_t{0}, tiled.GetStorageIndex(0, 0));
+            Assert::AreEqual(size_t{8}, tiled.GetStorageIndex(0, 1));
+            Assert::AreEqual(size_t{63}, tiled.GetStorageIndex(7, 7));
+            Assert::AreEqual(size_t{64}, tiled.GetStorageIndex(8, 0));
+            Assert::AreEqual(size_t{3 * 64}, tiled.GetStorageIndex(0, 8));
+            // Padded to 3x3 whole blocks
+            Assert::AreEqual(size_t{9 * 64}, tiled.GetTileMemoryBytes());
+        }
+
+        TEST_METHOD(SetTileUpdatesTileAndWalkability)
+        {
+            Map tiled;
+            tiled.Init("Layout", 21, 13, std::vector<TileType>(21 * 13, TileType::Wall), MapLayout::Tiled8x8);
+
+            tiled.SetTile(20, 12, TileType::Floor);
+            tiled.SetTile(9, 8, TileType::Floor);
+
+            Assert::IsTrue(TileType::Floor == tiled.GetTileUnchecked(20, 12));
+            Assert::IsTrue(tiled.IsWalkable(9, 8));
+            Assert::IsFalse(tiled.IsWalkable(8, 9));
+        }
+
+        TEST_METHOD(SaveAndEncodeUseRowMajorOrder)
+        {
+            Map rowMajor;
+            Map tiled;
+            rowMajor.Init("Layout", 21, 13, CreatePattern(21, 13));
+            tiled.Init("Layout", 21, 13, CreatePattern(21, 13), MapLayout::Tiled8x8);
+
+            Assert::IsTrue(rowMajor.EncodeRle() == tiled.EncodeRle());
+
+            for (const MapFileFormat format : {MapFileFormat::Text, MapFileFormat::Binary, MapFileFormat::Compressed}) {
+                Assert::IsTrue(tiled.SaveToFile(TEST_MAP_FILE, format));
+                Map loaded;
+                Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+                Assert::IsTrue(MapLayout::RowMajor == loaded.GetLayout());
+                AssertSameTiles(rowMajor, loaded);
+            }
+        }
+
+        TEST_METHOD(CopyAndMoveKeepLayout)
+        {
+            Map tiled;
+            tiled.Init("Layout", 21, 13, CreatePattern(21, 13), MapLayout::Tiled8x8);
+
+            const Map copy(tiled);
+            Assert::IsTrue(MapLayout::Tiled8x8 == copy.GetLayout());
+            AssertSameTiles(tiled, copy);
+
+            const Map moved(std::move(tiled));
+            Assert::IsTrue(MapLayout::Tiled8x8 == moved.GetLayout());
+            AssertSameTiles(copy, moved);
+        }
+    };
+
+    TEST_CLASS(MapSentinelBorder)
+    {
+    public:
+        static constexpr const char* TEST_MAP_FILE = "test_map_border_temp.dmap";
+
+        TEST_METHOD_CLEANUP(CleanupTestFile)
+        {
+            std::filesystem::remove(TEST_MAP_FILE);
+        }
+
+        static std::vector<TileType> CreatePattern(int width, int height)
+        {
+            std::vector<TileType> data(static_cast<size_t>(width) * static_cast<size_t>(height));
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<TileType>((i * 5 + i / 3) % 4);
+            }
+            return data;
+        }
+
+        // Every neighbour within `reach` of every tile matches GetTile
+        static void AssertNeighborsMatchGetTile(const Map& map, int reach)
+        {
+            for (int y = 0; y < map.GetHeight(); ++y) {
+                for (int x = 0; x < map.GetWidth(); ++x) {
+                    for (int dy = -reach; dy <= reach; ++dy) {
+                        for (int dx = -reach; dx <= reach; ++dx) {
+                            Assert::IsTrue(map.GetTile(x + dx, y + dy) == map.GetNeighborUnchecked(x, y, dx, dy));
+                        }
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(NeighborsReadSentinelsOutsideMap)
+        {
+            for (const MapLayout layout : {MapLayout::RowMajor, MapLayout::Tiled8x8}) {
+                Map map;
+                map.Init("Border", 11, 7, CreatePattern(11, 7), layout, 2);
+                Assert::AreEqual(2, map.GetBorder());
+                AssertNeighborsMatchGetTile(map, 2);
+            }
+        }
+
+        TEST_METHOD(ChunkedMapsHaveNoBorderButReadNeighbors)
+        {
+            Map map;
+            map.InitChunked("Chunked", 70, 70, TileType::Wall);
+            map.SetTile(65, 3, TileType::Water);
+            Assert::AreEqual(0, map.GetBorder());
+            Assert::IsTrue(TileType::Water == map.GetNeighborUnchecked(65, 3, 0, 0));
+            AssertNeighborsMatchGetTile(map, 0);
+        }
+
+        TEST_METHOD(BorderDoesNotChangeTilesOrWalkability)
+        {
+            Map plain;
+            Map bordered;
+            plain.Init("Border", 11, 7, CreatePattern(11, 7));
+            bordered.Init("Border", 11, 7, CreatePattern(11, 7), MapLayout::RowMajor, 1);
+
+            bordered.SetTile(10, 6, TileType::Floor);
+            plain.SetTile(10, 6, TileType::Floor);
+            for (int y = 0; y < 7; ++y) {
+                for (int x = 0; x < 11; ++x) {
+                    Assert::IsTrue(plain.GetTile(x, y) == bordered.GetTile(x, y));
+                    Assert::AreEqual(plain.IsWalkable(x, y), bordered.IsWalkable(x, y));
+                }
+            }
+            Assert::IsTrue(TileType::Empty == bordered.GetNeighborUnchecked(10, 6, 1, 1));
+            Assert::IsTrue(plain.EncodeRle() == bordered.EncodeRle());
+        }
+
+        TEST_METHOD(BorderedMapSavesWithoutSentinels)
+        {
+            Map bordered;
+            bordered.Init("Border", 11, 7, CreatePattern(11, 7), MapLayout::RowMajor, 1);
+            Assert::IsTrue(bordered.SaveToFile(TEST_MAP_FILE, MapFileFormat::Binary));
+
+            Map loaded;
+            Assert::IsTrue(loaded.LoadFromFile(TEST_MAP_FILE));
+            Assert::AreEqual(0, loaded.GetBorder());
+            for (int y = 0; y < 7; ++y) {
+                for (int x = 0; x < 11; ++x) {
+                    Assert::IsTrue(bordered.GetTile(x, y) == loaded.GetTile(x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(CopyKeepsBorder)
+        {
+            Map bordered;
+            bordered.Init("Border", 11, 7, CreatePattern(11, 7), MapLayout::RowMajor, 1);
+            const Map copy(bordered);
+            Assert::AreEqual(1, copy.GetBorder());
+            AssertNeighborsMatchGetTile(copy, 1);
+        }
+
+        TEST_METHOD(WalkablePlaneHasSentinelRing)
+        {
+            // Widths on and off a 64-bit word boundary
+            for (const int width : {63, 64, 65}) {
+                Map map;
+                map.Init("Open", width, 3, std::vector<TileType>(static_cast<size_t>(width) * 3, TileType::Floor));
+                for (int y = -1; y <= 3; ++y) {
+                    for (int x = -1; x <= width; ++x) {
+                        Assert::AreEqual(map.IsInBounds(x, y), map.IsWalkableUnchecked(x, y));
+                    }
+                }
+            }
+        }
+    };
+
+    TEST_CLASS(MapRegionLabels)
+    {
+    public:
+        // Rows of '.' (floor) and '#' (wall)
+        static Map CreateMap(const std::vector<std::string>& rows)
+        {
+            const int width = static_cast<int>(rows[0].size());
+            const int height = static_cast<int>(rows.size());
+            std::vector<TileType> data;
+            for (const auto& row : rows) {
+                for (const char c : row) {
+                    data.push_back(c == '.' ? TileType::Floor : TileType::Wall);
+                }
+            }
+            Map map;
+            map.Init("Regions", width, height, std::move(data));
+            return map;
+        }
+
+        // Incremental labels must partition the tiles exactly like a fresh build
+        static void AssertMatchesRebuild(const Map& map)
+        {
+            MapRegionIndex fresh;
+            fresh.Build(map);
+            Assert::AreEqual(fresh.GetRegionCount(), map.GetRegionIndex().GetRegionCount());
+
+            std::map<MapRegionIndex::RegionId, MapRegionIndex::RegionId> toFresh;
+            for (int y = 0; y < map.GetHeight(); ++y) {
+                for (int x = 0; x < map.GetWidth(); ++x) {
+                    const auto region = map.GetRegion(x, y);
+                    const auto expected = fresh.GetRegion(x, y);
+                    Assert::AreEqual(expected == MapRegionIndex::kNoRegion, region == MapRegionIndex::kNoRegion);
+                    if (region == MapRegionIndex::kNoRegion) {
+                        continue;
+                    }
+                    const auto [it, inserted] = toFresh.emplace(region, expected);
+                    Assert::AreEqual(expected, it->second);
+                    Assert::AreEqual(fresh.GetRegionSize(expected), map.GetRegionIndex().GetRegionSize(region));
+                }
+            }
+        }
+
+        TEST_METHOD(DisabledByDefault)
+        {
+            const Map map = CreateMap({"..", ".."});
+            Assert::IsFalse(map.HasRegionIndex());
+            Assert::AreEqual(MapRegionIndex::kNoRegion, map.GetRegion(0, 0));
+        }
+
+        TEST_METHOD(SeparatesWalledRooms)
+        {
+            Map map = CreateMap({
+                "..#..",
+                "..#..",
+                "#####",
+                ".#...",
+            });
+            map.EnableRegionIndex();
+
+            Assert::AreEqual(size_t{4}, map.GetRegionIndex().GetRegionCount());
+            Assert::AreEqual(map.GetRegion(0, 0), map.GetRegion(1, 1));
+            Assert::AreNotEqual(map.GetRegion(0, 0), map.GetRegion(3, 0));
+            Assert::AreNotEqual(map.GetRegion(0, 3), map.GetRegion(2, 3));
+            Assert::AreEqual(MapRegionIndex::kNoRegion, map.GetRegion(2, 0));
+            Assert::AreEqual(size_t{3}, map.GetRegionIndex().GetRegionSize(map.GetRegion(4, 3)));
+        }
+
+        TEST_METHOD(DiagonalContactDoesNotConnect)
+        {
+            // Movement cannot cut the corner between the two floor tiles
+            Map map = CreateMap({".#", "#."});
+            map.EnableRegionIndex();
+            Assert::AreNotEqual(map.GetRegion(0, 0), map.GetRegion(1, 1));
+        }
+
+        TEST_METHOD(OpeningWallMergesRegions)
+        {
+            Map map = CreateMap({"..#..", "..#.."});
+            map.EnableRegionIndex();
+            Assert::AreEqual(size_t{2}, map.GetRegionIndex().GetRegionCount());
+
+            map.SetTile(2, 1, TileType::Floor);
+            Assert::AreEqual(size_t{1}, map.GetRegionIndex().GetRegionCount());
+            Assert::AreEqual(map.GetRegion(0, 0), map.GetRegion(4, 0));
+            AssertMatchesRebuild(map);
+        }
+
+        TEST_METHOD(ClosingGapSplitsRegion)
+        {
+            Map map = CreateMap({"..#..", "....."});
+            map.EnableRegionIndex();
+            Assert::AreEqual(size_t{1}, map.GetRegionIndex().GetRegionCount());
+
+            map.SetTile(2, 1, TileType::Water);
+            Assert::AreEqual(size_t{2}, map.GetRegionIndex().GetRegionCount());
+            Assert::AreNotEqual(map.GetRegion(0, 0), map.GetRegion(4, 0));
+            AssertMatchesRebuild(map);
+        }
+
+        TEST_METHOD(RandomEditsMatchRebuild)
+        {
+            std::mt19937 rng(1234);
+            std::vector<TileType> data(40 * 30);
+            for (auto& tile : data) {
+                tile = rng() % 5 < 3 ? TileType::Floor : TileType::Wall;
+            }
+            Map map;
+            map.Init("Random", 40, 30, data);
+            map.EnableRegionIndex();
+
+            for (int i = 0; i < 2000; ++i) {
+                const int x = static_cast<int>(rng() % 40);
+                const int y = static_cast<int>(rng() % 30);
+                map.SetTile(x, y, rng() % 2 ? TileType::Floor : TileType::Wall);
+                if (i % 100 == 0) {
+                    AssertMatchesRebuild(map);
+                }
+            }
+            AssertMatchesRebuild(map);
+        }
+
+        TEST_METHOD(ReinitRebuildsLabels)
+        {
+            Map map = CreateMap({"..#..", "..#.."});
+            map.EnableRegionIndex();
+            map.Init("Open", 3, 3, std::vector<TileType>(9, TileType::Floor));
+
+            Assert::IsTrue(map.HasRegionIndex());
+            Assert::AreEqual(size_t{1}, map.GetRegionIndex().GetRegionCount());
+            Assert::AreEqual(size_t{9}, map.GetRegionIndex().GetRegionSize(map.GetRegion(2, 2)));
+        }
+    };
+
+    TEST_CLASS(MapRowSpans)
+    {
+    public:
+        static std::vector<TileType> Pattern(int width, int height)
+        {
+            std::vector<TileType> data(static_cast<size_t>(width) * static_cast<size_t>(height));
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = static_cast<TileType>(i % 3);
+            }
+            return data;
+        }
+
+        // Every tile of `area` inside the map, visited through ForEachInRect
+        static void AssertVisitsRect(const Map& map, MapRect area)
+        {
+            int expectedX = std::max(area.x, 0);
+            int expectedY = std::max(area.y, 0);
+            int visited = 0;
+            map.ForEachInRect(area, [&](int x, int y, TileType tile) {
+                Assert::AreEqual(expectedX, x);
+                Assert::AreEqual(expectedY, y);
+                Assert::IsTrue(map.GetTile(x, y) == tile);
+                ++visited;
+                if (++expectedX == std::min(area.x + area.width, map.GetWidth())) {
+                    expectedX = std::max(area.x, 0);
+                    ++expectedY;
+                }
+            });
+
+            const int width = std::min(area.x + area.width, map.GetWidth()) - std::max(area.x, 0);
+            const int height = std::min(area.y + area.height, map.GetHeight()) - std::max(area.y, 0);
+            Assert::AreEqual(std::max(width, 0) * std::max(height, 0), visited);
+        }
+
+        TEST_METHOD(RowSpanViewsStorage)
+        {
+            Map map;
+            map.Init("Rows", 13, 7, Pattern(13, 7));
+
+            Assert::IsTrue(map.HasContiguousRows());
+            for (int y = 0; y < 7; ++y) {
+                const auto row = map.GetRowSpan(y);
+                Assert::AreEqual(size_t{13}, row.size());
+                for (int x = 0; x < 13; ++x) {
+                    Assert::IsTrue(map.GetTile(x, y) == row[static_cast<size_t>(x)]);
+                }
+            }
+            Assert::IsTrue(map.GetRowSpan(-1).empty());
+            Assert::IsTrue(map.GetRowSpan(7).empty());
+        }
+
+        TEST_METHOD(RowSpanEmptyWithoutContiguousRows)
+        {
+            Map tiled;
+            tiled.Init("Tiled", 13, 7, Pattern(13, 7), MapLayout::Tiled8x8);
+            Map chunked;
+            chunked.InitChunked("Chunked", 100, 100);
+
+            Assert::IsFalse(tiled.HasContiguousRows());
+            Assert::IsTrue(tiled.GetRowSpan(0).empty());
+            Assert::IsFalse(chunked.HasContiguousRows());
+            Assert::IsTrue(chunked.GetRowSpan(0).empty());
+        }
+
+        TEST_METHOD(BorderedRowsSkipSentinels)
+        {
+            Map map;
+            map.Init("Bordered", 9, 4, Pattern(9, 4), MapLayout::RowMajor, 2);
+
+            const auto row = map.GetRowSpan(3);
+            Assert::AreEqual(size_t{9}, row.size());
+            Assert::IsTrue(map.GetTile(0, 3) == row.front());
+            Assert::IsTrue(map.GetTile(8, 3) == row.back());
+        }
+
+        TEST_METHOD(ForEachInRectMatchesGetTileInEveryLayout)
+        {
+            Map rowMajor;
+            rowMajor.Init("RowMajor", 21, 11, Pattern(21, 11));
+            Map tiled;
+            tiled.Init("Tiled", 21, 11, Pattern(21, 11), MapLayout::Tiled8x8);
+            Map chunked;
+            chunked.InitChunked("Chunked", 150, 90, TileType::Wall);
+            chunked.SetTile(70, 40, TileType::Floor);
+
+            for (const Map* map : {&rowMajor, &tiled, &chunked}) {
+                AssertVisitsRect(*map, {0, 0, map->GetWidth(), map->GetHeight()});
+                AssertVisitsRect(*map, {3, 2, 9, 5});
+                AssertVisitsRect(*map, {-4, -2, 10, 6});
+                AssertVisitsRect(*map, {map->GetWidth() - 2, 1, 10, 3});
+                AssertVisitsRect(*map, {map->GetWidth(), 0, 5, 5});
+            }
+        }
+
+        TEST_METHOD(RowVisitorReceivesClippedRows)
+        {
+            Map map;
+            map.Init("Rows", 10, 6, Pattern(10, 6));
+
+            std::vector<int> rows;
+            map.ForEachRowInRect({-3, 4, 8, 10}, [&](int x, int y, std::span<const TileType> row) {
+                Assert::AreEqual(0, x);
+                Assert::AreEqual(size_t{5}, row.size());
+                Assert::IsTrue(map.GetTile(4, y) == row[4]);
+                rows.push_back(y);
+            });
+
+            Assert::AreEqual(size_t{2}, rows.size());
+            Assert::AreEqual(4, rows[0]);
+            Assert::AreEqual(5, rows[1]);
+        }
+
+        TEST_METHOD(VisitorReturningFalseStops)
+        {
+            Map map;
+            map.Init("Rows", 10, 6, Pattern(10, 6));
+
+            int rows = 0;
+            map.ForEachRowInRect({0, 0, 10, 6}, [&](int, int y, std::span<const TileType>) {
+                ++rows;
+                return y < 2;
+            });
+            int tiles = 0;
+            map.ForEachInRect({0, 0, 10, 6}, [&](int x, int y, TileType) {
+                ++tiles;
+                return !(x == 4 && y == 1);
+            });
+
+            Assert::AreEqual(3, rows);
+            Assert::AreEqual(15, tiles);
+        }
+    };
+
     TEST_CLASS(MapMemory)
     {
     public:
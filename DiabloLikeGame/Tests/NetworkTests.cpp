@@ -2,6 +2,8 @@
 #include "../Net/EntityId.h"
 #include "../Net/NetMessage.h"
 #include "../Net/NetworkAuthority.h"
+#include "Common/Map.h"
+#include "Common/SeededMap.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -206,6 +208,93 @@ namespace NetworkTests
             Assert::AreEqual(e2.entityId.value, deserialized.entities[1].entityId.value);
         }
 
+        TEST_METHOD(MapDataRoundTripsTiles)
+        {
+            Map map;
+            std::vector<TileType> tiles(40 * 30, TileType::Wall);
+            tiles[5] = TileType::Floor;
+            tiles[1000] = TileType::Water;
+            map.Init("Arena", 40, 30, tiles);
+
+            NetMessage::Message msg;
+            msg.header.type = NetMessage::Type::MapData;
+            msg.data = NetMessage::MapData::FromMap(map);
+
+            auto deserialized = NetMessage::Message::Deserialize(msg.Serialize());
+            Assert::IsTrue(deserialized.has_value());
+
+            const auto& mapData = std::get<NetMessage::MapData>(deserialized->data);
+            Map received;
+            Assert::IsTrue(mapData.ApplyTo(received));
+            Assert::AreEqual(std::string("Arena"), received.GetName());
+            Assert::AreEqual(40, received.GetWidth());
+            Assert::IsTrue(TileType::Floor == received.GetTile(5, 0));
+            Assert::IsTrue(TileType::Water == received.GetTile(1000 % 40, 1000 / 40));
+            Assert::IsTrue(TileType::Wall == received.GetTile(39, 29));
+        }
+
+        TEST_METHOD(MapDataCarriesSeededMaps)
+        {
+            MapGenerator::Config config;
+            config.width = 120;
+            config.height = 90;
+            config.seed = 31337;
+            SeededMap seeded(config);
+            seeded.SetTile(60, 45, TileType::Water);
+
+            NetMessage::Message msg;
+            msg.header.type = NetMessage::Type::MapData;
+            msg.data = NetMessage::MapData::FromSeededMap(seeded);
+            const auto bytes = msg.Serialize();
+            Assert::IsTrue(bytes.size() < 512);
+
+            auto deserialized = NetMessage::Message::Deserialize(bytes);
+            Assert::IsTrue(deserialized.has_value());
+            const auto& mapData = std::get<NetMessage::MapData>(deserialized->data);
+            Map received;
+            Assert::IsTrue(mapData.ApplyTo(received));
+
+            const Map expected = seeded.Materialize();
+            Assert::AreEqual(120, received.GetWidth());
+            Assert::IsTrue(TileType::Water == received.GetTile(60, 45));
+            for (int y = 0; y < 90; ++y) {
+                for (int x = 0; x < 120; ++x) {
+                    Assert::IsTrue(expected.GetTile(x, y) == received.GetTile(x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(MapDataRejectsOversizedDimensions)
+        {
+            Map map;
+            map.Init("Small", 4, 4, std::vector<TileType>(16, TileType::Floor));
+            NetMessage::MapData data = NetMessage::MapData::FromMap(map);
+            data.width = 1 << 30;
+            data.height = 1 << 30;
+
+            Map received;
+            received.Init("Keep", 2, 2, std::vector<TileType>(4, TileType::Wall));
+            Assert::IsFalse(data.ApplyTo(received));
+            Assert::AreEqual(std::string("Keep"), received.GetName());
+
+            // The cap is for peers only: the same stream decodes from a local file
+            Map wide;
+            wide.Init("Wide", NetMessage::MapData::kMaxDimension + 1, 2,
+                      std::vector<TileType>(static_cast<size_t>(NetMessage::MapData::kMaxDimension + 1) * 2, TileType::Wall));
+            data = NetMessage::MapData::FromMap(wide);
+            Assert::IsFalse(data.ApplyTo(received));
+            Assert::AreEqual(std::string("Keep"), received.GetName());
+            Assert::IsTrue(received.InitFromRle(data.name, data.width, data.height, data.tiles));
+
+            // Seeded payloads are capped before anything is generated
+            MapGenerator::Config config;
+            config.width = NetMessage::MapData::kMaxDimension + 1;
+            config.height = 10;
+            config.seed = 3;
+            data = NetMessage::MapData::FromSeededMap(SeededMap(config));
+            Assert::IsFalse(data.ApplyTo(received));
+        }
+
         TEST_METHOD(FullMessageSerializesAndDeserializes)
         {
             NetMessage::Message msg;
@@ -348,6 +348,63 @@ namespace PathfinderTests
             }
         }
 
+        TEST_METHOD(OpenMapEdgesStayInBounds)
+        {
+            // Width 64 puts the right edge on a walkability word boundary
+            auto map = CreateOpenMap(64, 2);
+            auto path = Pathfinder::FindPath(0, 0, 63, 1, map);
+            Assert::IsFalse(path.empty());
+            for (const auto& pos : path) {
+                Assert::IsTrue(map.IsInBounds(static_cast<int>(pos.x), static_cast<int>(pos.y)));
+            }
+        }
+
+        TEST_METHOD(NeighborWalkableCoversSentinelRing)
+        {
+            auto map = CreateOpenMap(64, 2);
+            for (int y = -1; y <= 2; ++y) {
+                for (int x = -1; x <= 64; ++x) {
+                    Assert::AreEqual(Pathfinder::IsTileWalkable(map, x, y),
+                                     Pathfinder::IsNeighborWalkable(map, x, y));
+                }
+            }
+        }
+
+        TEST_METHOD(CrossRegionRequestIsRejected)
+        {
+            auto map = CreateTestMap(5, 3, {
+                {TileType::Floor, TileType::Floor, TileType::Wall, TileType::Floor, TileType::Floor},
+                {TileType::Floor, TileType::Floor, TileType::Wall, TileType::Floor, TileType::Floor},
+                {TileType::Floor, TileType::Floor, TileType::Wall, TileType::Floor, TileType::Floor}
+            });
+            map.EnableRegionIndex();
+            Assert::IsTrue(Pathfinder::FindPath(0, 0, 4, 2, map).empty());
+
+            // Opening the wall joins the regions and the path is found again
+            map.SetTile(2, 1, TileType::Floor);
+            Assert::IsFalse(Pathfinder::FindPath(0, 0, 4, 2, map).empty());
+        }
+
+        TEST_METHOD(MoveCostSteersAroundExpensiveTiles)
+        {
+            // A walkable tile type that costs 10x to enter
+            const TileType mud = static_cast<TileType>(4);
+            TileTable::Set(mud, {true, false, 10.0f, TileRenderClass::Ground});
+
+            auto map = CreateTestMap(5, 3, {
+                {TileType::Floor, TileType::Floor, TileType::Floor, TileType::Floor, TileType::Floor},
+                {TileType::Floor, TileType::Floor, mud,             TileType::Floor, TileType::Floor},
+                {TileType::Floor, TileType::Floor, TileType::Floor, TileType::Floor, TileType::Floor}
+            });
+            auto path = Pathfinder::FindPath(0, 1, 4, 1, map);
+            TileTable::Reset();
+
+            Assert::IsFalse(path.empty());
+            for (const auto& pos : path) {
+                Assert::IsFalse(pos.x == 2.0f && pos.y == 1.0f);
+            }
+        }
+
         TEST_METHOD(WaterIsNotWalkable)
         {
             auto map = CreateTestMap(3, 3, {
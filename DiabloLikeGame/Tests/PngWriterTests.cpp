@@ -0,0 +1,264 @@
+#include "CppUnitTest.h"
+#include "Common/PngWriter.h"
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace PngWriterTests
+{
+    // Deflate bit stream: values are packed least significant bit first,
+    // Huffman codes most significant bit first
+    class BitReader {
+    public:
+        explicit BitReader(std::span<const uint8_t> data) : m_data(data) {}
+
+        uint32_t Bits(int count) {
+            uint32_t value = 0;
+            for (int i = 0; i < count; ++i) {
+                value |= Bit() << i;
+            }
+            return value;
+        }
+
+        uint32_t Code(int count) {
+            uint32_t code = 0;
+            for (int i = 0; i < count; ++i) {
+                code = (code << 1) | Bit();
+            }
+            return code;
+        }
+
+        [[nodiscard]] bool Overrun() const { return m_bit > m_data.size() * 8; }
+        [[nodiscard]] size_t BytesUsed() const { return (m_bit + 7) / 8; }
+
+    private:
+        uint32_t Bit() {
+            const size_t byte = m_bit / 8;
+            const uint32_t bit = byte < m_data.size() ? (m_data[byte] >> (m_bit % 8)) & 1u : 0;
+            ++m_bit;
+            return bit;
+        }
+
+        std::span<const uint8_t> m_data;
+        size_t m_bit = 0;
+    };
+
+    // Literal/length symbol of the fixed Huffman code (RFC 1951 3.2.6)
+    uint32_t ReadFixedSymbol(BitReader& bits)
+    {
+        uint32_t code = bits.Code(7);
+        if (code <= 0x17) return 256 + code;
+        code = (code << 1) | bits.Code(1);
+        if (code >= 0x30 && code <= 0xBF) return code - 0x30;
+        if (code >= 0xC0 && code <= 0xC7) return 280 + code - 0xC0;
+        code = (code << 1) | bits.Code(1);
+        return 144 + code - 0x190;
+    }
+
+    // Independent inflate of a zlib stream, limited to the fixed-Huffman
+    // blocks PngWriter emits; nullopt on any malformed or trailing data
+    std::optional<std::vector<uint8_t>> Inflate(std::span<const uint8_t> stream)
+    {
+        static constexpr uint32_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                     35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr int kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static constexpr uint32_t kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                       257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                                       8193, 12289, 16385, 24577};
+        static constexpr int kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                   7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        // Header: deflate method, checksum over the two bytes, no preset dictionary
+        if (stream.size() < 6 || (stream[0] & 0x0F) != 8 || ((stream[0] << 8) | stream[1]) % 31 != 0 ||
+            (stream[1] & 0x20) != 0) {
+            return std::nullopt;
+        }
+        const std::span<const uint8_t> body = stream.subspan(2, stream.size() - 6);
+        BitReader bits(body);
+        std::vector<uint8_t> out;
+        for (bool last = false; !last;) {
+            last = bits.Bits(1) == 1;
+            if (bits.Bits(2) != 1) {
+                return std::nullopt;
+            }
+            for (uint32_t symbol = ReadFixedSymbol(bits); symbol != 256; symbol = ReadFixedSymbol(bits)) {
+                if (bits.Overrun() || symbol > 285) {
+                    return std::nullopt;
+                }
+                if (symbol < 256) {
+                    out.push_back(static_cast<uint8_t>(symbol));
+                    continue;
+                }
+                const uint32_t length = kLengthBase[symbol - 257] + bits.Bits(kLengthExtra[symbol - 257]);
+                const uint32_t distanceCode = bits.Code(5);
+                if (distanceCode >= 30) {
+                    return std::nullopt;
+                }
+                const size_t distance = kDistanceBase[distanceCode] + bits.Bits(kDistanceExtra[distanceCode]);
+                if (distance > out.size()) {
+                    return std::nullopt;
+                }
+                for (uint32_t i = 0; i < length; ++i) {
+                    out.push_back(out[out.size() - distance]);
+                }
+            }
+        }
+        if (bits.Overrun() || bits.BytesUsed() != body.size()) {
+            return std::nullopt;
+        }
+
+        const uint8_t* trailer = stream.data() + stream.size() - 4;
+        const uint32_t adler = uint32_t{trailer[0]} << 24 | uint32_t{trailer[1]} << 16 |
+                               uint32_t{trailer[2]} << 8 | uint32_t{trailer[3]};
+        if (adler != PngWriter::Adler32(out)) {
+            return std::nullopt;
+        }
+        return out;
+    }
+
+    uint32_t ReadBigEndian(const uint8_t* bytes)
+    {
+        return uint32_t{bytes[0]} << 24 | uint32_t{bytes[1]} << 16 | uint32_t{bytes[2]} << 8 | uint32_t{bytes[3]};
+    }
+
+    std::span<const uint8_t> AsBytes(std::string_view text)
+    {
+        return {reinterpret_cast<const uint8_t*>(text.data()), text.size()};
+    }
+
+    TEST_CLASS(ChecksumTests)
+    {
+    public:
+        TEST_METHOD(Crc32MatchesStandardCheckValue)
+        {
+            Assert::AreEqual(0xCBF43926u, PngWriter::Crc32(AsBytes("123456789")));
+            Assert::AreEqual(0u, PngWriter::Crc32({}));
+        }
+
+        TEST_METHOD(Crc32ContinuesAcrossCalls)
+        {
+            const uint32_t first = PngWriter::Crc32(AsBytes("12345"));
+            Assert::AreEqual(0xCBF43926u, PngWriter::Crc32(AsBytes("6789"), first));
+        }
+
+        TEST_METHOD(Adler32MatchesStandardValue)
+        {
+            Assert::AreEqual(0x11E60398u, PngWriter::Adler32(AsBytes("Wikipedia")));
+            Assert::AreEqual(1u, PngWriter::Adler32({}));
+        }
+    };
+
+    TEST_CLASS(ZlibCompressTests)
+    {
+    public:
+        static void AssertRoundTrips(const std::vector<uint8_t>& data)
+        {
+            const std::optional<std::vector<uint8_t>> inflated = Inflate(PngWriter::ZlibCompress(data));
+            Assert::IsTrue(inflated.has_value());
+            Assert::IsTrue(data == *inflated);
+        }
+
+        TEST_METHOD(RoundTripsShortInputs)
+        {
+            AssertRoundTrips({});
+            AssertRoundTrips({42});
+            AssertRoundTrips({1, 2});
+            AssertRoundTrips({7, 7, 7});
+        }
+
+        TEST_METHOD(RoundTripsLongRunsAndFarMatches)
+        {
+            // Runs longer than the longest match, and repeats beyond the 32 KB window
+            std::vector<uint8_t> data(1000, 9);
+            for (int i = 0; i < 40000; ++i) {
+                data.push_back(static_cast<uint8_t>(i % 251));
+            }
+            const std::vector<uint8_t> repeat(data.begin(), data.begin() + 5000);
+            data.insert(data.end(), repeat.begin(), repeat.end());
+            AssertRoundTrips(data);
+        }
+
+        TEST_METHOD(RoundTripsNoise)
+        {
+            std::vector<uint8_t> data(70000);
+            uint32_t state = 12345;
+            for (uint8_t& byte : data) {
+                state = state * 1664525u + 1013904223u;
+                byte = static_cast<uint8_t>(state >> 24);
+            }
+            AssertRoundTrips(data);
+        }
+
+        TEST_METHOD(CompressesRuns)
+        {
+            const std::vector<uint8_t> data(100000, 0);
+            Assert::IsTrue(PngWriter::ZlibCompress(data).size() < 1000);
+        }
+    };
+
+    TEST_CLASS(EncodeRgbTests)
+    {
+    public:
+        TEST_METHOD(ChunksDecodeToThePixels)
+        {
+            constexpr int kWidth = 7;
+            constexpr int kHeight = 5;
+            std::vector<uint8_t> rgb;
+            for (int y = 0; y < kHeight; ++y) {
+                for (int x = 0; x < kWidth; ++x) {
+                    rgb.insert(rgb.end(), {static_cast<uint8_t>(x * 30), static_cast<uint8_t>(y * 50), 200});
+                }
+            }
+            const std::vector<uint8_t> png = PngWriter::EncodeRgb(kWidth, kHeight, rgb);
+
+            const std::vector<uint8_t> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+            Assert::IsTrue(png.size() > signature.size());
+            Assert::IsTrue(std::equal(signature.begin(), signature.end(), png.begin()));
+
+            // Every chunk's CRC covers its type and data
+            std::vector<std::string> types;
+            std::vector<uint8_t> header;
+            std::vector<uint8_t> idat;
+            for (size_t pos = signature.size(); pos < png.size();) {
+                Assert::IsTrue(pos + 12 <= png.size());
+                const uint32_t length = ReadBigEndian(&png[pos]);
+                Assert::IsTrue(pos + 12 + length <= png.size());
+                const std::span<const uint8_t> typeAndData(&png[pos + 4], length + 4);
+                Assert::AreEqual(ReadBigEndian(&png[pos + 8 + length]), PngWriter::Crc32(typeAndData));
+
+                const std::string type(typeAndData.begin(), typeAndData.begin() + 4);
+                const auto data = typeAndData.subspan(4);
+                types.push_back(type);
+                if (type == "IHDR") header.assign(data.begin(), data.end());
+                if (type == "IDAT") idat.insert(idat.end(), data.begin(), data.end());
+                pos += 12 + length;
+            }
+            Assert::IsTrue(types == std::vector<std::string>{"IHDR", "IDAT", "IEND"});
+
+            Assert::AreEqual(size_t{13}, header.size());
+            Assert::AreEqual(static_cast<uint32_t>(kWidth), ReadBigEndian(&header[0]));
+            Assert::AreEqual(static_cast<uint32_t>(kHeight), ReadBigEndian(&header[4]));
+            Assert::AreEqual(8, static_cast<int>(header[8]));    // Bit depth
+            Assert::AreEqual(2, static_cast<int>(header[9]));    // RGB
+
+            // Scanlines: filter byte 0, then the row's pixels
+            const std::optional<std::vector<uint8_t>> raw = Inflate(idat);
+            Assert::IsTrue(raw.has_value());
+            Assert::AreEqual(static_cast<size_t>(kHeight * (1 + kWidth * 3)), raw->size());
+            std::vector<uint8_t> pixels;
+            for (int y = 0; y < kHeight; ++y) {
+                const auto row = raw->begin() + y * (1 + kWidth * 3);
+                Assert::AreEqual(0, static_cast<int>(*row));
+                pixels.insert(pixels.end(), row + 1, row + 1 + kWidth * 3);
+            }
+            Assert::IsTrue(rgb == pixels);
+        }
+    };
+}
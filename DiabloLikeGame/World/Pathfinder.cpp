@@ -53,10 +53,8 @@ float Pathfinder::Heuristic(int x1, int y1, int x2, int y2) noexcept
 
 bool Pathfinder::IsTileWalkable(const Map& map, int x, int y) noexcept
 {
-    if (x < 0 || x >= map.GetWidth() || y < 0 || y >= map.GetHeight()) {
-        return false;
-    }
-    return map.GetTileUnchecked(x, y) == TileType::Floor;
+    // Single bit test against the map's walkability plane
+    return map.IsWalkable(x, y);
 }
 
 bool Pathfinder::IsTileWalkable(const Map& map, const OccupancyMap& occupancy, int x, int y) noexcept
@@ -67,6 +65,11 @@ bool Pathfinder::IsTileWalkable(const Map& map, const OccupancyMap& occupancy, i
     return !occupancy.IsOccupied(x, y);
 }
 
+bool Pathfinder::IsNeighborWalkable(const Map& map, int x, int y) noexcept
+{
+    return map.IsWalkableUnchecked(x, y);
+}
+
 template<typename WalkableCheck>
 std::vector<Vector2> Pathfinder::FindPathImpl(int startX, int startY, int endX, int endY,
                                                const Map& map, WalkableCheck&& isWalkable)
@@ -86,6 +89,11 @@ std::vector<Vector2> Pathfinder::FindPathImpl(int startX, int startY, int endX,
         return {};
     }
     
+    // Tiles in different regions can never connect: reject before searching
+    if (map.HasRegionIndex() && map.GetRegion(startX, startY) != map.GetRegion(endX, endY)) {
+        return {};
+    }
+    
     // Initialize start node
     const float startH = Heuristic(startX, startY, endX, endY);
     m_openHeap.push_back({startX, startY, 0.0f, startH});
@@ -125,7 +133,8 @@ std::vector<Vector2> Pathfinder::FindPathImpl(int startX, int startY, int endX,
         m_closedSet.insert(currentKey);
         m_openSet.erase(currentKey);
         
-        // Explore neighbors
+        // Explore neighbors (every expanded node is walkable, hence in bounds,
+        // so its neighbours can be tested without bounds checks)
         for (int i = 0; i < 8; ++i) {
             const int nx = current.x + kDirX[i];
             const int ny = current.y + kDirY[i];
@@ -137,17 +146,18 @@ std::vector<Vector2> Pathfinder::FindPathImpl(int startX, int startY, int endX,
             // Check walkability - allow destination even if occupied (we want to get close to it)
             const bool isDestination = (neighborKey == endKey);
             if (!isDestination && !isWalkable(nx, ny)) continue;
-            if (isDestination && !IsTileWalkable(map, nx, ny)) continue;
+            if (isDestination && !IsNeighborWalkable(map, nx, ny)) continue;
             
             // For diagonal moves, check corner cutting
             if (i % 2 == 1) {  // Diagonal directions (1, 3, 5, 7)
-                if (!IsTileWalkable(map, current.x + kDirX[i], current.y) ||
-                    !IsTileWalkable(map, current.x, current.y + kDirY[i])) {
+                if (!IsNeighborWalkable(map, current.x + kDirX[i], current.y) ||
+                    !IsNeighborWalkable(map, current.x, current.y + kDirY[i])) {
                     continue;
                 }
             }
             
-            const float tentativeG = current.g + kDirCosts[i];
+            const float tentativeG = current.g +
+                kDirCosts[i] * TileTable::Get(map.GetTileUnchecked(nx, ny)).moveCost;
             
             auto gIt = m_gScores.find(neighborKey);
             if (gIt == m_gScores.end() || tentativeG < gIt->second) {
@@ -169,12 +179,14 @@ std::vector<Vector2> Pathfinder::FindPathImpl(int startX, int startY, int endX,
 std::vector<Vector2> Pathfinder::FindPathInternal(int startX, int startY, int endX, int endY, const Map& map)
 {
     return FindPathImpl(startX, startY, endX, endY, map, 
-        [&map](int x, int y) { return IsTileWalkable(map, x, y); });
+        [&map](int x, int y) { return IsNeighborWalkable(map, x, y); });
 }
 
 std::vector<Vector2> Pathfinder::FindPathInternal(int startX, int startY, int endX, int endY, 
                                            const Map& map, const OccupancyMap& occupancy)
 {
     return FindPathImpl(startX, startY, endX, endY, map,
-        [&map, &occupancy](int x, int y) { return IsTileWalkable(map, occupancy, x, y); });
+        [&map, &occupancy](int x, int y) {
+            return IsNeighborWalkable(map, x, y) && !occupancy.IsOccupied(x, y);
+        });
 }
@@ -37,6 +37,10 @@ public:
     // Check if a tile is walkable and not occupied
     [[nodiscard]] static bool IsTileWalkable(const Map& map, const OccupancyMap& occupancy, int x, int y) noexcept;
     
+    // Walkability of a neighbour of an in-bounds tile, without bounds checks
+    // (the map's walkability plane has a sentinel ring one tile wide)
+    [[nodiscard]] static bool IsNeighborWalkable(const Map& map, int x, int y) noexcept;
+    
     // Movement costs (geometric correct values)
     static constexpr float ORTHOGONAL_COST = 1.0f;
     static constexpr float DIAGONAL_COST = 1.41421356f;  // sqrt(2)
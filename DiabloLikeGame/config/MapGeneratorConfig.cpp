@@ -1,5 +1,17 @@
 #include "MapGeneratorConfig.h"
 #include "../Core/IniParser.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+    // "keep", "fill" or "tunnel" (anything else keeps regions as generated)
+    MapGenerator::Connectivity ParseConnectivity(const std::string& mode)
+    {
+        if (mode == "fill") return MapGenerator::Connectivity::FillPockets;
+        if (mode == "tunnel") return MapGenerator::Connectivity::CarveTunnels;
+        return MapGenerator::Connectivity::Keep;
+    }
+}
 
 bool MapGeneratorConfig::Load(const char* filename)
 {
@@ -16,6 +28,8 @@ bool MapGeneratorConfig::Load(const char* filename)
     s_defaultConfig.wallThreshold = ini.GetInt("Default", "WallThreshold", 4);
     s_defaultConfig.waterChance = ini.GetFloat("Default", "WaterChance", 0.02f);
     s_defaultConfig.seed = static_cast<unsigned int>(ini.GetInt("Default", "Seed", 0));
+    s_defaultConfig.connectivity = ParseConnectivity(ini.GetString("Default", "Connectivity", "keep"));
+    s_defaultConfig.minRegionSize = ini.GetInt("Default", "MinRegionSize", 24);
     
     // Load Small preset
     s_smallConfig.width = ini.GetInt("Small", "Width", 50);
@@ -25,6 +39,8 @@ bool MapGeneratorConfig::Load(const char* filename)
     s_smallConfig.wallThreshold = ini.GetInt("Small", "WallThreshold", 4);
     s_smallConfig.waterChance = ini.GetFloat("Small", "WaterChance", 0.01f);
     s_smallConfig.seed = static_cast<unsigned int>(ini.GetInt("Small", "Seed", 0));
+    s_smallConfig.connectivity = ParseConnectivity(ini.GetString("Small", "Connectivity", "keep"));
+    s_smallConfig.minRegionSize = ini.GetInt("Small", "MinRegionSize", 24);
     
     // Load Large preset
     s_largeConfig.width = ini.GetInt("Large", "Width", 400);
@@ -34,6 +50,17 @@ bool MapGeneratorConfig::Load(const char* filename)
     s_largeConfig.wallThreshold = ini.GetInt("Large", "WallThreshold", 4);
     s_largeConfig.waterChance = ini.GetFloat("Large", "WaterChance", 0.03f);
     s_largeConfig.seed = static_cast<unsigned int>(ini.GetInt("Large", "Seed", 0));
+    s_largeConfig.connectivity = ParseConnectivity(ini.GetString("Large", "Connectivity", "keep"));
+    s_largeConfig.minRegionSize = ini.GetInt("Large", "MinRegionSize", 24);
+    
+    // Load streamed world settings (chunks are always 64x64; no width/height)
+    s_worldStreaming = ini.GetInt("World", "Streaming", 0) != 0;
+    s_worldChunkRadius = std::max(ini.GetInt("World", "ChunkRadius", 3), 1);
+    s_worldConfig.wallDensity = ini.GetFloat("World", "WallDensity", 0.45f);
+    s_worldConfig.smoothIterations = ini.GetInt("World", "SmoothIterations", 5);
+    s_worldConfig.wallThreshold = ini.GetInt("World", "WallThreshold", 4);
+    s_worldConfig.waterChance = ini.GetFloat("World", "WaterChance", 0.02f);
+    s_worldConfig.seed = static_cast<unsigned int>(ini.GetInt("World", "Seed", 0));
     
     s_loaded = true;
     return true;
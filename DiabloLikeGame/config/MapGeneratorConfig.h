@@ -20,10 +20,19 @@ public:
     [[nodiscard]] static MapGenerator::Config GetDefault() { return s_defaultConfig; }
     [[nodiscard]] static MapGenerator::Config GetSmall() { return s_smallConfig; }
     [[nodiscard]] static MapGenerator::Config GetLarge() { return s_largeConfig; }
+    
+    // [World]: unbounded world streamed in chunks around the player (see
+    // WorldStreamer). Used when no map file loads and Streaming=1.
+    [[nodiscard]] static bool IsWorldStreamingEnabled() { return s_worldStreaming; }
+    [[nodiscard]] static MapGenerator::Config GetWorld() { return s_worldConfig; }
+    [[nodiscard]] static int GetWorldChunkRadius() { return s_worldChunkRadius; }
 
 private:
     inline static MapGenerator::Config s_defaultConfig{};
     inline static MapGenerator::Config s_smallConfig{};
     inline static MapGenerator::Config s_largeConfig{};
+    inline static MapGenerator::Config s_worldConfig{};
+    inline static bool s_worldStreaming = false;
+    inline static int s_worldChunkRadius = 3;
     inline static bool s_loaded = false;
 };
@@ -0,0 +1,199 @@
+#include "BatchMode.h"
+#include "../Common/Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <sstream>
+#include <string_view>
+
+void TileCounts::Add(std::span<const TileType> tiles) noexcept
+{
+    // Branch-free counting vectorizes
+    int64_t floors = 0, walls = 0, waters = 0;
+    for (const TileType tile : tiles) {
+        floors += tile == TileType::Floor;
+        walls += tile == TileType::Wall;
+        waters += tile == TileType::Water;
+    }
+    floor += floors;
+    wall += walls;
+    water += waters;
+}
+
+TileCounts CountTiles(const Map& map)
+{
+    TileCounts counts;
+    map.ForEachRowInRect({0, 0, map.GetWidth(), map.GetHeight()},
+        [&](int, int, std::span<const TileType> row) { counts.Add(row); });
+    return counts;
+}
+
+namespace {
+    bool ParseSeed(std::string_view text, unsigned int& seed)
+    {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), seed);
+        return error == std::errc{} && end == text.data() + text.size();
+    }
+
+    bool ParseInt(std::string_view text, int& value)
+    {
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return error == std::errc{} && end == text.data() + text.size();
+    }
+
+    const char* Extension(MapFileFormat format)
+    {
+        return format == MapFileFormat::Text ? ".txt" : ".dmap";
+    }
+}
+
+bool ParseSeedRange(const std::string& text, unsigned int& first, unsigned int& last)
+{
+    const std::string_view range = text;
+    const size_t dash = range.find('-');
+    if (dash == std::string_view::npos) {
+        if (!ParseSeed(range, first)) return false;
+        last = first;
+    } else if (!ParseSeed(range.substr(0, dash), first) || !ParseSeed(range.substr(dash + 1), last)) {
+        return false;
+    }
+    return first != 0 && last >= first;
+}
+
+namespace Batch {
+
+    bool AddSeedRange(const std::string& text, const MapGenerator::Config& base, JobList& jobs)
+    {
+        unsigned int first = 0;
+        unsigned int last = 0;
+        if (!ParseSeedRange(text, first, last)) {
+            return false;
+        }
+        jobs.rangeStart = {first, base.width, base.height};
+        jobs.rangeCount = uint64_t{last - first} + 1;
+        return true;
+    }
+
+    bool LoadManifest(const std::string& filename, const MapGenerator::Config& base, JobList& jobs)
+    {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open manifest " << filename << "\n";
+            return false;
+        }
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            std::istringstream fields(line);
+            std::vector<std::string> tokens;
+            for (std::string token; fields >> token; ) {
+                tokens.push_back(std::move(token));
+            }
+            if (tokens.empty() || tokens.front().front() == '#') {
+                continue;
+            }
+
+            Job job{0, base.width, base.height};
+            bool valid = (tokens.size() == 1 || tokens.size() == 3) && ParseSeed(tokens[0], job.seed) && job.seed != 0;
+            if (valid && tokens.size() == 3) {
+                valid = ParseInt(tokens[1], job.width) && ParseInt(tokens[2], job.height);
+            }
+            if (!valid || job.width < 10 || job.height < 10 || job.width > 10000 || job.height > 10000) {
+                std::cerr << "Error: " << filename << " line " << lineNumber
+                          << ": expected \"seed\" or \"seed width height\" (seed > 0, sizes 10-10000)\n";
+                return false;
+            }
+            jobs.listed.push_back(job);
+        }
+        return true;
+    }
+
+    bool Run(const JobList& jobs, const MapGenerator::Config& base, const Options& options)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(options.outputDirectory, error);
+        std::ofstream csv(options.outputDirectory / "stats.csv");
+        if (error || !csv.is_open()) {
+            std::cerr << "Error: Cannot write to " << options.outputDirectory.string() << "\n";
+            return false;
+        }
+        csv << "seed,width,height,floor,wall,water,generate_ms,save_ms,file\n";
+
+        const uint64_t total = jobs.Size();
+        const unsigned workers = static_cast<unsigned>(std::min<uint64_t>(Parallel::ResolveThreadCount(options.workerCount),
+                                                                          std::max<uint64_t>(total, 1)));
+        std::cout << "Generating " << total << " maps on " << workers << " worker thread"
+                  << (workers == 1 ? "" : "s") << " into " << options.outputDirectory.string() << "\n";
+
+        std::atomic<uint64_t> next{0};
+        std::atomic<uint64_t> failures{0};
+        std::mutex outputMutex;
+        uint64_t finished = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        // Workers pull the next job as they finish, so uneven map sizes balance out
+        Parallel::ForEachBand(workers, [&](unsigned) {
+            for (uint64_t i = next.fetch_add(1); i < total; i = next.fetch_add(1)) {
+                const Job job = jobs.At(i);
+                MapGenerator::Config config = base;
+                config.seed = job.seed;
+                config.width = job.width;
+                config.height = job.height;
+                config.threadCount = 1;
+
+                const auto generateStart = std::chrono::steady_clock::now();
+                const Map map = MapGenerator::Generate(config);
+                const auto saveStart = std::chrono::steady_clock::now();
+                const std::string file = "map_" + std::to_string(job.seed) + Extension(options.format);
+                const bool saved = map.SaveToFile((options.outputDirectory / file).string(), options.format);
+                const auto saveEnd = std::chrono::steady_clock::now();
+                const TileCounts counts = CountTiles(map);
+                std::string thumbnail;
+                bool thumbnailSaved = true;
+                if (!options.thumbnailExtension.empty()) {
+                    Overview::Options overview = options.overview;
+                    overview.threadCount = 1;
+                    thumbnail = "map_" + std::to_string(job.seed) + options.thumbnailExtension;
+                    thumbnailSaved = Overview::SaveImage(Overview::Render(map, options.palette, overview),
+                                                         options.outputDirectory / thumbnail);
+                }
+
+                const double generateMs = std::chrono::duration<double, std::milli>(saveStart - generateStart).count();
+                const double saveMs = std::chrono::duration<double, std::milli>(saveEnd - saveStart).count();
+
+                std::lock_guard lock(outputMutex);
+                if (!saved) {
+                    failures.fetch_add(1);
+                    std::cerr << "Error: Failed to save " << file << "\n";
+                    continue;
+                }
+                if (!thumbnailSaved) {
+                    failures.fetch_add(1);
+                    std::cerr << "Error: Failed to save " << thumbnail << "\n";
+                }
+                csv << job.seed << ',' << job.width << ',' << job.height << ',' << counts.floor << ','
+                    << counts.wall << ',' << counts.water << ',' << generateMs << ',' << saveMs << ','
+                    << file << '\n';
+                if (++finished % 100 == 0) {
+                    csv.flush();
+                    std::cout << "  " << finished << "/" << total << " maps\n";
+                }
+            }
+        });
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Done: " << finished << " maps in " << seconds << " s ("
+                  << (seconds > 0.0 ? static_cast<double>(finished) / seconds : 0.0) << " maps/s), "
+                  << failures.load() << " failed\n"
+                  << "Statistics written to " << (options.outputDirectory / "stats.csv").string() << "\n";
+        return failures.load() == 0 && csv.good();
+    }
+
+} // namespace Batch
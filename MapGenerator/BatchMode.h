@@ -0,0 +1,82 @@
+#pragma once
+
+#include "MapGenerator.h"
+#include "Overview.h"
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+// Tile counts reported for every generated or imported map
+struct TileCounts {
+    int64_t floor{};
+    int64_t wall{};
+    int64_t water{};
+
+    // Count a run of tiles on top of the totals so far
+    void Add(std::span<const TileType> tiles) noexcept;
+};
+
+[[nodiscard]] TileCounts CountTiles(const Map& map);
+
+// Seeds first..last inclusive, written "first-last" (or a single seed).
+// Seed 0 means "random", so valid ranges start at 1.
+[[nodiscard]] bool ParseSeedRange(const std::string& text, unsigned int& first, unsigned int& last);
+
+// Batch mode: many maps per invocation for content pipelines
+//
+// Jobs come from a seed range or a manifest file and are handed to a pool of
+// worker threads, one map per worker at a time (each map is generated on a
+// single thread, so throughput scales with the worker count). Every map is
+// written to the output directory as soon as it is done and then freed, and
+// a row is appended to stats.csv there, so memory stays at one map per worker.
+namespace Batch {
+
+    // One map to generate: the base Config with this seed and size
+    struct Job {
+        unsigned int seed{};
+        int width{};
+        int height{};
+    };
+
+    struct Options {
+        std::filesystem::path outputDirectory = "batch";
+        MapFileFormat format = MapFileFormat::Text;
+        unsigned workerCount = 0;   // 0 = one per hardware thread
+        std::string thumbnailExtension;   // ".png" or ".ppm": also write an overview per map
+        Overview::Options overview{};     // Thumbnail view and size (rendered on the map's worker)
+        Overview::Palette palette{};
+    };
+
+    // Jobs to run: a seed range, expanded on demand so even billions of seeds
+    // cost no memory up front, followed by the manifest jobs
+    struct JobList {
+        Job rangeStart{};            // Range jobs are this job with the seed counting up
+        uint64_t rangeCount{};
+        std::vector<Job> listed;
+
+        [[nodiscard]] uint64_t Size() const noexcept { return rangeCount + listed.size(); }
+
+        [[nodiscard]] Job At(uint64_t index) const noexcept {
+            if (index < rangeCount) {
+                return {rangeStart.seed + static_cast<unsigned int>(index), rangeStart.width, rangeStart.height};
+            }
+            return listed[static_cast<size_t>(index - rangeCount)];
+        }
+    };
+
+    // One job per seed of a ParseSeedRange range (replaces any earlier range)
+    [[nodiscard]] bool AddSeedRange(const std::string& text, const MapGenerator::Config& base,
+                                    JobList& jobs);
+
+    // Manifest lines: "seed" or "seed width height"; blank lines and lines
+    // starting with '#' are skipped. Prints the first bad line on failure.
+    [[nodiscard]] bool LoadManifest(const std::string& filename, const MapGenerator::Config& base,
+                                    JobList& jobs);
+
+    // Generate and save every job; returns false if any map failed to save
+    [[nodiscard]] bool Run(const JobList& jobs, const MapGenerator::Config& base,
+                           const Options& options);
+
+} // namespace Batch
@@ -0,0 +1,222 @@
+#include "Overview.h"
+#include "../Common/Parallel.h"
+#include "../Common/PngWriter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <span>
+
+namespace Overview {
+
+    namespace {
+        using Rgb = std::array<uint8_t, 3>;
+
+        Rgb Blend(TileColor color, Rgb under)
+        {
+            Rgb out;
+            const uint8_t source[3] = {color.r, color.g, color.b};
+            for (int i = 0; i < 3; ++i) {
+                out[i] = static_cast<uint8_t>((source[i] * color.a + under[i] * (255 - color.a) + 127) / 255);
+            }
+            return out;
+        }
+
+        // Pixel rows [firstRow, endRow) of an image; every write is clipped to them
+        class Band {
+        public:
+            Band(Image& image, int firstRow, int endRow) noexcept
+                : m_image(image), m_firstRow(firstRow), m_endRow(endRow) {}
+
+            void Span(int y, int x0, int x1, TileColor color)
+            {
+                if (y < m_firstRow || y >= m_endRow) return;
+                x0 = std::max(x0, 0);
+                x1 = std::min(x1, m_image.width);
+                uint8_t* pixel = m_image.rgb.data() + (static_cast<size_t>(y) * static_cast<size_t>(m_image.width) +
+                                                       static_cast<size_t>(std::max(x0, 0))) * 3;
+                for (int x = x0; x < x1; ++x, pixel += 3) {
+                    const Rgb blended = Blend(color, {pixel[0], pixel[1], pixel[2]});
+                    std::copy(blended.begin(), blended.end(), pixel);
+                }
+            }
+
+            void Column(int x, int y0, int y1, TileColor color)
+            {
+                for (int y = std::max(y0, m_firstRow); y < std::min(y1, m_endRow); ++y) {
+                    Span(y, x, x + 1, color);
+                }
+            }
+
+        private:
+            Image& m_image;
+            int m_firstRow;
+            int m_endRow;
+        };
+
+        unsigned BandCount(const Options& options, int height)
+        {
+            constexpr int kMinRowsPerBand = 32;
+            return std::min(Parallel::ResolveThreadCount(options.threadCount),
+                            static_cast<unsigned>(std::max(1, height / kMinRowsPerBand)));
+        }
+
+        void RenderTopDown(const Map& map, const Palette& palette, int size, unsigned bands, Image& image)
+        {
+            // Every tile type resolves to one color (two for outlined ground tiles)
+            const Rgb background{palette.background.r, palette.background.g, palette.background.b};
+            std::array<Rgb, 256> face;
+            std::array<Rgb, 256> edge;
+            for (size_t id = 0; id < face.size(); ++id) {
+                const TileColorSet& colors = palette.tiles.colors[id];
+                const TileRenderClass render = palette.tiles.properties[id].renderClass;
+                face[id] = render == TileRenderClass::Ground ? Blend(colors.fill, background)
+                         : render == TileRenderClass::Block  ? Blend(colors.top, background)
+                         : background;
+                edge[id] = render == TileRenderClass::Ground && size >= 4 ? Blend(colors.outline, background) : face[id];
+            }
+
+            Parallel::ForEachBand(bands, [&](unsigned band) {
+                const Parallel::Range rows = Parallel::BandRange(static_cast<size_t>(image.height), band, bands);
+                for (int py = static_cast<int>(rows.begin); py < static_cast<int>(rows.end); ++py) {
+                    const bool edgeRow = py % size == size - 1;
+                    uint8_t* out = image.rgb.data() + static_cast<size_t>(py) * static_cast<size_t>(image.width) * 3;
+                    map.ForEachRowInRect({0, py / size, map.GetWidth(), 1},
+                        [&](int x0, int, std::span<const TileType> row) {
+                            uint8_t* pixel = out + static_cast<size_t>(x0) * static_cast<size_t>(size) * 3;
+                            for (const TileType tile : row) {
+                                const size_t id = static_cast<uint8_t>(tile);
+                                for (int i = 0; i < size; ++i, pixel += 3) {
+                                    const Rgb& color = (edgeRow || i == size - 1) ? edge[id] : face[id];
+                                    std::copy(color.begin(), color.end(), pixel);
+                                }
+                            }
+                        });
+                }
+            });
+        }
+
+        // The game's isometric projection scaled to `tileWidth` (a multiple of
+        // 4): tile (x, y) has its top vertex at ((x - y) * tileWidth / 2, (x + y) *
+        // tileWidth / 4), shifted so the whole map fits; walls rise by 20/64 of
+        // the tile width. Diamond rows are sized so neighbours tile without gaps.
+        void RenderIsometric(const Map& map, const Palette& palette, int tileWidth, unsigned bands, Image& image)
+        {
+            const int tileHeight = tileWidth / 2;
+            const int halfWidth = tileWidth / 2;
+            const int halfHeight = tileHeight / 2;
+            const int depth = (tileWidth * 20 + 32) / 64;
+            const int originX = map.GetHeight() * halfWidth;
+            const bool outlines = tileWidth >= 16;
+            const int lastSum = map.GetWidth() + map.GetHeight() - 2;
+
+            const auto diamond = [&](Band& out, int sx, int top, TileColor color, const TileColor* outline) {
+                for (int i = 0; i < tileHeight; ++i) {
+                    const int half = halfWidth - std::abs(2 * i + 1 - tileHeight);
+                    if (outline == nullptr) {
+                        out.Span(top + i, sx - half, sx + half, color);
+                    } else {
+                        out.Span(top + i, sx - half + 1, sx + half - 1, color);
+                        out.Span(top + i, sx - half, sx - half + 1, *outline);
+                        out.Span(top + i, sx + half - 1, sx + half, *outline);
+                    }
+                }
+            };
+
+            Parallel::ForEachBand(bands, [&](unsigned band) {
+                const Parallel::Range rows = Parallel::BandRange(static_cast<size_t>(image.height), band, bands);
+                Band out(image, static_cast<int>(rows.begin), static_cast<int>(rows.end));
+                for (int y = static_cast<int>(rows.begin); y < static_cast<int>(rows.end); ++y) {
+                    out.Span(y, 0, image.width, palette.background);
+                }
+
+                // Diagonals x + y whose tiles reach into the band
+                const int firstSum = std::max(0, (static_cast<int>(rows.begin) - depth - tileHeight) / halfHeight);
+                const int endSum = std::min(lastSum, (static_cast<int>(rows.end) - 1) / halfHeight) + 1;
+                const auto forEachTile = [&](auto&& draw) {
+                    for (int sum = firstSum; sum < endSum; ++sum) {
+                        const int firstX = std::max(0, sum - map.GetHeight() + 1);
+                        const int endX = std::min(sum, map.GetWidth() - 1) + 1;
+                        for (int x = firstX; x < endX; ++x) {
+                            const int y = sum - x;
+                            const size_t id = static_cast<uint8_t>(map.GetTileUnchecked(x, y));
+                            draw(palette.tiles.properties[id].renderClass, palette.tiles.colors[id],
+                                 originX + (x - y) * halfWidth, depth + sum * halfHeight);
+                        }
+                    }
+                };
+
+                // Ground pass, then blocks back to front, as the game draws them
+                forEachTile([&](TileRenderClass render, const TileColorSet& style, int sx, int sy) {
+                    if (render == TileRenderClass::Ground) {
+                        diamond(out, sx, sy, style.fill, outlines ? &style.outline : nullptr);
+                    }
+                });
+                forEachTile([&](TileRenderClass render, const TileColorSet& style, int sx, int sy) {
+                    if (render != TileRenderClass::Block) return;
+                    for (int u = 0; u < halfWidth; ++u) {
+                        const int leftBottom = sy + halfHeight + (u + 2) / 2;
+                        const int rightBottom = sy + halfHeight + (halfWidth + 1 - u) / 2;
+                        out.Column(sx - halfWidth + u, leftBottom - depth - 1, leftBottom, style.left);
+                        out.Column(sx + u, rightBottom - depth - 1, rightBottom, style.right);
+                    }
+                    diamond(out, sx, sy - depth, style.top, nullptr);
+                });
+            });
+        }
+    }
+
+    Image Render(const Map& map, const Palette& palette, const Options& options)
+    {
+        Image image;
+        const bool isometric = options.view == View::Isometric;
+        int size = options.tileSize > 0 ? options.tileSize : (isometric ? 4 : 1);
+        if (isometric) {
+            size = std::max(4, (size + 3) / 4 * 4);
+        }
+
+        const int64_t mapWidth = map.GetWidth();
+        const int64_t mapHeight = map.GetHeight();
+        const int64_t width = isometric ? (mapWidth + mapHeight) * (size / 2) : mapWidth * size;
+        const int64_t height = isometric ? (mapWidth + mapHeight) * (size / 4) + (size * 20 + 32) / 64
+                                         : mapHeight * size;
+        if (mapWidth <= 0 || mapHeight <= 0 || width * height > kMaxPixels) {
+            return image;
+        }
+
+        image.width = static_cast<int>(width);
+        image.height = static_cast<int>(height);
+        const unsigned bands = BandCount(options, image.height);
+        image.rgb.resize(static_cast<size_t>(width * height) * 3);
+        if (isometric) {
+            RenderIsometric(map, palette, size, bands, image);
+        } else {
+            RenderTopDown(map, palette, size, bands, image);
+        }
+        return image;
+    }
+
+    bool SaveImage(const Image& image, const std::filesystem::path& filename)
+    {
+        if (image.width <= 0 || image.height <= 0) {
+            return false;
+        }
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string extension = filename.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (extension == ".ppm") {
+            file << "P6\n" << image.width << ' ' << image.height << "\n255\n";
+            file.write(reinterpret_cast<const char*>(image.rgb.data()), static_cast<std::streamsize>(image.rgb.size()));
+        } else {
+            const std::vector<uint8_t> png = PngWriter::EncodeRgb(image.width, image.height, image.rgb);
+            file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+        }
+        return file.good();
+    }
+
+} // namespace Overview
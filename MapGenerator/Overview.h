@@ -0,0 +1,55 @@
+#pragma once
+
+#include "MapGenerator.h"
+#include "../Common/TileProperties.h"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Overview images: maps rasterized on the CPU for reviewing them without the game
+//
+// Tile colors come from the game's tiles.ini, read with the same
+// LoadTileSettings as the game's TileConfig (missing keys keep the built-in
+// defaults). Maps are drawn top-down, one square per tile, or in the game's
+// isometric projection with raised wall blocks. The image is split into
+// bands of pixel rows rendered on separate threads; each band draws every
+// tile overlapping it in the game's painter order, so the image does not
+// depend on the thread count.
+namespace Overview {
+
+    // Tile colors and render classes; load overrides with LoadTileSettings
+    struct Palette {
+        TileSettings tiles{};
+        TileColor background{30, 30, 40, 255};   // The game's scene background
+    };
+
+    enum class View {
+        TopDown,     // tileSize x tileSize pixels per tile
+        Isometric    // Diamonds tileSize pixels wide, walls raised as in the game
+    };
+
+    struct Options {
+        View view = View::TopDown;
+        int tileSize = 0;            // Pixels; 0 = 1 top-down, 4 isometric
+        unsigned threadCount = 1;    // Threads for rasterizing (0 = all cores)
+    };
+
+    // 8-bit RGB, row-major
+    struct Image {
+        int width{};
+        int height{};
+        std::vector<uint8_t> rgb{};
+    };
+
+    // Largest image Render produces (about 400 MB of RGB)
+    inline constexpr int64_t kMaxPixels = int64_t{1} << 27;
+
+    // Rasterize `map`; empty image if it would exceed kMaxPixels
+    [[nodiscard]] Image Render(const Map& map, const Palette& palette, const Options& options);
+
+    // Binary PPM for a .ppm extension, PNG otherwise
+    [[nodiscard]] bool SaveImage(const Image& image, const std::filesystem::path& filename);
+
+} // namespace Overview
@@ -0,0 +1,169 @@
+#include "SeedSweep.h"
+#include "../Common/Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <span>
+
+namespace {
+    // Best first; equal scores keep the lower seed first so results are reproducible
+    bool Better(const Sweep::Result& a, const Sweep::Result& b) noexcept
+    {
+        return a.score < b.score || (a.score == b.score && a.seed < b.seed);
+    }
+
+    // Seeds claimed per atomic increment
+    constexpr unsigned kSeedBlock = 64;
+}
+
+namespace Sweep {
+
+    Metrics Measure(const Map& map, Scratch& scratch)
+    {
+        const int width = map.GetWidth();
+        const int height = map.GetHeight();
+        const size_t count = static_cast<size_t>(width) * static_cast<size_t>(height);
+        if (count == 0) {
+            return {};
+        }
+
+        // Grid padded with an unwalkable ring, so neighbour reads need no
+        // bounds checks: distance 0 = unwalkable, 1 = walkable (for now)
+        const size_t stride = static_cast<size_t>(width) + 2;
+        std::vector<uint16_t>& distance = scratch.distance;
+        distance.assign(stride * (static_cast<size_t>(height) + 2), 0);
+        size_t walkable = 0;
+        size_t water = 0;
+        map.ForEachRowInRect({0, 0, width, height}, [&](int, int y, std::span<const TileType> row) {
+            uint16_t* out = distance.data() + (static_cast<size_t>(y) + 1) * stride + 1;
+            for (size_t x = 0; x < row.size(); ++x) {
+                const bool open = TileTable::IsWalkable(row[x]);
+                out[x] = open;
+                walkable += open;
+                water += row[x] == TileType::Water;
+            }
+        });
+
+        // Largest 4-connected region by union-find (union by size, path
+        // halving); the biggest size seen at a union is the answer
+        std::vector<uint32_t>& parent = scratch.parent;
+        std::vector<uint32_t>& size = scratch.size;
+        parent.resize(distance.size());
+        size.assign(distance.size(), 1);
+        const auto find = [&parent](uint32_t i) {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        };
+        uint32_t largest = walkable > 0 ? 1 : 0;
+        const auto unite = [&](uint32_t a, uint32_t b) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (size[a] < size[b]) std::swap(a, b);
+            parent[b] = a;
+            size[a] += size[b];
+            largest = std::max(largest, size[a]);
+        };
+
+        // Chessboard distance to the nearest unwalkable tile: the forward
+        // chamfer pass shares the scan with the unions, then a backward pass
+        for (size_t y = 1; y <= static_cast<size_t>(height); ++y) {
+            for (size_t i = y * stride + 1, end = i + static_cast<size_t>(width); i < end; ++i) {
+                if (distance[i] == 0) continue;
+                parent[i] = static_cast<uint32_t>(i);
+                if (distance[i - 1] != 0) unite(static_cast<uint32_t>(i), static_cast<uint32_t>(i - 1));
+                if (distance[i - stride] != 0) unite(static_cast<uint32_t>(i), static_cast<uint32_t>(i - stride));
+                distance[i] = static_cast<uint16_t>(1 + std::min({distance[i - 1], distance[i - stride - 1],
+                                                                  distance[i - stride], distance[i - stride + 1]}));
+            }
+        }
+        uint64_t widthSum = 0;
+        for (size_t y = static_cast<size_t>(height); y >= 1; --y) {
+            for (size_t i = y * stride + static_cast<size_t>(width), begin = y * stride; i > begin; --i) {
+                uint16_t& d = distance[i];
+                if (d == 0) continue;
+                d = std::min(d, static_cast<uint16_t>(1 + std::min({distance[i + 1], distance[i + stride + 1],
+                                                                    distance[i + stride], distance[i + stride - 1]})));
+                widthSum += 2u * d - 1u;
+            }
+        }
+
+        Metrics metrics;
+        metrics.floorRatio = static_cast<double>(walkable) / static_cast<double>(count);
+        metrics.waterCoverage = static_cast<double>(water) / static_cast<double>(count);
+        if (walkable > 0) {
+            metrics.largestRegionShare = static_cast<double>(largest) / static_cast<double>(walkable);
+            metrics.meanCorridorWidth = static_cast<double>(widthSum) / static_cast<double>(walkable);
+        }
+        return metrics;
+    }
+
+    double Score(const Metrics& metrics, const Targets& targets) noexcept
+    {
+        double score = 0.0;
+        if (targets.floorRatio) score += std::abs(metrics.floorRatio - *targets.floorRatio);
+        if (targets.largestRegionShare) score += std::abs(metrics.largestRegionShare - *targets.largestRegionShare);
+        if (targets.waterCoverage) score += std::abs(metrics.waterCoverage - *targets.waterCoverage);
+        if (targets.meanCorridorWidth && *targets.meanCorridorWidth > 0.0) {
+            score += std::abs(metrics.meanCorridorWidth - *targets.meanCorridorWidth) / *targets.meanCorridorWidth;
+        }
+        return score;
+    }
+
+    std::vector<Result> Run(const MapGenerator::Config& base, unsigned int first, unsigned int last,
+                            const Targets& targets, size_t top, unsigned workerCount)
+    {
+        if (top == 0 || last < first) {
+            return {};
+        }
+
+        const uint64_t seedCount = static_cast<uint64_t>(last) - first + 1;
+        const unsigned workers = static_cast<unsigned>(std::min<uint64_t>(
+            Parallel::ResolveThreadCount(workerCount), (seedCount + kSeedBlock - 1) / kSeedBlock));
+
+        std::atomic<uint64_t> next{0};
+        std::mutex mergeMutex;
+        std::vector<Result> best;
+
+        Parallel::ForEachBand(workers, [&](unsigned) {
+            Scratch scratch;
+            std::vector<Result> local;   // Heap with the worst kept result on top
+            local.reserve(top + 1);
+            MapGenerator::Config config = base;
+            config.threadCount = 1;
+
+            for (uint64_t block = next.fetch_add(kSeedBlock); block < seedCount; block = next.fetch_add(kSeedBlock)) {
+                const uint64_t end = std::min<uint64_t>(block + kSeedBlock, seedCount);
+                for (uint64_t i = block; i < end; ++i) {
+                    config.seed = static_cast<unsigned int>(first + i);
+                    const Map map = MapGenerator::Generate(config);
+                    Result result{config.seed, 0.0, Measure(map, scratch)};
+                    result.score = Score(result.metrics, targets);
+
+                    if (local.size() < top) {
+                        local.push_back(result);
+                        std::push_heap(local.begin(), local.end(), Better);
+                    } else if (Better(result, local.front())) {
+                        std::pop_heap(local.begin(), local.end(), Better);
+                        local.back() = result;
+                        std::push_heap(local.begin(), local.end(), Better);
+                    }
+                }
+            }
+
+            std::lock_guard lock(mergeMutex);
+            best.insert(best.end(), local.begin(), local.end());
+        });
+
+        std::sort(best.begin(), best.end(), Better);
+        if (best.size() > top) {
+            best.resize(top);
+        }
+        return best;
+    }
+
+} // namespace Sweep
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "MapGenerator.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Seed sweep: score a range of seeds against target metrics for level curation
+//
+// Every seed is generated in memory with the base Config, measured and
+// scored; nothing is written to disk. Worker threads claim seeds in blocks
+// and keep their own top-N, merged at the end, so threads never contend on
+// the results.
+namespace Sweep {
+
+    struct Metrics {
+        double floorRatio{};           // Walkable tiles / all tiles
+        double largestRegionShare{};   // Largest connected region / walkable tiles
+        double waterCoverage{};        // Water tiles / all tiles
+        double meanCorridorWidth{};    // Mean over walkable tiles of 2d - 1, d = chessboard
+                                       // distance to the nearest unwalkable tile
+    };
+
+    // Unset targets do not count towards the score
+    struct Targets {
+        std::optional<double> floorRatio;
+        std::optional<double> largestRegionShare;
+        std::optional<double> waterCoverage;
+        std::optional<double> meanCorridorWidth;
+    };
+
+    struct Result {
+        unsigned int seed{};
+        double score{};                // Lower is better; 0 hits every target
+        Metrics metrics{};
+    };
+
+    // Buffers reused across Measure calls on one thread
+    struct Scratch {
+        std::vector<uint16_t> distance;   // Padded by one tile on every side
+        std::vector<uint32_t> parent;     // Union-find over walkable tiles
+        std::vector<uint32_t> size;
+    };
+
+    // Metrics of one generated map
+    [[nodiscard]] Metrics Measure(const Map& map, Scratch& scratch);
+
+    // Sum of deviations from the targets: absolute for the ratios, relative
+    // to the target for the corridor width
+    [[nodiscard]] double Score(const Metrics& metrics, const Targets& targets) noexcept;
+
+    // Generate and score seeds first..last on `workerCount` threads (0 = all
+    // cores); returns the best `top` results, best first (ties by seed)
+    [[nodiscard]] std::vector<Result> Run(const MapGenerator::Config& base, unsigned int first, unsigned int last,
+                                          const Targets& targets, size_t top, unsigned workerCount);
+
+} // namespace Sweep
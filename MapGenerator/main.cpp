@@ -2,32 +2,345 @@
 // Generates random dungeon maps and saves them to files
 
 #include "MapGenerator.h"
+#include "BatchMode.h"
+#include "Overview.h"
+#include "SeedSweep.h"
+#include "../Common/MapStreamWriter.h"
 #include <iostream>
 #include <string>
 #include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
 
 void PrintUsage(const char* programName)
 {
     std::cout << "Usage: " << programName << " [options]\n"
               << "\nOptions:\n"
-              << "  -o, --output <file>    Output filename (default: map.txt)\n"
+              << "  -o, --output <file>    Output filename (default: map.txt, map.dmap with -b/-c)\n"
               << "  -w, --width <n>        Map width (default: 200)\n"
               << "  -h, --height <n>       Map height (default: 200)\n"
               << "  -s, --seed <n>         Random seed (default: random)\n"
               << "  -d, --density <f>      Wall density 0.0-1.0 (default: 0.45)\n"
               << "  -i, --iterations <n>   Smooth iterations (default: 5)\n"
               << "  --water <f>            Water pool chance 0.0-1.0 (default: 0.02)\n"
+              << "  -a, --algorithm <name> Random scheme: hash (default), mt19937 (reproduces\n"
+              << "                         maps generated before the hash scheme existed) or\n"
+              << "                         mt19937-skip (mt19937 with faster water placement)\n"
+              << "  --connect <mode>       Join isolated regions: keep (default), fill (wall in\n"
+              << "                         all but the largest) or tunnel (carve paths to it)\n"
+              << "  --min-region <n>       With tunnel, fill regions smaller than n tiles (default: 24)\n"
+              << "  -b, --binary           Write binary .dmap (memory-mappable) instead of text\n"
+              << "  -c, --compressed       Write run-length compressed .dmap (smallest file)\n"
+              << "  --stream               Generate and write the map in bands of rows, so memory\n"
+              << "                         stays bounded for any height (up to 100000x1000000;\n"
+              << "                         hash algorithm without --connect only)\n"
+              << "  --band-rows <n>        Rows per band with --stream (default: 256)\n"
+              << "  --import <file>        Load an existing map instead of generating one and\n"
+              << "                         report load timing (saved only if -o is given)\n"
+              << "  -j, --threads <n>      Threads for generation and text loading (default: 1,\n"
+              << "                         0 = all cores); the generated map is the same for any n\n"
+              << "  --batch <first-last>   Generate one map per seed in the range (batch mode)\n"
+              << "  --manifest <file>      Batch mode with jobs from a file: one \"seed\" or\n"
+              << "                         \"seed width height\" per line\n"
+              << "  --out-dir <dir>        Batch output directory for maps and stats.csv\n"
+              << "                         (default: batch); -j sets the worker threads\n"
+              << "  --sweep <first-last>   Score every seed in the range against the targets below\n"
+              << "                         (in memory, -j workers) and list the best ones\n"
+              << "  --top <n>              Seeds listed by --sweep (default: 10)\n"
+              << "  --target-floor <f>     Walkable share of the map, 0.0-1.0\n"
+              << "  --target-region <f>    Largest connected region's share of the walkable tiles\n"
+              << "  --target-water <f>     Water share of the map, 0.0-1.0\n"
+              << "  --target-width <f>     Mean corridor width in tiles\n"
+              << "  --image <file>         Also render an overview image of the map (.ppm for PPM,\n"
+              << "                         PNG otherwise); works with --import\n"
+              << "  --thumbnails <png|ppm> Batch mode: write an overview image next to every map\n"
+              << "  --view <top|iso>       Overview projection: top-down (default) or isometric\n"
+              << "  --tile-px <n>          Overview pixels per tile (default: 1 top-down, 4 wide\n"
+              << "                         isometric)\n"
+              << "  --tiles <file>         Tile colors (default: config/tiles.ini, built-in colors\n"
+              << "                         if it is missing)\n"
+              << "  --layout-benchmark     Compare row-major and 8x8 tiled layouts on a generated map\n"
+              << "  --water-benchmark      Compare mt19937-skip water pool placement with the\n"
+              << "                         per-tile draws of mt19937 maps\n"
               << "  --help                 Show this help\n"
               << "\nExamples:\n"
               << "  " << programName << " -o dungeon.txt -w 100 -h 100\n"
-              << "  " << programName << " -s 12345 -d 0.4\n";
+              << "  " << programName << " -s 12345 -d 0.4\n"
+              << "  " << programName << " -b -o dungeon.dmap -w 4000 -h 4000 -j 0\n"
+              << "  " << programName << " --stream -w 4000 -h 100000 -s 7 -c -o tall.dmap\n"
+              << "  " << programName << " --import huge.txt -j 16 -b -o huge.dmap\n"
+              << "  " << programName << " --batch 1-5000 -c --out-dir pool -j 0\n"
+              << "  " << programName << " --sweep 1-1000000 --target-floor 0.5 --target-width 6 -j 0\n"
+              << "  " << programName << " --batch 1-400 -w 400 -h 400 -b --thumbnails png -j 0\n"
+              << "  " << programName << " --import level.dmap --image level.png --view iso -j 0\n"
+              << "  " << programName << " --layout-benchmark -w 4000 -h 4000\n"
+              << "  " << programName << " --water-benchmark -w 4000 -h 4000 -s 1\n";
 }
 
+// Load a map file, printing a timing breakdown
+bool ImportMap(const std::string& filename, unsigned threadCount, Map& map)
+{
+    MapLoadTimings timings;
+    MapLoadError error;
+    std::cout << "Loading " << filename << "...\n";
+    if (!map.LoadFromFile(filename, MapLoadOptions{threadCount, &timings}, &error)) {
+        std::cerr << "Error: Failed to load " << filename << ": " << ToString(error.code);
+        if (error.line > 0) {
+            std::cerr << " (line " << error.line << ", column " << error.column << ")";
+        }
+        std::cerr << "\n";
+        return false;
+    }
+
+    std::cout << "Loaded map " << map.GetWidth() << "x" << map.GetHeight()
+              << " in " << timings.totalMs << " ms\n"
+              << "  Open:   " << timings.openMs << " ms\n"
+              << "  Header: " << timings.headerMs << " ms\n"
+              << "  Tiles:  " << timings.tilesMs << " ms (" << timings.threads << " thread"
+              << (timings.threads == 1 ? "" : "s") << ")\n";
+    return true;
+}
+
+// Tile access patterns of the hot loops, each calling get(x, y) and returning
+// a checksum so the work cannot be optimized away
+namespace LayoutBenchmark {
+
+    // 3x3 wall count around every interior tile (cellular automaton kernel)
+    template<typename Get>
+    uint64_t Kernel3x3(const Map& map, Get&& get)
+    {
+        uint64_t sum = 0;
+        for (int y = 1; y + 1 < map.GetHeight(); ++y) {
+            for (int x = 1; x + 1 < map.GetWidth(); ++x) {
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        sum += get(x + dx, y + dy) == TileType::Wall;
+                    }
+                }
+            }
+        }
+        return sum;
+    }
+
+    // 8-neighbour flood fill over floor tiles (pathfinder-style expansion)
+    template<typename Get>
+    uint64_t Flood(const Map& map, Get&& get)
+    {
+        const int width = map.GetWidth();
+        const int height = map.GetHeight();
+        std::vector<uint8_t> visited(static_cast<size_t>(width) * static_cast<size_t>(height));
+        std::vector<int> stack;
+        uint64_t reached = 0;
+        for (int start = 0; start < width * height; ++start) {
+            if (visited[static_cast<size_t>(start)] || get(start % width, start / width) != TileType::Floor) {
+                continue;
+            }
+            visited[static_cast<size_t>(start)] = 1;
+            stack.push_back(start);
+            while (!stack.empty()) {
+                const int x = stack.back() % width;
+                const int y = stack.back() / width;
+                stack.pop_back();
+                ++reached;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        const int nx = x + dx;
+                        const int ny = y + dy;
+                        if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+                            continue;
+                        }
+                        const size_t n = static_cast<size_t>(ny) * static_cast<size_t>(width) + static_cast<size_t>(nx);
+                        if (!visited[n] && get(nx, ny) == TileType::Floor) {
+                            visited[n] = 1;
+                            stack.push_back(static_cast<int>(n));
+                        }
+                    }
+                }
+            }
+        }
+        return reached;
+    }
+
+    // Back-to-front diagonals (x + y constant), the isometric draw order
+    template<typename Get>
+    uint64_t Diagonals(const Map& map, Get&& get)
+    {
+        uint64_t sum = 0;
+        const int width = map.GetWidth();
+        const int height = map.GetHeight();
+        for (int d = 0; d < width + height - 1; ++d) {
+            for (int x = std::max(0, d - height + 1); x <= std::min(d, width - 1); ++x) {
+                sum += static_cast<uint64_t>(get(x, d - x));
+            }
+        }
+        return sum;
+    }
+
+    // Direct-mapped 32 KiB cache of 64-byte lines fed with tile offsets
+    class CacheModel {
+    public:
+        uint64_t Touch(size_t offset) {
+            const size_t line = offset >> 6;
+            size_t& slot = m_lines[line & (kLines - 1)];
+            if (slot != line + 1) {
+                slot = line + 1;
+                ++m_misses;
+            }
+            return m_misses;
+        }
+        [[nodiscard]] uint64_t GetMisses() const noexcept { return m_misses; }
+
+    private:
+        static constexpr size_t kLines = 512;
+        std::vector<size_t> m_lines = std::vector<size_t>(kLines);
+        uint64_t m_misses{};
+    };
+
+    template<typename Workload>
+    void Measure(const char* name, const Map& rowMajor, const Map& tiled, Workload&& workload)
+    {
+        std::cout << "  " << name << "\n";
+        for (const Map* map : {&rowMajor, &tiled}) {
+            const auto start = std::chrono::steady_clock::now();
+            const uint64_t checksum = workload(*map, [map](int x, int y) { return map->GetTileUnchecked(x, y); });
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            CacheModel cache;
+            (void)workload(*map, [map, &cache](int x, int y) {
+                cache.Touch(map->GetStorageIndex(x, y));
+                return map->GetTileUnchecked(x, y);
+            });
+
+            std::cout << "    " << (map->GetLayout() == MapLayout::Tiled8x8 ? "tiled 8x8: " : "row-major: ")
+                      << ms << " ms, " << cache.GetMisses() << " modelled misses (checksum "
+                      << checksum << ")\n";
+        }
+    }
+
+    void Run(const MapGenerator::Config& config)
+    {
+        std::cout << "Generating map " << config.width << "x" << config.height << "...\n";
+        const Map generated = MapGenerator::Generate(config);
+
+        std::vector<TileType> tiles;
+        tiles.reserve(static_cast<size_t>(generated.GetWidth()) * static_cast<size_t>(generated.GetHeight()));
+        for (int y = 0; y < generated.GetHeight(); ++y) {
+            for (int x = 0; x < generated.GetWidth(); ++x) {
+                tiles.push_back(generated.GetTileUnchecked(x, y));
+            }
+        }
+
+        Map rowMajor;
+        Map tiled;
+        rowMajor.Init("RowMajor", generated.GetWidth(), generated.GetHeight(), tiles);
+        tiled.Init("Tiled", generated.GetWidth(), generated.GetHeight(), std::move(tiles), MapLayout::Tiled8x8);
+
+        std::cout << "Layout benchmark (misses from a 32 KiB direct-mapped cache model):\n";
+        Measure("3x3 kernel", rowMajor, tiled, [](const Map& map, auto&& get) { return Kernel3x3(map, get); });
+        Measure("8-neighbour flood", rowMajor, tiled, [](const Map& map, auto&& get) { return Flood(map, get); });
+        Measure("Diagonal sweep", rowMajor, tiled, [](const Map& map, auto&& get) { return Diagonals(map, get); });
+    }
+
+} // namespace LayoutBenchmark
+
+// Water pool placement: MapGenerator::AddWaterPoolsSkipAhead (one geometric
+// gap per pool) against the per-tile AddWaterPools, on the same smoothed
+// maps. Both place a pool on each eligible floor tile with probability
+// `waterChance`, so their water statistics should agree.
+namespace WaterBenchmark {
+
+    struct Totals {
+        double ms{};
+        double water{};
+        double waterSquared{};
+    };
+
+    void Add(Totals& totals, const std::vector<TileType>& tiles, double ms)
+    {
+        const double water = static_cast<double>(std::count(tiles.begin(), tiles.end(), TileType::Water));
+        totals.ms += ms;
+        totals.water += water;
+        totals.waterSquared += water * water;
+    }
+
+    void Print(const char* name, const Totals& totals, int runs, double floorTiles)
+    {
+        const double mean = totals.water / runs;
+        const double deviation = std::sqrt(std::max(0.0, totals.waterSquared / runs - mean * mean));
+        std::cout << "  " << name << totals.ms / runs << " ms, " << mean << " water tiles (sd "
+                  << deviation << ", " << 100.0 * mean / floorTiles << "% of floor)\n";
+    }
+
+    void Run(MapGenerator::Config config)
+    {
+        constexpr int kRuns = 5;
+        const float chance = config.waterChance;
+        config.waterChance = 0.0f;
+        config.algorithm = MapGenerator::Algorithm::Sequential;
+        if (config.seed == 0) {
+            config.seed = 1;
+        }
+
+        std::cout << "Water benchmark on " << kRuns << " maps " << config.width << "x" << config.height
+                  << ", water chance " << chance << ":\n";
+        Totals skip, perTile;
+        double floorTiles = 0.0;
+        for (int run = 0; run < kRuns; ++run) {
+            const Map smoothed = MapGenerator::Generate(config);
+            std::vector<TileType> base;
+            base.reserve(static_cast<size_t>(config.width) * static_cast<size_t>(config.height));
+            smoothed.ForEachRowInRect({0, 0, config.width, config.height},
+                [&](int, int, std::span<const TileType> row) { base.insert(base.end(), row.begin(), row.end()); });
+            floorTiles += static_cast<double>(std::count(base.begin(), base.end(), TileType::Floor)) / kRuns;
+
+            std::vector<TileType> tiles = base;
+            std::mt19937 rng(config.seed);
+            auto start = std::chrono::steady_clock::now();
+            MapGenerator::AddWaterPoolsSkipAhead(tiles, config.width, config.height, chance, rng);
+            Add(skip, tiles, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+            tiles = base;
+            rng.seed(config.seed);
+            start = std::chrono::steady_clock::now();
+            MapGenerator::AddWaterPools(tiles, config.width, config.height, chance, rng);
+            Add(perTile, tiles, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+            ++config.seed;
+        }
+
+        Print("skip-ahead: ", skip, kRuns, floorTiles);
+        Print("per-tile:   ", perTile, kRuns, floorTiles);
+    }
+
+} // namespace WaterBenchmark
+
 int main(int argc, char* argv[])
 {
     // Default configuration
     MapGenerator::Config config;
-    std::string outputFile = "map.txt";
+    std::string outputFile;
+    MapFileFormat format = MapFileFormat::Text;
+    std::string importFile;
+    unsigned threadCount = 1;
+    bool layoutBenchmark = false;
+    bool waterBenchmark = false;
+    bool stream = false;
+    int bandRows = 256;
+    std::string imageFile;
+    std::string thumbnails;
+    std::string tilesFile;
+    Overview::Options overview;
+    std::string batchSeeds;
+    std::string manifestFile;
+    Batch::Options batchOptions;
+    std::string sweepSeeds;
+    size_t sweepTop = 10;
+    Sweep::Targets sweepTargets;
     
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -58,6 +371,113 @@ int main(int argc, char* argv[])
         else if (arg == "--water" && i + 1 < argc) {
             config.waterChance = static_cast<float>(std::atof(argv[++i]));
         }
+        else if ((arg == "-a" || arg == "--algorithm") && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name == "hash") {
+                config.algorithm = MapGenerator::Algorithm::CounterHash;
+            } else if (name == "mt19937") {
+                config.algorithm = MapGenerator::Algorithm::Sequential;
+            } else if (name == "mt19937-skip") {
+                config.algorithm = MapGenerator::Algorithm::SequentialSkip;
+            } else {
+                std::cerr << "Unknown algorithm: " << name << " (expected hash, mt19937 or mt19937-skip)\n";
+                return 1;
+            }
+        }
+        else if (arg == "--connect" && i + 1 < argc) {
+            const std::string mode = argv[++i];
+            if (mode == "keep") {
+                config.connectivity = MapGenerator::Connectivity::Keep;
+            } else if (mode == "fill") {
+                config.connectivity = MapGenerator::Connectivity::FillPockets;
+            } else if (mode == "tunnel") {
+                config.connectivity = MapGenerator::Connectivity::CarveTunnels;
+            } else {
+                std::cerr << "Unknown connectivity mode: " << mode << " (expected keep, fill or tunnel)\n";
+                return 1;
+            }
+        }
+        else if (arg == "--min-region" && i + 1 < argc) {
+            config.minRegionSize = std::atoi(argv[++i]);
+        }
+        else if (arg == "-b" || arg == "--binary") {
+            format = MapFileFormat::Binary;
+        }
+        else if (arg == "-c" || arg == "--compressed") {
+            format = MapFileFormat::Compressed;
+        }
+        else if (arg == "--stream") {
+            stream = true;
+        }
+        else if (arg == "--band-rows" && i + 1 < argc) {
+            bandRows = std::atoi(argv[++i]);
+        }
+        else if (arg == "--import" && i + 1 < argc) {
+            importFile = argv[++i];
+        }
+        else if ((arg == "-j" || arg == "--threads") && i + 1 < argc) {
+            threadCount = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+        }
+        else if (arg == "--batch" && i + 1 < argc) {
+            batchSeeds = argv[++i];
+        }
+        else if (arg == "--manifest" && i + 1 < argc) {
+            manifestFile = argv[++i];
+        }
+        else if (arg == "--out-dir" && i + 1 < argc) {
+            batchOptions.outputDirectory = argv[++i];
+        }
+        else if (arg == "--sweep" && i + 1 < argc) {
+            sweepSeeds = argv[++i];
+        }
+        else if (arg == "--top" && i + 1 < argc) {
+            sweepTop = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        }
+        else if (arg == "--target-floor" && i + 1 < argc) {
+            sweepTargets.floorRatio = std::atof(argv[++i]);
+        }
+        else if (arg == "--target-region" && i + 1 < argc) {
+            sweepTargets.largestRegionShare = std::atof(argv[++i]);
+        }
+        else if (arg == "--target-water" && i + 1 < argc) {
+            sweepTargets.waterCoverage = std::atof(argv[++i]);
+        }
+        else if (arg == "--target-width" && i + 1 < argc) {
+            sweepTargets.meanCorridorWidth = std::atof(argv[++i]);
+        }
+        else if (arg == "--image" && i + 1 < argc) {
+            imageFile = argv[++i];
+        }
+        else if (arg == "--thumbnails" && i + 1 < argc) {
+            thumbnails = argv[++i];
+            if (thumbnails != "png" && thumbnails != "ppm") {
+                std::cerr << "Unknown thumbnail format: " << thumbnails << " (expected png or ppm)\n";
+                return 1;
+            }
+        }
+        else if (arg == "--view" && i + 1 < argc) {
+            const std::string view = argv[++i];
+            if (view == "top") {
+                overview.view = Overview::View::TopDown;
+            } else if (view == "iso") {
+                overview.view = Overview::View::Isometric;
+            } else {
+                std::cerr << "Unknown view: " << view << " (expected top or iso)\n";
+                return 1;
+            }
+        }
+        else if (arg == "--tile-px" && i + 1 < argc) {
+            overview.tileSize = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (arg == "--tiles" && i + 1 < argc) {
+            tilesFile = argv[++i];
+        }
+        else if (arg == "--layout-benchmark") {
+            layoutBenchmark = true;
+        }
+        else if (arg == "--water-benchmark") {
+            waterBenchmark = true;
+        }
         else {
             std::cerr << "Unknown option: " << arg << "\n";
             PrintUsage(argv[0]);
@@ -65,41 +485,183 @@ int main(int argc, char* argv[])
         }
     }
     
-    // Validate config
-    if (config.width < 10 || config.height < 10) {
-        std::cerr << "Error: Map dimensions must be at least 10x10\n";
+    // Overview colors: the game's tiles.ini, or the built-in colors without one
+    Overview::Palette palette;
+    if ((!imageFile.empty() || !thumbnails.empty()) &&
+        !LoadTileSettings(tilesFile.empty() ? "config/tiles.ini" : tilesFile, palette.tiles) && !tilesFile.empty()) {
+        std::cerr << "Error: Cannot read tile colors from " << tilesFile << "\n";
         return 1;
     }
+    overview.threadCount = threadCount;
     
-    if (config.width > 10000 || config.height > 10000) {
-        std::cerr << "Error: Map dimensions must be at most 10000x10000\n";
-        return 1;
+    // Seed sweep: score seeds in memory, print the best
+    if (!sweepSeeds.empty()) {
+        unsigned int first = 0;
+        unsigned int last = 0;
+        if (!ParseSeedRange(sweepSeeds, first, last)) {
+            std::cerr << "Error: Invalid seed range " << sweepSeeds << " (expected first-last, seeds > 0)\n";
+            return 1;
+        }
+        if (config.width < 10 || config.height < 10 || config.width > 10000 || config.height > 10000) {
+            std::cerr << "Error: Map dimensions must be between 10x10 and 10000x10000\n";
+            return 1;
+        }
+        
+        std::cout << "Sweeping seeds " << first << "-" << last << " (" << config.width << "x" << config.height << ")...\n";
+        const auto start = std::chrono::steady_clock::now();
+        const auto results = Sweep::Run(config, first, last, sweepTargets, sweepTop, threadCount);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double seeds = static_cast<double>(last - first) + 1.0;
+        std::cout << "Scored " << static_cast<uint64_t>(seeds) << " seeds in " << seconds << " s ("
+                  << seeds / std::max(seconds, 1e-9) << " seeds/s)\n"
+                  << "rank,seed,score,floor,largest_region,water,corridor_width\n";
+        for (size_t rank = 0; rank < results.size(); ++rank) {
+            const Sweep::Result& result = results[rank];
+            std::cout << rank + 1 << ',' << result.seed << ',' << result.score << ','
+                      << result.metrics.floorRatio << ',' << result.metrics.largestRegionShare << ','
+                      << result.metrics.waterCoverage << ',' << result.metrics.meanCorridorWidth << '\n';
+        }
+        return 0;
     }
     
-    // Generate map
-    std::cout << "Generating map " << config.width << "x" << config.height << "...\n";
+    // Batch mode: many maps, -j workers each generating whole maps
+    if (!batchSeeds.empty() || !manifestFile.empty()) {
+        Batch::JobList jobs;
+        if (!batchSeeds.empty() && !Batch::AddSeedRange(batchSeeds, config, jobs)) {
+            std::cerr << "Error: Invalid seed range " << batchSeeds << " (expected first-last, seeds > 0)\n";
+            return 1;
+        }
+        if (!manifestFile.empty() && !Batch::LoadManifest(manifestFile, config, jobs)) {
+            return 1;
+        }
+        if (config.width < 10 || config.height < 10 || config.width > 10000 || config.height > 10000) {
+            std::cerr << "Error: Map dimensions must be between 10x10 and 10000x10000\n";
+            return 1;
+        }
+        batchOptions.format = format;
+        batchOptions.workerCount = threadCount;
+        if (!thumbnails.empty()) {
+            batchOptions.thumbnailExtension = "." + thumbnails;
+            batchOptions.overview = overview;
+            batchOptions.palette = palette;
+        }
+        return Batch::Run(jobs, config, batchOptions) ? 0 : 1;
+    }
+    
+    const bool hasOutput = !outputFile.empty();
+    if (!hasOutput) {
+        outputFile = (format == MapFileFormat::Text) ? "map.txt" : "map.dmap";
+    }
+    
+    // Streaming: generate band by band straight into the output file
+    if (stream) {
+        if (!importFile.empty() || !imageFile.empty()) {
+            std::cerr << "Error: --stream cannot be combined with --import or --image\n";
+            return 1;
+        }
+        if (config.algorithm != MapGenerator::Algorithm::CounterHash ||
+            config.connectivity != MapGenerator::Connectivity::Keep) {
+            std::cerr << "Error: --stream needs the hash algorithm and --connect keep\n";
+            return 1;
+        }
+        if (config.width < 10 || config.height < 10 || config.width > 100000 || config.height > 1000000) {
+            std::cerr << "Error: Streamed map dimensions must be between 10x10 and 100000x1000000\n";
+            return 1;
+        }
+        if (bandRows < 1) {
+            std::cerr << "Error: --band-rows must be at least 1\n";
+            return 1;
+        }
+        
+        std::cout << "Streaming map " << config.width << "x" << config.height << " in bands of "
+                  << bandRows << " rows...\n";
+        MapStreamWriter writer;
+        if (!writer.Open(outputFile, "Generated Dungeon", config.width, config.height, format)) {
+            std::cerr << "Error: Failed to create " << outputFile << "\n";
+            return 1;
+        }
+        TileCounts counts;
+        const bool generated = MapGenerator::GenerateBands(config, bandRows,
+            [&](int, std::span<const TileType> rows) {
+                counts.Add(rows);
+                return writer.WriteRows(rows);
+            });
+        if (!generated || !writer.Finish()) {
+            std::cerr << "Error: Failed to save map to " << outputFile << "\n";
+            return 1;
+        }
+        std::cout << "  Floor tiles: " << counts.floor << "\n"
+                  << "  Wall tiles:  " << counts.wall << "\n"
+                  << "  Water tiles: " << counts.water << "\n"
+                  << "Map saved to: " << outputFile << "\n";
+        return 0;
+    }
     
-    Map map = MapGenerator::Generate(config);
+    Map map;
+    if (!importFile.empty()) {
+        if (!ImportMap(importFile, threadCount, map)) {
+            return 1;
+        }
+    } else {
+        // Validate config
+        if (config.width < 10 || config.height < 10) {
+            std::cerr << "Error: Map dimensions must be at least 10x10\n";
+            return 1;
+        }
+        
+        if (config.width > 10000 || config.height > 10000) {
+            std::cerr << "Error: Map dimensions must be at most 10000x10000\n";
+            return 1;
+        }
+        
+        if (layoutBenchmark) {
+            LayoutBenchmark::Run(config);
+            return 0;
+        }
+        
+        if (waterBenchmark) {
+            WaterBenchmark::Run(config);
+            return 0;
+        }
+        
+        // Generate map
+        std::cout << "Generating map " << config.width << "x" << config.height << "...\n";
+        
+        config.threadCount = threadCount;
+        map = MapGenerator::Generate(config);
+    }
     
     // Count tile statistics
-    int floorCount = 0, wallCount = 0, waterCount = 0;
-    for (int y = 0; y < map.GetHeight(); ++y) {
-        for (int x = 0; x < map.GetWidth(); ++x) {
-            switch (map.GetTile(x, y)) {
-                case TileType::Floor: ++floorCount; break;
-                case TileType::Wall: ++wallCount; break;
-                case TileType::Water: ++waterCount; break;
-                default: break;
-            }
+    const TileCounts counts = CountTiles(map);
+    std::cout << "  Floor tiles: " << counts.floor << "\n"
+              << "  Wall tiles:  " << counts.wall << "\n"
+              << "  Water tiles: " << counts.water << "\n";
+    
+    // Overview image
+    if (!imageFile.empty()) {
+        const auto start = std::chrono::steady_clock::now();
+        const Overview::Image image = Overview::Render(map, palette, overview);
+        const double renderMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (image.rgb.empty()) {
+            std::cerr << "Error: Overview image would exceed " << Overview::kMaxPixels
+                      << " pixels; use a smaller --tile-px\n";
+            return 1;
         }
+        if (!Overview::SaveImage(image, imageFile)) {
+            std::cerr << "Error: Failed to save image to " << imageFile << "\n";
+            return 1;
+        }
+        std::cout << "Overview " << image.width << "x" << image.height << " rendered in " << renderMs
+                  << " ms, saved to: " << imageFile << "\n";
     }
     
-    std::cout << "  Floor tiles: " << floorCount << "\n"
-              << "  Wall tiles:  " << wallCount << "\n"
-              << "  Water tiles: " << waterCount << "\n";
+    // An import without -o only reports timing (and writes the overview)
+    if (!importFile.empty() && !hasOutput) {
+        return 0;
+    }
     
     // Save to file
-    if (map.SaveToFile(outputFile)) {
+    if (map.SaveToFile(outputFile, format)) {
         std::cout << "Map saved to: " << outputFile << "\n";
         return 0;
     } else {